@@ -23,6 +23,17 @@ SDL_Event EventDownReleased;
 EventDownReleased.type = SDL_KEYUP;                                                                       \
 EventDownReleased.key.keysym.sym = (SDLKey) keyDown;                                                      \
                                                                                                           \
+SDL_Keycode keyRight = InputCodeManager::inputCodeToSDLKey(                                               \
+            clientSettings->getInputCodeManager()->getBinding(BINDING_RIGHT, InputModeKeyboard));         \
+                                                                                                          \
+SDL_Event EventRightPressed;                                                                              \
+EventRightPressed.type = SDL_KEYDOWN;                                                                     \
+EventRightPressed.key.keysym.sym = (SDLKey) keyRight;                                                     \
+                                                                                                          \
+SDL_Event EventRightReleased;                                                                             \
+EventRightReleased.type = SDL_KEYUP;                                                                      \
+EventRightReleased.key.keysym.sym = (SDLKey) keyRight;                                                    \
+                                                                                                          \
 InputCode KEY_MOD1 = clientSettings->getInputCodeManager()->getBinding(BINDING_MOD1, InputModeKeyboard);  \
 InputCode LOADOUT_KEY_BOOST  = LoadoutHelper::getInputCodeForModuleOption(ModuleBoost,    true);          \
 InputCode LOADOUT_KEY_SHIELD = LoadoutHelper::getInputCodeForModuleOption(ModuleShield,   true);          \
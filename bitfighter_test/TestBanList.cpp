@@ -0,0 +1,124 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "BanList.h"
+#include "gtest/gtest.h"
+
+namespace Zap {
+
+// A start time well in the past, with a duration long enough that it won't run out on us
+static const string LongBan = "20110131T123000|52560000";    // 100 years
+static const string ShortBan = "20110131T123000|30";         // Long since expired
+
+
+static Vector<string> makeBanList(const string &entry)
+{
+   Vector<string> list;
+   list.push_back(entry);
+   return list;
+}
+
+
+TEST(BanListTest, exactAddress)
+{
+   BanList banList("");
+   banList.loadBanList(makeBanList("123.123.123.123|*|" + LongBan));
+
+   EXPECT_TRUE(banList.isBanned(Address("123.123.123.123:28000"), "anybody", true));
+   EXPECT_FALSE(banList.isBanned(Address("123.123.123.124:28000"), "anybody", true));
+}
+
+
+TEST(BanListTest, nickname)
+{
+   BanList banList("");
+   banList.loadBanList(makeBanList("*|watusimoto|" + LongBan));
+
+   EXPECT_TRUE(banList.isBanned(Address("10.0.0.1:28000"), "watusimoto", true));
+   EXPECT_FALSE(banList.isBanned(Address("10.0.0.1:28000"), "Watusimoto2", true));
+
+   // Address and nickname both specified: both have to match
+   banList.loadBanList(makeBanList("10.0.0.1|watusimoto|" + LongBan));
+   EXPECT_TRUE(banList.isBanned(Address("10.0.0.1:28000"), "watusimoto", true));
+   EXPECT_FALSE(banList.isBanned(Address("10.0.0.2:28000"), "watusimoto", true));
+   EXPECT_FALSE(banList.isBanned(Address("10.0.0.1:28000"), "someoneElse", true));
+}
+
+
+TEST(BanListTest, ranges)
+{
+   BanList banList("");
+   Vector<string> list;
+   list.push_back("123.45.*.*|*|" + LongBan);
+   list.push_back("10.20.0.0/14|*|" + LongBan);
+   banList.loadBanList(list);
+
+   EXPECT_EQ(2, banList.banListToString().size());
+
+   EXPECT_TRUE (banList.isBanned(Address("123.45.0.1:28000"),   "x", true));
+   EXPECT_TRUE (banList.isBanned(Address("123.45.255.255:28000"), "x", true));
+   EXPECT_FALSE(banList.isBanned(Address("123.46.0.1:28000"),   "x", true));
+
+   EXPECT_TRUE (banList.isBanned(Address("10.20.1.1:28000"),    "x", true));
+   EXPECT_TRUE (banList.isBanned(Address("10.23.255.1:28000"),  "x", true));
+   EXPECT_FALSE(banList.isBanned(Address("10.24.0.1:28000"),    "x", true));
+
+   // Malformed ranges are rejected
+   banList.loadBanList(makeBanList("10.*.3.4|*|" + LongBan));
+   EXPECT_EQ(0, banList.banListToString().size());
+   banList.loadBanList(makeBanList("10.0.0.0/33|*|" + LongBan));
+   EXPECT_EQ(0, banList.banListToString().size());
+}
+
+
+TEST(BanListTest, nonAuthenticated)
+{
+   BanList banList("");
+   banList.loadBanList(makeBanList("*|*NonAuthenticated|" + LongBan));
+
+   EXPECT_TRUE(banList.isBanned(Address("10.0.0.1:28000"), "guest", false));
+   EXPECT_FALSE(banList.isBanned(Address("10.0.0.1:28000"), "member", true));
+}
+
+
+TEST(BanListTest, expiry)
+{
+   BanList banList("");
+   Vector<string> list;
+   list.push_back("10.0.0.1|*|" + ShortBan);
+   list.push_back("10.0.0.2|*|" + LongBan);
+   banList.loadBanList(list);
+
+   EXPECT_FALSE(banList.isBanned(Address("10.0.0.1:28000"), "x", true));
+   EXPECT_TRUE (banList.isBanned(Address("10.0.0.2:28000"), "x", true));
+
+   // Pruning expired bans from the indices doesn't drop them from the saved list
+   banList.updateKickList(0);
+   EXPECT_EQ(2, banList.banListToString().size());
+   EXPECT_TRUE(banList.isBanned(Address("10.0.0.2:28000"), "x", true));
+
+   // Freshly added bans take effect immediately
+   banList.addToBanList(Address("10.0.0.3:28000"), 10);
+   EXPECT_TRUE(banList.isBanned(Address("10.0.0.3:28000"), "x", true));
+}
+
+
+TEST(BanListTest, kicks)
+{
+   BanList banList("");
+   Address kicked("10.0.0.1:28000");
+
+   banList.kickHost(kicked);
+   EXPECT_TRUE(banList.isAddressKicked(Address("10.0.0.1:12345")));   // Port doesn't matter
+   EXPECT_FALSE(banList.isAddressKicked(Address("10.0.0.2:28000")));
+
+   banList.updateKickList(banList.getKickDuration() - 1);
+   EXPECT_TRUE(banList.isAddressKicked(kicked));
+
+   banList.updateKickList(2);
+   EXPECT_FALSE(banList.isAddressKicked(kicked));
+}
+
+};
@@ -0,0 +1,162 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "controlObjectConnection.h"
+
+#include "ClientGame.h"
+#include "UIGame.h"
+#include "ServerGame.h"
+#include "GameManager.h"
+#include "gameConnection.h"
+#include "ship.h"
+
+#include "TestUtils.h"
+#include "EventKeyDefs.h"
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+
+namespace Zap
+{
+
+// A walled box, so the ship has something to bump into
+static const char *boxLevel =
+      "GameType 10 8\n"
+      "GridSize 255\n"
+      "Team Bluey 0 0 1\n"
+      "BarrierMaker 40 -2 -2 2 -2 2 2 -2 2 -2 -2\n"
+      "BarrierMaker 40 0.5 -0.5 0.5 0.5\n"
+      "Spawn 0 0 0\n";
+
+
+static void shove(Ship *ship)
+{
+   ship->setActualVel(ship->getActualVel() + Point(0, -300));
+}
+
+
+// Local connections deliver packets as soon as they're sent, so the server never gets behind the client.  To have
+// corrections arrive while our moves are still pending, we drop everything the client sends for a while.
+TEST(ControlObjectConnectionTest, replaySkipping)
+{
+   InputCodeManager::initializeKeyNames();
+
+   GamePair gamePair(boxLevel);
+   ServerGame *serverGame = gamePair.server;
+   ClientGame *clientGame = gamePair.getClient(0);
+   GameSettings *clientSettings = clientGame->getSettings();
+
+   DEFINE_KEYS_AND_EVENTS(clientSettings);
+
+   GamePair::idle(10, 10);    // Let the ship spawn
+
+   ASSERT_TRUE(clientGame->getLocalPlayerShip());
+   Ship *serverShip = serverGame->getClientInfo(0)->getShip();
+   ASSERT_TRUE(serverShip);
+
+   GameConnection *connection = clientGame->getConnectionToServer();
+
+   Event::onEvent(clientGame, &EventDownPressed);
+   GamePair::idle(10, 5);
+
+   connection->setSimulatedNetParams(1, 0, 0, 0);     // Lose all our sends, but still hear from the server
+   GamePair::idle(10);
+
+   U32 replays = connection->getReplayCount();
+   U32 skipped = connection->getSkippedReplayCount();
+
+   // The server disagrees with where we put the ship, so we have to replay our moves from where it says we are
+   shove(serverShip);
+   GamePair::idle(10);
+
+   EXPECT_EQ(replays + 1, connection->getReplayCount());
+   EXPECT_EQ(skipped, connection->getSkippedReplayCount());
+
+   // Until it hears from us, the server keeps sending the same correction, which we've already dealt with
+   GamePair::idle(10, 5);
+
+   EXPECT_EQ(replays + 1, connection->getReplayCount());
+   EXPECT_EQ(skipped + 5, connection->getSkippedReplayCount());
+
+   connection->setSimulatedNetParams(0, 0, 0, 0);
+   Event::onEvent(clientGame, &EventDownReleased);
+   GamePair::idle(10, 10);
+
+   Point clientPos = clientGame->getLocalPlayerShip()->getActualPos();
+   Point serverPos = serverShip->getActualPos();
+
+   EXPECT_FLOAT_EQ(serverPos.x, clientPos.x);
+   EXPECT_FLOAT_EQ(serverPos.y, clientPos.y);
+}
+
+
+// Flies a ship around with a quarter second ping, where the client has the most moves waiting for the server to
+// catch up with, and reports how much work went into replaying them.  TNL's simulated latency runs in real time, so
+// this takes several seconds; run it with --gtest_also_run_disabled_tests.
+TEST(ControlObjectConnectionTest, DISABLED_replayWithLatency)
+{
+   InputCodeManager::initializeKeyNames();
+
+   GamePair gamePair(boxLevel);
+   ServerGame *serverGame = gamePair.server;
+   ClientGame *clientGame = gamePair.getClient(0);
+   GameSettings *clientSettings = clientGame->getSettings();
+
+   DEFINE_KEYS_AND_EVENTS(clientSettings);
+
+   GamePair::idle(10, 10);    // Let the ship spawn
+
+   ASSERT_TRUE(clientGame->getLocalPlayerShip());
+   Ship *serverShip = serverGame->getClientInfo(0)->getShip();
+   ASSERT_TRUE(serverShip);
+
+   GameConnection *connection = clientGame->getConnectionToServer();
+   connection->setSimulatedNetParams(0, 250);
+
+   GamePair::idleRealTime(500);         // Let the latency kick in
+
+   // Down, then right as well, into the walls, then coast to a stop and go again.  Along the way, the ship gets
+   // shoved on the server, as if by something the client didn't see coming, and has to be corrected.
+   Event::onEvent(clientGame, &EventDownPressed);
+   GamePair::idleRealTime(750);
+   shove(serverShip);
+   GamePair::idleRealTime(750);
+   Event::onEvent(clientGame, &EventRightPressed);
+   shove(serverShip);
+   GamePair::idleRealTime(1000);
+   Event::onEvent(clientGame, &EventDownReleased);
+   Event::onEvent(clientGame, &EventRightReleased);
+   GamePair::idleRealTime(500);
+   shove(serverShip);
+   GamePair::idleRealTime(500);
+   Event::onEvent(clientGame, &EventRightPressed);
+   GamePair::idleRealTime(750);
+   shove(serverShip);
+   GamePair::idleRealTime(750);
+   Event::onEvent(clientGame, &EventRightReleased);
+
+   GamePair::idleRealTime(1000);     // Settle down
+
+   Point clientPos = clientGame->getLocalPlayerShip()->getActualPos();
+   Point serverPos = serverShip->getActualPos();
+
+   EXPECT_GT(clientPos.distanceTo(Point(0, 0)), 100) << "Ship did not move!";
+   EXPECT_NEAR(serverPos.x, clientPos.x, 1);
+   EXPECT_NEAR(serverPos.y, clientPos.y, 1);
+
+   U32 replays = connection->getReplayCount();
+   U32 skipped = connection->getSkippedReplayCount();
+
+   EXPECT_GT(replays, 0u);
+   EXPECT_GT(skipped, 0u);    // Corrections already in flight when we fixed things up don't need replaying
+
+   printf("[ BENCHMARK] 250ms ping: %d corrections, %d replays of %.1f moves each, %d skipped, %.3f ms replaying\n",
+          replays + skipped, replays, F32(connection->getReplayedMoveCount()) / getMax(replays, 1u), skipped,
+          connection->getReplayMilliseconds());
+}
+
+
+};
@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "FrameAllocator.h"
+
+#include "gtest/gtest.h"
+
+#include <map>
+#include <vector>
+
+namespace Zap
+{
+
+TEST(FrameAllocatorTest, allocAndReset)
+{
+   FrameAllocator::reset();
+
+   void *first = FrameAllocator::alloc(3);
+   void *second = FrameAllocator::alloc(8);
+
+   // Everything comes out 8-byte aligned
+   EXPECT_EQ(0u, size_t(first) % 8);
+   EXPECT_EQ(0u, size_t(second) % 8);
+   EXPECT_NE(first, second);
+
+   // Bigger than a page; goes to the heap but is still released by reset()
+   char *big = static_cast<char *>(FrameAllocator::alloc(1024 * 1024));
+   big[1024 * 1024 - 1] = 1;
+
+   EXPECT_EQ(3u, FrameAllocator::getFrameStats().allocCount);
+   EXPECT_EQ(1u, FrameAllocator::getFrameStats().largeCount);
+
+   FrameAllocator::reset();
+
+   EXPECT_EQ(0u, FrameAllocator::getFrameStats().allocCount);
+   EXPECT_EQ(3u, FrameAllocator::getLastFrameStats().allocCount);
+   EXPECT_EQ(16u + 1024 * 1024, FrameAllocator::getLastFrameStats().allocBytes);
+
+   // The page is reused from the start
+   EXPECT_EQ(first, FrameAllocator::alloc(3));
+
+   FrameAllocator::reset();
+}
+
+
+TEST(FrameAllocatorTest, stlContainers)
+{
+   FrameAllocator::reset();
+
+   {
+      std::map<S32, S32, std::less<S32>, FrameStlAllocator<std::pair<const S32, S32> > > map;
+      std::vector<S32, FrameStlAllocator<S32> > vec;
+
+      for(S32 i = 0; i < 1000; i++)
+      {
+         map[i] = i * 2;
+         vec.push_back(i);
+      }
+
+      ASSERT_EQ(1000u, map.size());
+      ASSERT_EQ(1000u, vec.size());
+
+      for(S32 i = 0; i < 1000; i++)
+      {
+         EXPECT_EQ(i * 2, map[i]);
+         EXPECT_EQ(i, vec[i]);
+      }
+   }
+
+   // 1000 map nodes, plus the vector growing a few times, and all of it spread over several pages
+   EXPECT_GT(FrameAllocator::getFrameStats().allocCount, 1000u);
+
+   FrameAllocator::reset();
+}
+
+
+};
@@ -5,6 +5,9 @@
 
 #include "../zap/GeomUtils.h"
 #include "../zap/MathUtils.h"
+#include "../zap/gridDB.h"
+#include "../zap/WallEdgeGrid.h"
+#include "../zap/BfObject.h"       // For PolyWallTypeNumber
 #include "gtest/gtest.h"
 #include <tnl.h>
 #include <map>
@@ -428,5 +431,96 @@ TEST(GeomUtilsTest, pointInHexagon)
 }
 
 
+// Bare-bones wall, so we can fill a database without a game
+class TestWall : public DatabaseObject
+{
+private:
+   Vector<Point> mPoly;
+
+public:
+   explicit TestWall(const Vector<Point> &poly)
+   {
+      mPoly = poly;
+      mObjectTypeNumber = PolyWallTypeNumber;
+      setExtent(Rect(poly));
+   }
+
+   const Vector<Point> *getCollisionPoly() const { return &mPoly; }
+};
+
+
+static F32 randomCoord(U32 &seed)
+{
+   seed = seed * 1103515245 + 12345;
+   return F32((seed >> 8) % 4000) - 1000;    // Spill outside the walls on all sides
+}
+
+
+TEST(GeomUtilsTest, wallEdgeGridMatchesLOS)
+{
+   GridDatabase database(false);
+   U32 seed = 1;
+
+   // A field of random triangles
+   for(S32 i = 0; i < 100; i++)
+   {
+      Point center(randomCoord(seed) * 0.5f, randomCoord(seed) * 0.5f);
+
+      Vector<Point> poly;
+      for(S32 j = 0; j < 3; j++)
+         poly.push_back(center + Point(randomCoord(seed) * 0.05f, randomCoord(seed) * 0.05f));
+
+      database.addToDatabase(new TestWall(poly));
+   }
+
+   // Every answer should agree with a brute-force search
+   F32 t;
+   Point n;
+   for(S32 i = 0; i < 2000; i++)
+   {
+      Point start(randomCoord(seed), randomCoord(seed));
+      Point end(randomCoord(seed), randomCoord(seed));
+
+      bool blocked = database.findObjectLOS((TestFunc)isWallType, 0, start, end, t, n) != NULL;
+      EXPECT_EQ(!blocked, database.pointCanSeePoint(start, end));
+   }
+
+   // Walls going away should be noticed
+   database.removeEverythingFromDatabase();
+   EXPECT_TRUE(database.pointCanSeePoint(Point(-1000, -1000), Point(3000, 3000)));
+}
+
+
+TEST(GeomUtilsTest, wallEdgeGridPolygonIsClear)
+{
+   GridDatabase database(false);
+
+   Vector<Point> wall;
+   wall.push_back(Point(100, 100));
+   wall.push_back(Point(110, 100));
+   wall.push_back(Point(110, 110));
+   wall.push_back(Point(100, 110));
+   database.addToDatabase(new TestWall(wall));
+
+   // Corridor passing right by the wall
+   Vector<Point> corridor;
+   corridor.push_back(Point(0, 80));
+   corridor.push_back(Point(500, 80));
+   corridor.push_back(Point(500, 99));
+   corridor.push_back(Point(0, 99));
+   EXPECT_TRUE(database.getWallEdgeGrid()->polygonIsClear(corridor));
+
+   // Widen it so it clips the wall
+   corridor[2].y = 105;
+   corridor[3].y = 105;
+   EXPECT_FALSE(database.getWallEdgeGrid()->polygonIsClear(corridor));
+
+   // Now so wide the wall is entirely inside, with no edges crossing
+   corridor[2].y = 200;
+   corridor[3].y = 200;
+   EXPECT_FALSE(database.getWallEdgeGrid()->polygonIsClear(corridor));
+}
+
+
 
 };
\ No newline at end of file
@@ -8,6 +8,10 @@
 #include "../zap/gameType.h"
 #include "../zap/luaLevelGenerator.h"
 #include "../zap/SystemFunctions.h"
+#include "../zap/EventManager.h"
+#include "../zap/Zone.h"
+#include "../zap/moveObject.h"
+#include "../zap/stringUtils.h"
 #include "gtest/gtest.h"
 
 namespace Zap
@@ -145,4 +149,270 @@ TEST_F(LuaEnvironmentTest, findAllObjects)
 }
 
 
+// Points handed to scripts are built in C++, but should be indistinguishable from ones made with point.new
+TEST_F(LuaEnvironmentTest, points)
+{
+   EXPECT_TRUE(levelgen->runString("item = ResourceItem.new(point.new(10, 20))"));
+   EXPECT_TRUE(levelgen->runString("p = item:getPos()"));
+
+   EXPECT_TRUE(levelgen->runString("assert(type(p) == 'point')"));
+   EXPECT_TRUE(levelgen->runString("assert(p.x == 10 and p.y == 20)"));
+   EXPECT_TRUE(levelgen->runString("assert(tostring(p) == tostring(point.new(10, 20)))"));
+
+   // Metamethods and library functions
+   EXPECT_TRUE(levelgen->runString("q = p + point.new(1, 1)"));
+   EXPECT_TRUE(levelgen->runString("assert(type(q) == 'point' and q.x == 11 and q.y == 21)"));
+   EXPECT_TRUE(levelgen->runString("assert(point.distanceTo(p, point.new(10, 25)) == 5)"));
+
+   // Scripts are allowed to modify the points they are given, and pass them back in
+   EXPECT_TRUE(levelgen->runString("p.x = 5; item:setPos(p)"));
+   EXPECT_TRUE(levelgen->runString("assert(item:getPos().x == 5)"));
+}
+
+
+// Profiles are looked up once and then cached; make sure they keep working after that
+TEST_F(LuaEnvironmentTest, argumentChecking)
+{
+   for(S32 i = 0; i < 2; i++)
+   {
+      // Module function
+      EXPECT_TRUE(levelgen->runString("assert(Geom.segmentsIntersect(point.new(0,0), point.new(2,2), point.new(0,2), point.new(2,0)))"));
+      EXPECT_FALSE(levelgen->runString("Geom.segmentsIntersect(1)"));
+
+      // Class method
+      EXPECT_TRUE(levelgen->runString("item = ResourceItem.new(); item:setPos(point.new(1, 1))"));
+      EXPECT_FALSE(levelgen->runString("item:setPos('foo')"));
+   }
+}
+
+
+TEST_F(LuaEnvironmentTest, findAllObjectData)
+{
+   EXPECT_TRUE(levelgen->runString("bf:addItem(ResourceItem.new(point.new(0,0)))"));
+   EXPECT_TRUE(levelgen->runString("bf:addItem(ResourceItem.new(point.new(300,300)))"));
+   EXPECT_TRUE(levelgen->runString("bf:addItem(TestItem.new(point.new(200,200)))"));
+
+   EXPECT_TRUE(levelgen->runString("data = { }"));
+   EXPECT_TRUE(levelgen->runString("assert(bf:findAllObjectData(data) == 3)"));
+   EXPECT_TRUE(levelgen->runString("assert(#data == 3 * 8)"));
+
+   // Records line up with what the objects themselves report
+   EXPECT_TRUE(levelgen->runString("assert(bf:findAllObjectData(data, ObjType.TestItem) == 1)"));
+   EXPECT_TRUE(levelgen->runString("assert(data[2] == ObjType.TestItem)"));
+   EXPECT_TRUE(levelgen->runString("assert(data[4] == 200 and data[5] == 200)"));
+
+   EXPECT_TRUE(levelgen->runString("assert(bf:findAllObjectDataInArea(data, point.new(-10,-10), point.new(10,10), ObjType.ResourceItem) == 1)"));
+   EXPECT_TRUE(levelgen->runString("assert(data[4] == 0 and data[5] == 0)"));
+
+   // Once the table is big enough, scanning shouldn't make any garbage, unlike findAllObjects()
+   lua_gc(L, LUA_GCCOLLECT, 0);
+   lua_gc(L, LUA_GCSTOP, 0);
+
+   S32 before = lua_gc(L, LUA_GCCOUNT, 0);
+   EXPECT_TRUE(levelgen->runString("for i = 1, 1000 do bf:findAllObjects() end"));
+   S32 objectsKb = lua_gc(L, LUA_GCCOUNT, 0) - before;
+
+   before = lua_gc(L, LUA_GCCOUNT, 0);
+   EXPECT_TRUE(levelgen->runString("for i = 1, 1000 do bf:findAllObjectData(data) end"));
+   S32 dataKb = lua_gc(L, LUA_GCCOUNT, 0) - before;
+
+   lua_gc(L, LUA_GCRESTART, 0);
+
+   EXPECT_LT(dataKb * 10, objectsKb);
+}
+
+
+TEST_F(LuaEnvironmentTest, proxies)
+{
+   TestItem *item = new TestItem();
+   item->addToGame(serverGame, serverGame->getGameObjDatabase());
+
+   LuaScriptStats before = LuaScriptRunner::getStats();
+
+   // Pushing the same object again reuses its proxy while the script still has hold of it...
+   EXPECT_TRUE(levelgen->runString("items = { }; for i = 1, 100 do items[i] = bf:findAllObjects(ObjType.TestItem)[1] end"));
+   EXPECT_TRUE(levelgen->runString("assert(items[1] == items[100])"));
+   EXPECT_EQ(before.proxiesAllocated + 1, LuaScriptRunner::getStats().proxiesAllocated);
+   EXPECT_EQ(before.liveProxies + 1, LuaScriptRunner::getStats().liveProxies);
+
+   // ...and the proxy goes back to the pool once the script lets go
+   EXPECT_TRUE(levelgen->runString("items = nil"));
+   lua_gc(L, LUA_GCCOLLECT, 0);
+   EXPECT_EQ(before.liveProxies, LuaScriptRunner::getStats().liveProxies);
+
+   // The object itself is fine, and gets a new proxy when it's needed again
+   EXPECT_TRUE(levelgen->runString("assert(bf:findAllObjects(ObjType.TestItem)[1]:getPos().x == 0)"));
+   EXPECT_EQ(before.proxiesAllocated + 2, LuaScriptRunner::getStats().proxiesAllocated);
+
+   // Values scripts stash on an object survive its proxy being collected
+   EXPECT_TRUE(levelgen->runString("bf:findAllObjects(ObjType.TestItem)[1].tag = 'mine'"));
+   lua_gc(L, LUA_GCCOLLECT, 0);
+   EXPECT_TRUE(levelgen->runString("assert(bf:findAllObjects(ObjType.TestItem)[1].tag == 'mine')"));
+}
+
+
+TEST_F(LuaEnvironmentTest, scriptCache)
+{
+   const string scriptName = "script_cache_test.levelgen";
+   writeFile(scriptName, "function main() version = 1 end");
+
+   LuaLevelGenerator levelgen1(serverGame, scriptName);
+   EXPECT_TRUE(levelgen1.runScript(true));
+   EXPECT_TRUE(levelgen1.runString("assert(version == 1)"));
+
+   // Edits are picked up even though the name is the same
+   writeFile(scriptName, "function main() version = 2 end");
+
+   LuaLevelGenerator levelgen2(serverGame, scriptName);
+   EXPECT_TRUE(levelgen2.runScript(true));
+   EXPECT_TRUE(levelgen2.runString("assert(version == 2)"));
+
+   // And the first version is still there for anyone who needs it
+   writeFile(scriptName, "function main() version = 1 end");
+
+   LuaLevelGenerator levelgen3(serverGame, scriptName);
+   EXPECT_TRUE(levelgen3.runScript(true));
+   EXPECT_TRUE(levelgen3.runString("assert(version == 1)"));
+
+   // Compile errors are still reported
+   writeFile(scriptName, "function main() version = end");
+
+   LuaLevelGenerator levelgen4(serverGame, scriptName);
+   EXPECT_FALSE(levelgen4.runScript(true));
+
+   remove(scriptName.c_str());
+
+   LuaScriptRunner::clearScriptCache();
+}
+
+
+TEST_F(LuaEnvironmentTest, memoryLimit)
+{
+   LuaScriptRunner::setScriptMemoryLimit(1024 * 1024);
+
+   // Garbage doesn't count against a script, no matter how much it makes
+   EXPECT_TRUE(levelgen->runString("for i = 1, 100000 do local t = { i, i, i } end"));
+   EXPECT_LT(levelgen->getMemoryUsed(), 1024 * 1024);
+
+   // Nor does garbage left lying about between calls, however long it takes to be collected
+   for(S32 i = 0; i < 50; i++)
+      EXPECT_TRUE(levelgen->runString("for i = 1, 10000 do local t = { i, i, i } end"));
+   EXPECT_LT(levelgen->getMemoryUsed(), 1024 * 1024);
+
+   // Hanging on to it does
+   EXPECT_TRUE(levelgen->runString("hoard = { }; hoardMore = function(n) for i = 1, n do hoard[#hoard + 1] = { i, i, i } end end"));
+   EXPECT_TRUE(levelgen->runString("hoardMore(1000)"));
+
+   LuaScriptStats stats = LuaScriptRunner::getStats();
+   EXPECT_FALSE(levelgen->runString("hoardMore(100000)"));
+   EXPECT_EQ(stats.scriptsKilled + 1, LuaScriptRunner::getStats().scriptsKilled);
+
+   // Same goes for functions we call directly, such as event handlers
+   lua_pushinteger(L, 100000);
+   EXPECT_TRUE(levelgen->runCmd("hoardMore", 0, 1));
+   EXPECT_EQ(0, lua_gettop(L));
+
+   // Other scripts aren't blamed for it
+   LuaLevelGenerator levelgen2(serverGame);
+   levelgen2.prepareEnvironment();
+   EXPECT_TRUE(levelgen2.runString("x = { 1, 2, 3 }"));
+   EXPECT_LT(levelgen2.getMemoryUsed(), 1024);
+
+   // A limit too big to count in bytes is as good as none
+   LuaScriptRunner::setScriptMemoryLimit(S64(4096) * 1024 * 1024);
+   EXPECT_EQ(S32_MAX, LuaScriptRunner::getScriptMemoryLimit());
+
+   LuaScriptRunner::setScriptMemoryLimit(0);
+   EXPECT_TRUE(levelgen->runString("hoardMore(100000)"));
+}
+
+
+// A script whose live data sits just under the limit shouldn't set off a full collection with every bit of garbage
+TEST_F(LuaEnvironmentTest, memoryLimitHysteresis)
+{
+   LuaScriptRunner::setScriptMemoryLimit(1024 * 1024);
+
+   EXPECT_TRUE(levelgen->runString("hoard = { }; for i = 1, 940 do hoard[i] = string.rep('x', 1000) .. i end"));
+
+   U32 collections = LuaScriptRunner::getStats().fullCollections;
+
+   for(S32 i = 0; i < 100; i++)
+      EXPECT_TRUE(levelgen->runString("local t = { }; for i = 1, 500 do t[i] = string.rep('y', 100) .. i end"));
+
+   // Roughly one per eighth of the limit's worth of garbage, rather than one every call
+   EXPECT_LT(LuaScriptRunner::getStats().fullCollections - collections, 20u);
+
+   // Holding on to more than the limit still gets caught
+   LuaScriptStats stats = LuaScriptRunner::getStats();
+   EXPECT_FALSE(levelgen->runString("hoard2 = string.rep('y', 100 * 1024)"));
+   EXPECT_EQ(stats.scriptsKilled + 1, LuaScriptRunner::getStats().scriptsKilled);
+
+   LuaScriptRunner::setScriptMemoryLimit(0);
+}
+
+
+TEST_F(LuaEnvironmentTest, jitOptions)
+{
+   EXPECT_TRUE(LuaScriptRunner::setJitOptions(true, "hotloop=5, maxtrace=2000"));
+   EXPECT_FALSE(LuaScriptRunner::setJitOptions(true, "notAnOption=3"));
+
+   // A hot loop should get compiled, and our listener should hear about it
+   U32 traces = LuaScriptRunner::getStats().tracesCompleted;
+   EXPECT_TRUE(levelgen->runString("local x = 0; for i = 1, 1000 do x = x + i end"));
+   EXPECT_LT(traces, LuaScriptRunner::getStats().tracesCompleted);
+
+   // ...unless the JIT is off
+   EXPECT_TRUE(LuaScriptRunner::setJitOptions(false, ""));
+   traces = LuaScriptRunner::getStats().tracesCompleted;
+   EXPECT_TRUE(levelgen->runString("local x = 0; for i = 1, 1000 do x = x + i end"));
+   EXPECT_EQ(traces, LuaScriptRunner::getStats().tracesCompleted);
+
+   LuaScriptRunner::setJitOptions(true, "");
+}
+
+
+TEST_F(LuaEnvironmentTest, zoneEventFilters)
+{
+   LuaLevelGenerator levelgen2(serverGame);
+   levelgen2.prepareEnvironment();
+
+   const char *handler = "hits = 0; onObjectEnteredZone = function(obj, zone, zoneType, zoneId) hits = hits + 1; lastObj = obj; lastId = zoneId end";
+   EXPECT_TRUE(levelgen->runString(handler));
+   EXPECT_TRUE(levelgen2.runString(handler));
+
+   EXPECT_TRUE(levelgen->runString("bf:subscribe(Event.ObjectEnteredZone, 2)"));
+   EXPECT_TRUE(levelgen2.runString("bf:subscribe(Event.ObjectEnteredZone)"));
+   EventManager::get()->update();
+
+   ResourceItem *item = new ResourceItem();
+   Zone *zone1 = new Zone();
+   Zone *zone2 = new Zone();
+   zone1->setUserAssignedId(1, false);
+   zone2->setUserAssignedId(2, false);
+
+   EventManager::get()->fireEvent(EventManager::ObjectEnteredZoneEvent, item, zone1);
+   EventManager::get()->fireEvent(EventManager::ObjectEnteredZoneEvent, item, zone2);
+
+   // Filtered script only hears about its zone, the other hears about both
+   EXPECT_TRUE(levelgen->runString("assert(hits == 1 and lastId == 2)"));
+   EXPECT_TRUE(levelgen2.runString("assert(hits == 2 and lastId == 2)"));
+   EXPECT_TRUE(levelgen->runString("assert(lastObj:getObjType() == ObjType.ResourceItem)"));
+   EXPECT_TRUE(levelgen2.runString("assert(lastObj:getObjType() == ObjType.ResourceItem)"));
+
+   // Subscribing again without an id drops the filter
+   EXPECT_TRUE(levelgen->runString("bf:subscribe(Event.ObjectEnteredZone)"));
+   EventManager::get()->update();
+   EventManager::get()->fireEvent(EventManager::ObjectEnteredZoneEvent, item, zone1);
+   EXPECT_TRUE(levelgen->runString("assert(hits == 2 and lastId == 1)"));
+
+   EXPECT_TRUE(levelgen->runString("bf:unsubscribe(Event.ObjectEnteredZone)"));
+   EXPECT_TRUE(levelgen2.runString("bf:unsubscribe(Event.ObjectEnteredZone)"));
+   EventManager::get()->update();
+
+   delete zone2;
+   delete zone1;
+   delete item;
+}
+
+
 };
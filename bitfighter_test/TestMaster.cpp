@@ -9,6 +9,9 @@
 
 #include "../master/master.h"
 #include "../master/MasterServerConnection.h"
+#include "../master/DatabaseAccessThread.h"
+#include "../master/JsonServerList.h"
+#include "../master/database.h"
 #include "masterConnection.h"
 #include "ClientGame.h"
 #include "UIManager.h"
@@ -39,5 +42,166 @@ TEST(MasterTest, Sanity)
 
    delete clientGame;
 }
+
+
+// Records the order entries ran in; the first one can be told to hold the worker until we're ready
+class RecordingEntry : public ThreadEntry
+{
+public:
+   S32 id;
+   Vector<S32> *runOrder;
+   Semaphore *gate;
+   bool finished;
+
+   RecordingEntry(S32 id, Vector<S32> *runOrder, Semaphore *gate = NULL)
+   {
+      this->id = id;
+      this->runOrder = runOrder;
+      this->gate = gate;
+      finished = false;
+   }
+
+   void run()
+   {
+      if(gate)
+         gate->wait();
+      runOrder->push_back(id);
+   }
+
+   void finish() { finished = true; }
+};
+
+
+TEST(MasterTest, DatabaseAccessThreadPriorities)
+{
+   DatabaseAccessThread thread(1);
+   Vector<S32> runOrder;
+   Semaphore gate;
+
+   // Keep the only worker busy while we queue everything else up
+   RefPtr<RecordingEntry> blocker = new RecordingEntry(0, &runOrder, &gate);
+   thread.addEntry(blocker, DatabaseAccessThread::BulkPriority);
+
+   while(thread.getLaneStats(DatabaseAccessThread::BulkPriority).queued > 0)
+      Platform::sleep(1);
+
+   Vector<RefPtr<RecordingEntry> > entries;
+   DatabaseAccessThread::Priority priorities[] = { DatabaseAccessThread::BulkPriority,   DatabaseAccessThread::NormalPriority,
+                                                   DatabaseAccessThread::HighPriority,   DatabaseAccessThread::BulkPriority,
+                                                   DatabaseAccessThread::HighPriority };
+   for(S32 i = 0; i < 5; i++)
+   {
+      entries.push_back(new RecordingEntry(i + 1, &runOrder));
+      thread.addEntry(entries[i], priorities[i]);
+   }
+
+   EXPECT_EQ(5, thread.getLaneStats(DatabaseAccessThread::BulkPriority).queued +
+                thread.getLaneStats(DatabaseAccessThread::NormalPriority).queued +
+                thread.getLaneStats(DatabaseAccessThread::HighPriority).queued);
+
+   gate.increment();
+
+   // Wait for the worker to get through everything
+   U32 start = Platform::getRealMilliseconds();
+   while(runOrder.size() < 6 && Platform::getRealMilliseconds() - start < 5000)
+      Platform::sleep(1);
+
+   ASSERT_EQ(6, runOrder.size());
+
+   // High lane first, then normal, then bulk, each in the order they were queued
+   S32 expected[] = { 0, 3, 5, 2, 1, 4 };
+   for(S32 i = 0; i < 6; i++)
+      EXPECT_EQ(expected[i], runOrder[i]);
+
+   // finish() only happens on the main thread, from idle()
+   EXPECT_FALSE(entries[0]->finished);
+   thread.idle();
+   for(S32 i = 0; i < entries.size(); i++)
+      EXPECT_TRUE(entries[i]->finished);
+
+   DatabaseAccessThread::LaneStats stats = thread.getLaneStats(DatabaseAccessThread::BulkPriority);
+   EXPECT_EQ(3, stats.processed);
+   EXPECT_EQ(0, stats.queued);
+   EXPECT_EQ(2, stats.peakQueued);       // The blocker was already running when the other two were queued
+}
+
+
+// Achievements and level info written while a batch of stats is still open mustn't be locked out by it, and lost
+TEST(MasterTest, BatchedStatsWithAchievements)
+{
+   const char *dbFile = "test_batched_stats.db";
+   remove(dbFile);
+
+   DbWriter::DatabaseWriter writer(dbFile);
+   writer.setStatsBatchSize(10);
+
+   GameStats stats;
+   stats.serverName = "Test server";
+   stats.serverIP = "192.0.2.1";
+   stats.gameType = "CTF";
+   stats.levelName = "Test level";
+   stats.duration = 100;
+
+   writer.insertStats(stats);
+   writer.insertAchievement(1, "ChumpChange", stats.serverName, stats.serverIP);
+   writer.insertLevelInfo("0123456789abcdef0123456789abcdef", stats.levelName, "ChumpChange", stats.gameType, false, 2, 10, 100);
+   writer.insertStats(stats);
+
+   DbWriter::DatabaseWriter::commitPendingWrites();
+
+   Vector<Vector<string> > counts;
+   writer.selectHandler("SELECT (SELECT COUNT(*) FROM stats_game), (SELECT COUNT(*) FROM player_achievements), "
+                        "(SELECT COUNT(*) FROM stats_level), (SELECT COUNT(*) FROM server);", 4, counts);
+
+   ASSERT_EQ(1, counts.size());
+   EXPECT_EQ("2", counts[0][0]);
+   EXPECT_EQ("1", counts[0][1]);
+   EXPECT_EQ("1", counts[0][2]);
+   EXPECT_EQ("1", counts[0][3]);     // All share the one server row
+
+   DbWriter::DbConnectionPool::closeAll();
+   remove(dbFile);
+}
+
+
+TEST(MasterTest, JsonServerList)
+{
+   JsonServerList list;
+   S32 server1, server2, player1, player2;    // Just need some addresses to use as keys
+
+   list.setMotd("Hi \"there\"");
+   list.updateServer(&server1, "Spang", 23, "Triple Threat", "CTF", 2);
+   list.updateServer(&server2, "Ramst", 23, "Kaptor", "Hunters", 1);
+   list.updatePlayer(&player1, "chris", true);
+   list.updatePlayer(&player2, "colin", false);
+
+   string expected = 
+      "{\n\t\"servers\": [\n"
+      "\t\t{\n\t\t\t\"serverName\": \"Spang\",\n\t\t\t\"protocolVersion\": 23,\n\t\t\t\"currentLevelName\": \"Triple Threat\",\n"
+      "\t\t\t\"currentLevelType\": \"CTF\",\n\t\t\t\"playerCount\": 2\n\t\t}, \n"
+      "\t\t{\n\t\t\t\"serverName\": \"Ramst\",\n\t\t\t\"protocolVersion\": 23,\n\t\t\t\"currentLevelName\": \"Kaptor\",\n"
+      "\t\t\t\"currentLevelType\": \"Hunters\",\n\t\t\t\"playerCount\": 1\n\t\t}\n\t],\n"
+      "\t\"players\": [\"chris\", \"colin\"],\n"
+      "\t\"authenticated\": [true, false],\n"
+      "\t\"serverCount\": 2,\n\t\"playerCount\": 3,\n"
+      "\t\"motd\": \"Hi \\\"there\\\"\"\n}\n";
+
+   EXPECT_EQ(expected, list.getDocument());
+
+   // Changes only touch their own entry, and keep everyone in place
+   list.updateServer(&server1, "Spang", 23, "Bonk", "Soccer", 4);
+   list.updatePlayer(&player2, "colin", true);
+   list.removePlayer(&player1);
+
+   EXPECT_EQ(5, list.getPlayerCount());
+   EXPECT_NE(string::npos, list.getDocument().find("\"currentLevelName\": \"Bonk\""));
+   EXPECT_LT(list.getDocument().find("Spang"), list.getDocument().find("Ramst"));
+   EXPECT_NE(string::npos, list.getDocument().find("\"players\": [\"colin\"],\n\t\"authenticated\": [true]"));
+
+   list.removeServer(&server1);
+   list.removeServer(&server1);     // Harmless
+   EXPECT_EQ(1, list.getServerCount());
+   EXPECT_EQ(1, list.getPlayerCount());
+}
 	
 };
@@ -0,0 +1,194 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "tnlNetInterface.h"
+#include "tnlNonce.h"
+#include "gtest/gtest.h"
+
+namespace Zap
+{
+
+// Build a ConnectChallengeRequest the way NetInterface::sendConnectChallengeRequest() does
+static void writeChallengeRequest(PacketStream &out)
+{
+   Nonce nonce;
+   nonce.getRandom();
+
+   out.write(U8(NetInterface::ConnectChallengeRequest));
+   nonce.write(&out);
+   out.writeFlag(false);      // Key exchange
+   out.writeFlag(false);      // Certificate
+}
+
+
+// Build a ConnectRequest with a made-up cookie, like a spoofer who never saw our challenge response would
+static void writeForgedConnectRequest(PacketStream &out)
+{
+   Nonce nonce, serverNonce;
+   nonce.getRandom();
+   serverNonce.getRandom();
+
+   out.write(U8(NetInterface::ConnectRequest));
+   nonce.write(&out);
+   serverNonce.write(&out);
+   out.write(U32(0xDEADBEEF));
+}
+
+
+// Our flood harness: feed packets straight into processPacket(), as checkIncomingPackets() would
+static void flood(NetInterface *netInterface, void (*writePacket)(PacketStream &), const Address &from, S32 count)
+{
+   for(S32 i = 0; i < count; i++)
+   {
+      PacketStream out;
+      writePacket(out);
+
+      BitStream in(out.getBuffer(), out.getBytePosition());
+      netInterface->processPacket(from, &in);
+   }
+}
+
+
+static Address makeAddress(U32 netNum)
+{
+   Address address(IPProtocol, Address::Any, 28000);
+   address.netNum[0] = netNum;
+   return address;
+}
+
+
+class NetInterfaceTest : public testing::Test
+{
+protected:
+   RefPtr<NetInterface> mNetInterface;
+
+   virtual void SetUp()
+   {
+      mNetInterface = new NetInterface(Address(IPProtocol, Address::Any, 0));
+
+      // Don't actually answer the requests, we only care about what gets through to the handlers
+      mNetInterface->setAllowsConnections(false);
+   }
+};
+
+
+TEST_F(NetInterfaceTest, singleHostFlood)
+{
+   flood(mNetInterface, writeChallengeRequest, makeAddress(0xC0000201), 1000);      // 192.0.2.1
+
+   // Only the per-address burst gets through
+   EXPECT_EQ(1000 - 16, mNetInterface->getConnectFloodStats().challengeRequestsDropped);
+
+   // The neighbors still have some room...
+   mNetInterface->resetConnectFloodStats();
+   flood(mNetInterface, writeChallengeRequest, makeAddress(0xC0000202), 1);
+   EXPECT_EQ(0, mNetInterface->getConnectFloodStats().getTotalDropped());
+
+   // ...as does everyone else
+   flood(mNetInterface, writeChallengeRequest, makeAddress(0xC6336401), 1);        // 198.51.100.1
+   EXPECT_EQ(0, mNetInterface->getConnectFloodStats().getTotalDropped());
+}
+
+
+TEST_F(NetInterfaceTest, spoofedFlood)
+{
+   // One packet each from lots of different networks; nobody hits their own limits, but the global limit kicks in
+   for(U32 i = 0; i < 1000; i++)
+      flood(mNetInterface, writeChallengeRequest, makeAddress(0x0A000001 + (i << 8)), 1);
+
+   EXPECT_EQ(1000 - 256, mNetInterface->getConnectFloodStats().challengeRequestsDropped);
+}
+
+
+TEST_F(NetInterfaceTest, forgedCookies)
+{
+   flood(mNetInterface, writeForgedConnectRequest, makeAddress(0xC0000201), 100);
+
+   // The first burst makes it past the rate limiter but is turned away by the cookie check, the rest never get that far
+   const ConnectFloodStats &stats = mNetInterface->getConnectFloodStats();
+
+   EXPECT_EQ(0, stats.invalidCookies);       // We're not allowing connections, so it shouldn't get this far
+   EXPECT_EQ(100 - 16, stats.connectRequestsDropped);
+
+   mNetInterface->setAllowsConnections(true);
+   mNetInterface->resetConnectFloodStats();
+   flood(mNetInterface, writeForgedConnectRequest, makeAddress(0xC0000301), 10);
+   EXPECT_EQ(10, stats.invalidCookies);
+   EXPECT_EQ(0, stats.puzzleRejects);
+}
+
+
+TEST_F(NetInterfaceTest, localhostIsExempt)
+{
+   flood(mNetInterface, writeChallengeRequest, makeAddress(0x7F000001), 1000);      // 127.0.0.1
+   EXPECT_EQ(0, mNetInterface->getConnectFloodStats().getTotalDropped());
+}
+
+
+// Once a spoofed flood has emptied the global bucket, hosts we're already talking to still get through
+TEST(ConnectRateLimiterTest, knownHost)
+{
+   ConnectRateLimiter limiter;
+
+   ConnectRateLimiter::Limit addressLimit = { 2, 4 };
+   ConnectRateLimiter::Limit globalLimit = { 1, 8 };
+   ConnectRateLimiter::Limit unlimited = { 0, 0 };
+   limiter.setLimits(addressLimit, unlimited, globalLimit);
+
+   U32 time = 10000;
+
+   for(U32 i = 0; i < 100; i++)
+      limiter.allow(makeAddress(0x0A000001 + (i << 8)), time);
+
+   Address address = makeAddress(0xC0000201);
+   EXPECT_FALSE(limiter.allow(address, time));
+
+   // ...but are still held to their own limits
+   for(S32 i = 0; i < 3; i++)
+      EXPECT_TRUE(limiter.allow(address, time, true));
+   EXPECT_FALSE(limiter.allow(address, time, true));
+}
+
+
+TEST(ConnectRateLimiterTest, refill)
+{
+   ConnectRateLimiter limiter;
+
+   ConnectRateLimiter::Limit addressLimit = { 2, 4 };     // 2 per second, burst of 4
+   ConnectRateLimiter::Limit unlimited = { 0, 0 };
+   limiter.setLimits(addressLimit, unlimited, unlimited);
+
+   Address address = makeAddress(0xC0000201);
+   U32 time = 10000;
+
+   for(S32 i = 0; i < 4; i++)
+      EXPECT_TRUE(limiter.allow(address, time));
+   EXPECT_FALSE(limiter.allow(address, time));
+
+   // One token comes back every 500ms
+   EXPECT_FALSE(limiter.allow(address, time + 499));
+   EXPECT_TRUE (limiter.allow(address, time + 500));
+   EXPECT_FALSE(limiter.allow(address, time + 500));
+
+   // Never more than the burst, no matter how long we wait
+   time += 60000;
+   for(S32 i = 0; i < 4; i++)
+      EXPECT_TRUE(limiter.allow(address, time));
+   EXPECT_FALSE(limiter.allow(address, time));
+
+   // Works across the clock wrapping, too
+   time = U32(-200);
+   limiter.reset();
+   for(S32 i = 0; i < 4; i++)
+      EXPECT_TRUE(limiter.allow(address, time));
+   EXPECT_FALSE(limiter.allow(address, time + 499));
+   EXPECT_TRUE (limiter.allow(address, time + 500));
+
+   limiter.setEnabled(false);
+   for(S32 i = 0; i < 100; i++)
+      EXPECT_TRUE(limiter.allow(address, time));
+}
+
+};
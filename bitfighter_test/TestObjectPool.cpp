@@ -0,0 +1,75 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "ObjectPool.h"
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+namespace Zap
+{
+
+class PooledThing
+{
+public:
+   F64 value;
+   char padding[100];
+
+   PooledThing() { value = 1; }
+   virtual ~PooledThing() { /* Do nothing */ }
+
+   BF_DECLARE_POOLED_ALLOC;
+};
+
+BF_IMPLEMENT_POOLED_ALLOC(PooledThing);
+
+
+class BiggerThing : public PooledThing
+{
+public:
+   char morePadding[100];
+};
+
+
+TEST(ObjectPoolTest, reuseSlots)
+{
+   PooledThing *first = new PooledThing();
+   PooledThing *second = new PooledThing();
+
+   EXPECT_EQ(0u, size_t(first) % 8);
+   EXPECT_EQ(0u, size_t(second) % 8);
+   EXPECT_EQ(1, first->value);
+
+   const ObjectPool *pool = NULL;
+   for(S32 i = 0; i < ObjectPool::getPools().size(); i++)
+      if(strcmp(ObjectPool::getPools()[i]->getName(), "PooledThing") == 0)
+         pool = ObjectPool::getPools()[i];
+
+   ASSERT_TRUE(pool != NULL);
+   EXPECT_EQ(2u, pool->getLiveCount());
+
+   // Freed slots are handed out again, most recent first
+   delete second;
+   EXPECT_EQ(1u, pool->getLiveCount());
+   EXPECT_EQ(second, new PooledThing());
+
+   // Subclasses without their own pool don't fit our slots, and go to the heap; deleting through a base pointer
+   // still finds its way back there
+   PooledThing *bigger = new BiggerThing();
+   EXPECT_EQ(1u, pool->getHeapCount());
+   EXPECT_EQ(2u, pool->getLiveCount());
+   delete bigger;
+
+   delete first;
+   delete second;
+
+   EXPECT_EQ(0u, pool->getLiveCount());
+   EXPECT_EQ(2u, pool->getPeakCount());
+   EXPECT_EQ(3u, pool->getAllocCount());
+}
+
+
+};
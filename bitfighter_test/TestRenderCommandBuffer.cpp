@@ -0,0 +1,198 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "RenderCommandBuffer.h"
+
+#include "Color.h"
+#include "Point.h"
+
+#include "gtest/gtest.h"
+
+namespace Zap
+{
+
+// Keeps a copy of everything it's asked to draw
+class RecordingRenderBackend : public RenderBackend
+{
+public:
+   Vector<U32> geomTypes;
+   Vector<F32> lineWidths;
+   Vector<S32> vertexCounts;
+   Vector<F32> vertices;
+   Vector<F32> colors;
+
+   void drawBatch(U32 geomType, F32 lineWidth, const F32 vertices[], const F32 colors[], S32 vertexCount)
+   {
+      geomTypes.push_back(geomType);
+      lineWidths.push_back(lineWidth);
+      vertexCounts.push_back(vertexCount);
+
+      for(S32 i = 0; i < vertexCount * 2; i++)
+         this->vertices.push_back(vertices[i]);
+
+      for(S32 i = 0; i < vertexCount * 4; i++)
+         this->colors.push_back(colors[i]);
+   }
+};
+
+
+static const F32 square[] = { 0,0,  1,0,  1,1,  0,1 };
+
+
+TEST(RenderCommandBufferTest, primitivesBecomeLists)
+{
+   RenderCommandBuffer buffer;
+   RecordingRenderBackend backend;
+
+   buffer.addVertices(square, 4, RenderCommandBuffer::LineLoop);
+   buffer.flush(backend);
+
+   ASSERT_EQ(1, backend.geomTypes.size());
+   EXPECT_EQ(RenderCommandBuffer::Lines, backend.geomTypes[0]);
+   ASSERT_EQ(8, backend.vertexCounts[0]);
+
+   // Last segment closes the loop
+   EXPECT_EQ(0, backend.vertices[12]);
+   EXPECT_EQ(1, backend.vertices[13]);
+   EXPECT_EQ(0, backend.vertices[14]);
+   EXPECT_EQ(0, backend.vertices[15]);
+
+   backend = RecordingRenderBackend();
+   buffer.addVertices(square, 4, RenderCommandBuffer::LineStrip);
+   buffer.addVertices(square, 4, RenderCommandBuffer::TriangleFan);
+   buffer.addVertices(square, 4, RenderCommandBuffer::TriangleStrip);
+   buffer.flush(backend);
+
+   // Fills come out first, as one batch
+   ASSERT_EQ(2, backend.geomTypes.size());
+   EXPECT_EQ(RenderCommandBuffer::Triangles, backend.geomTypes[0]);
+   EXPECT_EQ(12, backend.vertexCounts[0]);
+   EXPECT_EQ(RenderCommandBuffer::Lines, backend.geomTypes[1]);
+   EXPECT_EQ(6, backend.vertexCounts[1]);
+
+   EXPECT_TRUE(buffer.isEmpty());
+   EXPECT_EQ(0, buffer.getVertexCount());
+}
+
+
+TEST(RenderCommandBufferTest, transforms)
+{
+   RenderCommandBuffer buffer;
+   RecordingRenderBackend backend;
+
+   static const F32 point[] = { 1, 0 };
+
+   buffer.pushTransform();
+      buffer.translate(Point(10, 20));
+      buffer.scale(2, 2);
+      buffer.rotate(FloatHalfPi);
+      buffer.addVertices(point, 1, RenderCommandBuffer::Points);
+   buffer.popTransform();
+
+   buffer.addVertices(point, 1, RenderCommandBuffer::Points);
+   buffer.flush(backend);
+
+   ASSERT_EQ(4, backend.vertices.size());
+   EXPECT_NEAR(10, backend.vertices[0], 0.0001);      // (1,0) rotated a quarter turn, doubled, then moved
+   EXPECT_NEAR(22, backend.vertices[1], 0.0001);
+   EXPECT_NEAR(1,  backend.vertices[2], 0.0001);      // Back to where we started
+   EXPECT_NEAR(0,  backend.vertices[3], 0.0001);
+}
+
+
+TEST(RenderCommandBufferTest, sortByLayerAndState)
+{
+   RenderCommandBuffer buffer;
+   RecordingRenderBackend backend;
+
+   buffer.setLayer(1);
+   buffer.setColor(Color(1, 0, 0));
+   buffer.addVertices(square, 4, RenderCommandBuffer::LineLoop);
+
+   buffer.setLayer(0);
+   buffer.setColor(Color(0, 1, 0), 0.5f);
+   buffer.addVertices(square, 4, RenderCommandBuffer::LineLoop);
+
+   buffer.setLineWidth(1);
+   buffer.addVertices(square, 4, RenderCommandBuffer::LineLoop);
+   buffer.setLineWidth(0);
+
+   buffer.setLayer(1);
+   buffer.setColor(Color(0, 0, 1));
+   buffer.addVertices(square, 4, RenderCommandBuffer::LineLoop);
+
+   buffer.flush(backend);
+
+   // Layer 0 at default width, layer 0 at width 1, then both layer 1 loops together
+   ASSERT_EQ(3, backend.geomTypes.size());
+   EXPECT_EQ(0, backend.lineWidths[0]);
+   EXPECT_EQ(1, backend.lineWidths[1]);
+   EXPECT_EQ(16, backend.vertexCounts[2]);
+
+   // Each vertex keeps its own color, in the order it was added
+   EXPECT_EQ(1,    backend.colors[0 * 4 + 1]);      // Green, half alpha
+   EXPECT_EQ(0.5f, backend.colors[0 * 4 + 3]);
+   EXPECT_EQ(1,    backend.colors[16 * 4 + 0]);     // Red
+   EXPECT_EQ(1,    backend.colors[31 * 4 + 2]);     // Blue
+}
+
+
+// The game view draws a few hundred projectiles at a time; each used to be two draw calls with state changes between
+TEST(RenderCommandBufferTest, batchingEfficiency)
+{
+   RenderCommandBuffer buffer;
+   CountingRenderBackend backend;
+
+   static const S16 star[] = { -2,2,  0,6,  2,2,  6,0,  2,-2,  0,-6,  -2,-2,  -6,0 };
+   const S32 projectiles = 300;
+
+   for(S32 i = 0; i < projectiles; i++)
+   {
+      buffer.pushTransform();
+         buffer.translate(F32(i * 10), 0);
+         buffer.rotate(i * 0.1f);
+
+         buffer.setColor(Color(1, 0, 0));
+         buffer.addVertices(star, 8, RenderCommandBuffer::LineLoop);
+
+         buffer.setColor(Color(1, 1, 0));
+         buffer.addVertices(star, 8, RenderCommandBuffer::LineLoop);
+      buffer.popTransform();
+   }
+
+   EXPECT_EQ(1, buffer.getCommandCount());
+   buffer.flush(backend);
+
+   EXPECT_EQ(1, backend.getDrawCallCount());
+   EXPECT_EQ(projectiles * 2 * 16, backend.getVertexCount());
+
+   // A thin line every so often costs a draw call of its own, but no more than that
+   backend.reset();
+   for(S32 i = 0; i < projectiles; i++)
+   {
+      buffer.setLineWidth(i % 10 == 0 ? 1.0f : 0);
+      buffer.addVertices(star, 8, RenderCommandBuffer::LineLoop);
+   }
+
+   EXPECT_EQ(projectiles / 10 * 2, buffer.getCommandCount());
+   buffer.flush(backend);
+
+   EXPECT_EQ(2, backend.getDrawCallCount());
+}
+
+
+TEST(RenderCommandBufferTest, emptyFlush)
+{
+   RenderCommandBuffer buffer;
+   CountingRenderBackend backend;
+
+   buffer.addVertices(square, 1, RenderCommandBuffer::Lines);     // Not enough for a line
+   buffer.flush(backend);
+
+   EXPECT_EQ(0, backend.getDrawCallCount());
+}
+
+
+};
@@ -4,10 +4,13 @@
 //------------------------------------------------------------------------------
 
 #include "TestUtils.h"
+#include "../zap/BotPerception.h"
 #include "../zap/ClientGame.h"
+#include "../zap/EventManager.h"
 #include "../zap/ServerGame.h"
 #include "../zap/gameType.h"
 #include "../zap/luaLevelGenerator.h"
+#include "../zap/robot.h"
 #include "gtest/gtest.h"
 
 namespace Zap
@@ -62,6 +65,108 @@ TEST(RobotTest, luaRobotNew)
 }
 
 
+TEST(RobotTest, tickBudget)
+{
+	GamePair gamePair;
+	Vector<const char *> args;
+
+	for(S32 i = 0; i < 3; i++)
+		gamePair.server->addBot(args, ClientInfo::ClassRobotAddedByAddbots);
+
+	ASSERT_EQ(3, gamePair.server->getBotCount());
+	EventManager::get()->update();      // Activate the bots' TickEvent subscriptions
+
+	// A budget this small lets only one bot think each tick
+	EventManager::setTickBudget(1);
+
+	for(S32 i = 0; i < 90; i++)
+	{
+		EventManager::get()->fireEvent(EventManager::TickEvent, 33);
+
+		S32 deferred = 0;
+		for(S32 j = 0; j < 3; j++)
+			if(gamePair.server->getBot(j)->isThinkDeferred())
+				deferred++;
+
+		EXPECT_EQ(2, deferred);
+	}
+
+	// Each bot got every third tick
+	for(S32 i = 0; i < 3; i++)
+		EXPECT_NEAR(1000.0f / 99, gamePair.server->getBot(i)->getThinkRate(), 0.5f);
+
+	// A bot that stops listening while it waits its turn is no longer waiting
+	Robot *deferredBot = gamePair.server->getBot(0)->isThinkDeferred() ? gamePair.server->getBot(0) : gamePair.server->getBot(1);
+	ASSERT_TRUE(deferredBot->isThinkDeferred());
+	EventManager::get()->unsubscribe(deferredBot, EventManager::TickEvent);
+	EventManager::get()->update();
+	EXPECT_FALSE(deferredBot->isThinkDeferred());
+
+	// With no budget, everyone thinks every tick
+	EventManager::setTickBudget(0);
+	EventManager::get()->fireEvent(EventManager::TickEvent, 33);
+
+	for(S32 i = 0; i < 3; i++)
+		EXPECT_FALSE(gamePair.server->getBot(i)->isThinkDeferred());
+}
+
+
+TEST(RobotTest, perception)
+{
+	GamePair gamePair("", 0);     // No players, so the only ships are the bots
+	Vector<const char *> args;
+
+	for(S32 i = 0; i < 3; i++)
+		gamePair.server->addBot(args, ClientInfo::ClassRobotAddedByAddbots);
+
+	BotPerception *perception = gamePair.server->getBotPerception();
+	perception->invalidate();
+
+	Vector<DatabaseObject *> found;
+	perception->findShips(found);
+	EXPECT_EQ(3, found.size());
+
+	// Asking for players only should filter out the bots
+	Vector<U8> types;
+	types.push_back(PlayerShipTypeNumber);
+	found.clear();
+	perception->findObjects(types, found, *gamePair.server->getWorldExtents());
+	EXPECT_EQ(0, found.size());
+
+	// LOS between two points is shared by both directions, and forgotten at the end of the frame
+	Point a(0, 0), b(100, 50);
+	bool canSee = true;
+
+	EXPECT_FALSE(perception->getCachedLos(a, b, BotPerception::LosWall, canSee));
+	perception->cacheLos(a, b, BotPerception::LosWall, false);
+	EXPECT_TRUE(perception->getCachedLos(b, a, BotPerception::LosWall, canSee));
+	EXPECT_FALSE(canSee);
+	EXPECT_FALSE(perception->getCachedLos(a, b, BotPerception::LosCollideable, canSee));
+
+	perception->invalidate();
+	EXPECT_FALSE(perception->getCachedLos(a, b, BotPerception::LosWall, canSee));
+
+	// Closest enemy is remembered until things move, and follows them once we're told they have
+	Robot *robot = gamePair.server->getBot(0);
+	Ship *near = gamePair.server->getBot(1);
+	Ship *far  = gamePair.server->getBot(2);
+
+	robot->setPos(Point(0, 0));
+	near->setPos(Point(100, 0));
+	far->setPos(Point(300, 0));
+	perception->invalidate();
+
+	EXPECT_EQ(near, perception->findClosestEnemyInScannerRange(robot));
+
+	near->setPos(Point(5000, 0));
+	far->setPos(Point(50, 0));
+	EXPECT_EQ(near, perception->findClosestEnemyInScannerRange(robot));
+
+	perception->invalidate();
+	EXPECT_EQ(far, perception->findClosestEnemyInScannerRange(robot));
+}
+
+
 /** onShipSpawned doesn't fire?
 
 TEST(RobotTest, RemoveFromGameDuringInitialOnShipSpawn)
@@ -6,6 +6,7 @@
 #include "gameType.h"
 #include "ServerGame.h"
 #include "EngineeredItem.h"
+#include "HotStateTable.h"
 
 #include "TestUtils.h"
 
@@ -112,6 +113,74 @@ TEST(ServerGameTest, LittleStory)
 }
 
 
+static void checkHotState(const HotStateTable *hotStates, MoveObject *obj)
+{
+   S32 slot = obj->getHotSlot();
+   ASSERT_NE(-1, slot);
+
+   EXPECT_EQ(obj, hotStates->getObject(slot));
+   EXPECT_EQ(obj->getObjectTypeNumber(), hotStates->getType(slot));
+   EXPECT_EQ(obj->getPos(ActualState), hotStates->getPos(slot));
+   EXPECT_EQ(obj->getVel(ActualState), hotStates->getVel(slot));
+   EXPECT_EQ(obj->getAngle(ActualState), hotStates->getAngle(slot));
+   EXPECT_EQ(obj->getRadius(), hotStates->getRadius(slot));
+   EXPECT_EQ(obj->getTeam(), hotStates->getTeam(slot));
+}
+
+
+// Objects keep their entries in the hot state table current as they move around and change
+TEST(ServerGameTest, HotStateTable)
+{
+   ServerGame *serverGame = newServerGame();
+
+   GameType *gt = new GameType();    // Will be deleted in serverGame destructor
+   gt->addToGame(serverGame, serverGame->getGameObjDatabase());
+   serverGame->unsuspendGame(false);
+
+   const HotStateTable *hotStates = serverGame->getGameObjDatabase()->getHotStateTable();
+
+   SafePtr<Ship> ship = new Ship;
+   ship->addToGame(serverGame, serverGame->getGameObjDatabase());
+
+   ResourceItem *item = new ResourceItem();
+   item->setPos(Point(200, 0));
+   item->setActualVel(Point(50, 20));
+   item->addToGame(serverGame, serverGame->getGameObjDatabase());
+
+   ship->setMove(Move(1, 0.5f));
+
+   for(S32 i = 0; i < 20; i++)
+   {
+      serverGame->idle(10);
+
+      checkHotState(hotStates, ship.getPointer());
+      checkHotState(hotStates, item);
+   }
+
+   ship->setTeam(-1);
+   checkHotState(hotStates, ship.getPointer());
+
+   // Mounted items keep their own position, but are flagged
+   item->mountToShip(ship);
+   EXPECT_TRUE(hotStates->hasFlag(item->getHotSlot(), HotStateTable::MountedFlag));
+   item->dismount(DISMOUNT_NORMAL);
+   EXPECT_FALSE(hotStates->hasFlag(item->getHotSlot(), HotStateTable::MountedFlag));
+   checkHotState(hotStates, item);
+
+   // Slots are given back when objects leave the database, and reused
+   S32 slot = item->getHotSlot();
+   item->removeFromGame(true);
+   EXPECT_EQ(1, hotStates->getLiveCount());
+
+   ResourceItem *item2 = new ResourceItem();
+   item2->addToGame(serverGame, serverGame->getGameObjDatabase());
+   EXPECT_EQ(slot, item2->getHotSlot());
+   checkHotState(hotStates, item2);
+
+   delete serverGame;
+}
+
+
 TEST(ServerGameTest, LoadoutManagementTests)
 {
    ServerGame *serverGame = newServerGame();
@@ -0,0 +1,289 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "SnapshotBuffer.h"
+
+#include "ClientGame.h"
+#include "UIGame.h"
+#include "ServerGame.h"
+#include "GameManager.h"
+#include "gameConnection.h"
+#include "moveObject.h"
+#include "ship.h"
+
+#include "TestUtils.h"
+#include "EventKeyDefs.h"
+
+#include "tnlPlatform.h"
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+
+namespace Zap
+{
+
+TEST(SnapshotBufferTest, interpolate)
+{
+   SnapshotBuffer buffer;
+   Point pos, vel;
+   F32 angle;
+
+   EXPECT_FALSE(buffer.getState(100, pos, vel, angle));
+
+   // Moving steadily right at 100 px/sec
+   buffer.add(1000, Point(0, 0),   Point(100, 0), 0);
+   buffer.add(1100, Point(10, 0),  Point(100, 0), 1);
+   buffer.add(1200, Point(20, 0),  Point(100, 0), 2);
+
+   // Before the first snapshot, we stay put
+   ASSERT_TRUE(buffer.getState(900, pos, vel, angle));
+   EXPECT_EQ(Point(0, 0), pos);
+
+   // On a snapshot, we're right on it
+   buffer.getState(1100, pos, vel, angle);
+   EXPECT_FLOAT_EQ(10, pos.x);
+   EXPECT_FLOAT_EQ(1, angle);
+
+   // Between snapshots, a steady velocity makes for a straight line
+   buffer.getState(1150, pos, vel, angle);
+   EXPECT_FLOAT_EQ(15, pos.x);
+   EXPECT_FLOAT_EQ(0, pos.y);
+   EXPECT_FLOAT_EQ(100, vel.x);
+   EXPECT_FLOAT_EQ(1.5f, angle);
+}
+
+
+// Past the newest snapshot, we carry on along its velocity, but not forever
+TEST(SnapshotBufferTest, extrapolate)
+{
+   SnapshotBuffer buffer;
+   Point pos, vel;
+   F32 angle;
+
+   buffer.add(1000, Point(0, 0), Point(0, 100), 0);
+
+   buffer.getState(1100, pos, vel, angle);
+   EXPECT_FLOAT_EQ(10, pos.y);
+
+   buffer.getState(1000 + SnapshotBuffer::MaxExtrapolationTime * 4, pos, vel, angle);
+   EXPECT_FLOAT_EQ(SnapshotBuffer::MaxExtrapolationTime * 0.1f, pos.y);
+}
+
+
+TEST(SnapshotBufferTest, overflow)
+{
+   SnapshotBuffer buffer;
+   Point pos, vel;
+   F32 angle;
+
+   for(S32 i = 0; i < SnapshotBuffer::MaxSnapshots * 2; i++)
+      buffer.add(i * 100, Point(F32(i), 0), Point(0, 0), 0);
+
+   EXPECT_EQ(SnapshotBuffer::MaxSnapshots, buffer.getCount());
+
+   // Oldest ones are gone, so anything before what's left is clamped to the oldest remaining
+   buffer.getState(0, pos, vel, angle);
+   EXPECT_FLOAT_EQ(F32(SnapshotBuffer::MaxSnapshots), pos.x);
+
+   // Same time again replaces, rather than adds
+   buffer.add((SnapshotBuffer::MaxSnapshots * 2 - 1) * 100, Point(-1, 0), Point(0, 0), 0);
+   EXPECT_EQ(SnapshotBuffer::MaxSnapshots, buffer.getCount());
+   buffer.getState((SnapshotBuffer::MaxSnapshots * 2 - 1) * 100, pos, vel, angle);
+   EXPECT_FLOAT_EQ(-1, pos.x);
+
+   buffer.clear();
+   EXPECT_TRUE(buffer.isEmpty());
+}
+
+
+// Clock wrapping around, and the angle going from just under pi to just over -pi, shouldn't send anything flying
+TEST(SnapshotBufferTest, wrapping)
+{
+   SnapshotBuffer buffer;
+   Point pos, vel;
+   F32 angle;
+
+   U32 time = U32_MAX - 50;
+
+   buffer.add(time,       Point(0, 0),  Point(100, 0),  FloatPi - 0.1f);
+   buffer.add(time + 100, Point(10, 0), Point(100, 0), -FloatPi + 0.1f);
+
+   buffer.getState(time + 50, pos, vel, angle);
+   EXPECT_FLOAT_EQ(5, pos.x);
+   EXPECT_NEAR(FloatPi, angle, 0.001f);
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+static Ship *findOtherShip(ClientGame *clientGame)
+{
+   fillVector.clear();
+   clientGame->getGameObjDatabase()->findObjects(PlayerShipTypeNumber, fillVector);
+
+   for(S32 i = 0; i < fillVector.size(); i++)
+      if(fillVector[i] != clientGame->getLocalPlayerShip())
+         return static_cast<Ship *>(fillVector[i]);
+
+   return NULL;
+}
+
+
+// A copy of a ship that's drawing from its buffer mustn't end up deleting that same buffer
+TEST(SnapshotBufferTest, clone)
+{
+   Ship::setInterpolationDelay(100);
+
+   GamePair gamePair("GameType 10 8\nGridSize 255\nTeam Bluey 0 0 1\nSpawn 0 0 0\n", 2);
+   GamePair::idle(10, 10);    // Let the ships spawn, and a few updates arrive
+
+   Ship *ship = findOtherShip(gamePair.getClient(0));
+   ASSERT_TRUE(ship);
+
+   delete ship->clone();
+
+   // Original's buffer is still there to draw from
+   GamePair::idle(10, 10);
+   EXPECT_EQ(ship, findOtherShip(gamePair.getClient(0)));
+
+   Ship::setInterpolationDelay(0);
+}
+
+
+struct Smoothness
+{
+   F32 bytesPerSecond;
+   F32 jitter;          // Mean change in per-frame velocity, px/sec
+   S32 snaps;           // Frames where the ship jumped further than it could have flown
+};
+
+
+// Watches another ship fly about for a couple of seconds, while it zigzags in the same way each time
+static Smoothness watch(ClientGame *flyer, ClientGame *observer)
+{
+   DEFINE_KEYS_AND_EVENTS(flyer->getSettings());
+
+   GameConnection *connection = observer->getConnectionToServer();
+   U32 startBytes = connection->mPacketRecvBytesTotal;
+   U32 startTime = Platform::getRealMilliseconds();
+
+   Vector<Point> positions;
+   Vector<U32> times;
+
+   Smoothness result;
+   result.jitter = 0;
+   result.snaps = 0;
+
+   S32 velocityChanges = 0;
+   Point lastVel;
+
+   for(S32 leg = 0; leg < 8; leg++)
+   {
+      Event::onEvent(flyer, leg % 2 == 0 ? &EventDownPressed : &EventDownReleased);
+      Event::onEvent(flyer, leg % 4 < 2  ? &EventRightPressed : &EventRightReleased);
+
+      U32 legStart = Platform::getRealMilliseconds();
+
+      while(Platform::getRealMilliseconds() - legStart < 250)
+      {
+         GamePair::idleRealTime(10);
+         U32 now = Platform::getRealMilliseconds();
+
+         Ship *ship = findOtherShip(observer);
+         if(!ship)
+            continue;
+
+         Point pos = ship->getRenderPos();
+
+         if(positions.size() > 0)
+         {
+            F32 dt = getMax(now - times.last(), 1u) * 0.001f;
+            Point vel = (pos - positions.last()) / dt;
+
+            if(pos.distanceTo(positions.last()) > Ship::BoostMaxVelocity * dt + 5)
+               result.snaps++;
+
+            if(positions.size() > 1)
+            {
+               result.jitter += vel.distanceTo(lastVel);
+               velocityChanges++;
+            }
+
+            lastVel = vel;
+         }
+
+         positions.push_back(pos);
+         times.push_back(now);
+      }
+   }
+
+   Event::onEvent(flyer, &EventDownReleased);
+   Event::onEvent(flyer, &EventRightReleased);
+
+   result.bytesPerSecond = (connection->mPacketRecvBytesTotal - startBytes) * 1000.0f /
+                           getMax(Platform::getRealMilliseconds() - startTime, 1u);
+   result.jitter /= getMax(velocityChanges, 1);
+
+   return result;
+}
+
+
+// Slows the server's updates to one client, with some of them going missing, and reports how smooth another ship looks
+// from there, with and without drawing it from the snapshot buffer.  This runs in real time, with random loss, so it
+// takes a while and its numbers vary; run it with --gtest_also_run_disabled_tests.
+TEST(SnapshotBufferTest, DISABLED_bandwidthVersusSmoothness)
+{
+   InputCodeManager::initializeKeyNames();
+
+   GamePair gamePair("GameType 10 8\nGridSize 255\nTeam Bluey 0 0 1\nSpawn 0 0 0\n", 2);
+   ServerGame *serverGame = gamePair.server;
+   ClientGame *observer = gamePair.getClient(0);
+   ClientGame *flyer = gamePair.getClient(1);
+
+   GamePair::idle(10, 10);    // Let the ships spawn
+
+   ASSERT_TRUE(findOtherShip(observer));
+
+   GameConnection *serverConnection = serverGame->findClientInfo("TestPlayer0")->getConnection();
+   serverConnection->useZeroLatencyForTesting(false);
+   serverConnection->setSimulatedNetParams(0.1f, 0);
+   observer->getConnectionToServer()->setConnectionSpeed(2);
+
+   const U32 periods[] = { 20, 50, 100 };
+   F32 bytesPerSecond[ARRAYSIZE(periods)];
+   F32 jitter[ARRAYSIZE(periods)][2];
+
+   for(U32 i = 0; i < ARRAYSIZE(periods); i++)
+   {
+      serverConnection->setConnectionSpeed(2, periods[i]);
+
+      for(S32 j = 0; j < 2; j++)
+      {
+         U32 delay = (j == 0 ? 0 : periods[i] * 2);
+         Ship::setInterpolationDelay(delay);
+
+         GamePair::idleRealTime(250);      // Let the new rate, and the buffer, settle in
+
+         Smoothness result = watch(flyer, observer);
+
+         bytesPerSecond[i] = result.bytesPerSecond;
+         jitter[i][j] = result.jitter;
+
+         printf("[ BENCHMARK] %3d ms between updates, delay %3d ms: %6.0f bytes/sec, jitter %7.1f, %d snaps\n",
+                periods[i], delay, result.bytesPerSecond, result.jitter, result.snaps);
+      }
+   }
+
+   Ship::setInterpolationDelay(0);
+
+   // Fewer updates means fewer bytes, and drawing from the buffer is what keeps that from costing smoothness
+   EXPECT_LT(bytesPerSecond[ARRAYSIZE(periods) - 1], bytesPerSecond[0]);
+   EXPECT_LT(jitter[ARRAYSIZE(periods) - 1][1], jitter[ARRAYSIZE(periods) - 1][0]);
+}
+
+
+};
@@ -0,0 +1,223 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "SparkStore.h"
+#include "sparkManager.h"
+
+#include "Colors.h"
+#include "Point.h"
+
+#include "tnlPlatform.h"
+#include "tnlRandom.h"
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+
+namespace Zap
+{
+
+using namespace UI;
+
+// How sparks used to be kept, and updated, one struct at a time
+struct ReferenceSpark
+{
+   Point pos;
+   Point vel;
+   F32 alpha;
+   S32 ttl;
+};
+
+
+static void idleReference(Vector<ReferenceSpark> &sparks, U32 timeDelta, F32 fadeTime)
+{
+   F32 dTsecs = timeDelta * .001f;
+
+   for(S32 i = 0; i < sparks.size(); )
+   {
+      ReferenceSpark &spark = sparks[i];
+      if(spark.ttl < (S32)timeDelta)
+      {
+         spark = sparks.last();
+         sparks.pop_back();
+      }
+      else
+      {
+         spark.ttl -= timeDelta;
+         spark.pos += spark.vel * dTsecs;
+         spark.alpha = spark.ttl > fadeTime ? 1 : F32(spark.ttl) / fadeTime;
+         i++;
+      }
+   }
+}
+
+
+TEST(SparkStoreTest, idleMatchesReference)
+{
+   SparkStore *store = new SparkStore(SparkTypePoint);
+   Vector<ReferenceSpark> reference;
+
+   // An odd number, so both the wide and the leftover parts of idle() get used
+   for(S32 i = 0; i < 1003; i++)
+   {
+      ReferenceSpark spark;
+      spark.pos = Point(TNL::Random::readF() * 1000, TNL::Random::readF() * 1000);
+      spark.vel = Point(TNL::Random::readF() * 400 - 200, TNL::Random::readF() * 400 - 200);
+      spark.alpha = 1;
+      spark.ttl = TNL::Random::readI(1, 3000);
+
+      reference.push_back(spark);
+      store->setSpark(store->getSlot(), spark.pos, spark.vel, Colors::white, spark.ttl);
+   }
+
+   for(S32 frame = 0; frame < 60; frame++)
+   {
+      U32 timeDelta = 10 + frame % 30;
+
+      store->idle(timeDelta);
+      idleReference(reference, timeDelta, 1000);
+
+      ASSERT_EQ(reference.size(), store->getSparkCount());
+
+      const F32 *positions = store->getPositions();
+      const F32 *colors = store->getColors();
+
+      for(S32 i = 0; i < reference.size(); i++)
+      {
+         ASSERT_EQ(reference[i].ttl, store->getTtl(i));
+         EXPECT_NEAR(reference[i].pos.x, positions[i * 2],     0.01);
+         EXPECT_NEAR(reference[i].pos.y, positions[i * 2 + 1], 0.01);
+         EXPECT_NEAR(reference[i].alpha, colors[i * 4 + 3],    0.0001);
+      }
+   }
+
+   EXPECT_LT(store->getSparkCount(), 1003);
+   EXPECT_GT(store->getSparkCount(), 0);
+
+   delete store;
+}
+
+
+TEST(SparkStoreTest, lineSparks)
+{
+   SparkStore *store = new SparkStore(SparkTypeLine);
+   EXPECT_EQ(SparkStore::MaxVertices / 2, store->getCapacity());
+
+   store->setSpark(store->getSlot(), Point(100, 0), Point(10, 0), Color(1, 1, 1), 100);
+   store->setSpark(store->getSlot(), Point(0, 100), Point(0, 10), Color(1, 1, 1), 500);
+
+   EXPECT_EQ(2, store->getSparkCount());
+   EXPECT_EQ(4, store->getVertexCount());
+
+   // The tail trails behind the head, and is redder
+   const F32 *positions = store->getPositions();
+   const F32 *colors = store->getColors();
+   EXPECT_EQ(80, positions[2]);
+   EXPECT_EQ(0,  positions[3]);
+   EXPECT_EQ(1,     colors[4]);
+   EXPECT_EQ(0.25f, colors[5]);
+
+   // Killing the first spark moves both ends of the second into its place
+   store->idle(200);
+
+   ASSERT_EQ(1, store->getSparkCount());
+   EXPECT_EQ(300, store->getTtl(0));
+   EXPECT_NEAR(0,   positions[0], 0.0001);
+   EXPECT_NEAR(102, positions[1], 0.0001);
+   EXPECT_NEAR(0,   positions[2], 0.0001);
+   EXPECT_NEAR(82,  positions[3], 0.0001);
+
+   store->clear();
+   EXPECT_EQ(0, store->getVertexCount());
+
+   delete store;
+}
+
+
+TEST(SparkStoreTest, fullStore)
+{
+   SparkStore *store = new SparkStore(SparkTypePoint);
+
+   S32 claimed;
+   EXPECT_EQ(0, store->claim(100, claimed));
+   EXPECT_EQ(100, claimed);
+
+   EXPECT_EQ(100, store->claim(SparkStore::MaxVertices, claimed));
+   EXPECT_EQ(SparkStore::MaxVertices - 100, claimed);
+
+   store->claim(1, claimed);
+   EXPECT_EQ(0, claimed);
+
+   // Once we're full, new sparks take the place of old ones
+   for(S32 i = 0; i < 1000; i++)
+   {
+      S32 slot = store->getSlot();
+      EXPECT_TRUE(slot >= 0 && slot < SparkStore::MaxVertices);
+   }
+
+   EXPECT_EQ(SparkStore::MaxVertices, store->getSparkCount());
+
+   delete store;
+}
+
+
+// Simulates a busy game at 60fps, with a steady rate of explosions, and reports how long the sparks take
+static void runExplosionBenchmark(S32 explosionsPerSecond, S32 seconds)
+{
+   static const Color colors[] = { Colors::red, Colors::yellow, Colors::orange50 };
+
+   FxManager *fxManager = new FxManager();
+
+   const U32 frameTime = 16;
+   const S32 frames = seconds * 1000 / frameTime;
+
+   S64 emitTime = 0;
+   S64 idleTime = 0;
+   S32 maxSparks = 0;
+   S32 explosions = 0;
+
+   for(S32 frame = 0; frame < frames; frame++)
+   {
+      S64 start = Platform::getHighPrecisionTimerValue();
+
+      // However many explosions should have happened by the end of this frame
+      while(explosions < (frame + 1) * S32(frameTime) * explosionsPerSecond / 1000)
+      {
+         fxManager->emitExplosion(Point(explosions * 50, 0), 1, colors, ARRAYSIZE(colors));
+         explosions++;
+      }
+
+      S64 mid = Platform::getHighPrecisionTimerValue();
+      fxManager->idle(frameTime);
+      S64 end = Platform::getHighPrecisionTimerValue();
+
+      emitTime += mid - start;
+      idleTime += end - mid;
+
+      maxSparks = max(maxSparks, fxManager->getSparkCount(SparkTypePoint));
+   }
+
+   EXPECT_GT(maxSparks, 0);
+   EXPECT_LE(maxSparks, SparkStore::MaxVertices);
+
+   printf("[ BENCHMARK] %d explosions/sec for %ds: peak %d sparks, emit %.3f ms/frame, idle %.3f ms/frame\n",
+          explosionsPerSecond, seconds, maxSparks,
+          Platform::getHighPrecisionMilliseconds(emitTime) / frames, Platform::getHighPrecisionMilliseconds(idleTime) / frames);
+
+   fxManager->clearSparks();
+   EXPECT_EQ(0, fxManager->getSparkCount(SparkTypePoint));
+
+   delete fxManager;
+}
+
+
+TEST(SparkStoreTest, explosionBenchmark)
+{
+   runExplosionBenchmark(5, 10);      // Light, sparks come and go
+   runExplosionBenchmark(50, 10);     // Heavy, store stays full and old sparks get overwritten
+}
+
+
+};
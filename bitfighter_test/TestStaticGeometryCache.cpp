@@ -0,0 +1,223 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "StaticGeometryCache.h"
+
+#include "barrier.h"
+#include "gameType.h"
+#include "ServerGame.h"
+#include "WallSegmentManager.h"
+
+#include "TestUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace Zap
+{
+
+using namespace std;
+
+static void append(Vector<Point> &points, const Vector<Point> &morePoints)
+{
+   for(S32 i = 0; i < morePoints.size(); i++)
+      points.push_back(morePoints[i]);
+}
+
+
+// Primitives as flat lists of coordinates, sorted, so we can compare geometry without caring what order it's in
+static vector<vector<F32> > getPrimitives(const Vector<Point> &points, S32 pointsPerPrimitive)
+{
+   vector<vector<F32> > primitives;
+
+   for(S32 i = 0; i + pointsPerPrimitive - 1 < points.size(); i += pointsPerPrimitive)
+   {
+      vector<F32> primitive;
+      for(S32 j = 0; j < pointsPerPrimitive; j++)
+      {
+         primitive.push_back(points[i + j].x);
+         primitive.push_back(points[i + j].y);
+      }
+      primitives.push_back(primitive);
+   }
+
+   sort(primitives.begin(), primitives.end());
+   return primitives;
+}
+
+
+static vector<vector<F32> > getCachedLines(const StaticGeometryCache &cache)
+{
+   Vector<Point> points;
+   for(S32 i = 0; i < cache.getCellCount(); i++)
+      append(points, cache.getCell(i).lines);
+
+   return getPrimitives(points, 2);
+}
+
+
+static vector<vector<F32> > getCachedTriangles(const StaticGeometryCache &cache)
+{
+   Vector<Point> points;
+   for(S32 i = 0; i < cache.getCellCount(); i++)
+      append(points, cache.getCell(i).triangles);
+
+   return getPrimitives(points, 3);
+}
+
+
+TEST(StaticGeometryCacheTest, cellsAndCulling)
+{
+   StaticGeometryCache cache(100);
+
+   // A grid of short segments, 1000 units on a side
+   Vector<Point> lines;
+   for(S32 x = 0; x < 1000; x += 50)
+      for(S32 y = 0; y < 1000; y += 50)
+      {
+         lines.push_back(Point(x, y));
+         lines.push_back(Point(x + 70, y + 30));
+      }
+
+   cache.addLines(lines);
+
+   EXPECT_EQ(lines.size(), cache.getLineVertexCount());
+   EXPECT_EQ(100, cache.getCellCount());
+   EXPECT_TRUE(getPrimitives(lines, 2) == getCachedLines(cache));
+
+   // Every segment touching the view must be in one of the cells we get back, and we shouldn't get them all
+   Rect view(Point(220, 220), Point(480, 390));
+
+   Vector<const StaticGeometryCache::Cell *> cells;
+   cache.findVisibleCells(view, cells);
+
+   EXPECT_LT(cells.size(), cache.getCellCount() / 4);
+
+   Vector<Point> visibleLines;
+   for(S32 i = 0; i < cells.size(); i++)
+      append(visibleLines, cells[i]->lines);
+
+   vector<vector<F32> > visible = getPrimitives(visibleLines, 2);
+
+   for(S32 i = 0; i < lines.size(); i += 2)
+   {
+      if(!view.intersectsOrBorders(Rect(lines[i], lines[i + 1])))
+         continue;
+
+      Vector<Point> segment;
+      segment.push_back(lines[i]);
+      segment.push_back(lines[i + 1]);
+
+      EXPECT_TRUE(binary_search(visible.begin(), visible.end(), getPrimitives(segment, 2)[0]));
+   }
+
+   // Fans become triangles, all in one cell
+   Vector<Point> fan;
+   fan.push_back(Point(5000, 5000));
+   fan.push_back(Point(5100, 5000));
+   fan.push_back(Point(5100, 5100));
+   fan.push_back(Point(5000, 5100));
+
+   cache.addTriangleFan(fan);
+   EXPECT_EQ(6, cache.getTriangleVertexCount());
+   EXPECT_EQ(101, cache.getCellCount());
+
+   cache.clear();
+   EXPECT_TRUE(cache.isEmpty());
+   EXPECT_EQ(0, cache.getLineVertexCount());
+}
+
+
+static const char *wallLevel =
+      "GameType 10 8\n"
+      "GridSize 255\n"
+      "Team Bluey 0 0 1\n"
+      "BarrierMaker 40 0 0 10 0 10 10\n"
+      "BarrierMaker 60 5 -5 5 5\n"
+      "BarrierMaker 20 20 20 30 25 20 30\n"
+      "PolyWall -10 -10 -5 -10 -5 -5 -10 -5\n";
+
+
+// What the game draws each frame, and what it draws from the cache, should be the same lines
+TEST(StaticGeometryCacheTest, barrierEdges)
+{
+   ServerGame *game = newServerGame();
+   game->loadLevelFromString(wallLevel, game->getGameObjDatabase());
+
+   Barrier::prepareRenderingGeometry(game);
+
+   EXPECT_TRUE(Barrier::mRenderLineSegments.size() > 0);
+   EXPECT_EQ(Barrier::mRenderLineSegments.size(), Barrier::mRenderEdgeCache.getLineVertexCount());
+   EXPECT_TRUE(getPrimitives(Barrier::mRenderLineSegments, 2) == getCachedLines(Barrier::mRenderEdgeCache));
+   EXPECT_TRUE(Barrier::mRenderEdgeCache.getCellCount() > 1);
+
+   Barrier::clearRenderItems();
+   EXPECT_TRUE(Barrier::mRenderEdgeCache.isEmpty());
+
+   delete game;
+}
+
+
+// The editor's cache should hold the same edges and fills it used to draw directly, and keep up with changes
+TEST(StaticGeometryCacheTest, wallSegmentManager)
+{
+   GridDatabase database;
+   WallSegmentManager *wsm = database.getWallSegmentManager();
+
+   Vector<WallItem *> walls;
+   for(S32 i = 0; i < 3; i++)
+   {
+      WallItem *wall = new WallItem();
+      wall->assignNewSerialNumber();
+      wall->addVert(Point(i * 1000, 0));
+      wall->addVert(Point(i * 1000 + 800, 0));
+      wall->addVert(Point(i * 1000 + 800, 600));
+      wall->addToDatabase(&database);
+      wall->onGeomChanged();
+
+      walls.push_back(wall);
+   }
+
+   // The fills every segment would have drawn
+   Vector<Point> fills;
+   GridDatabase *segments = wsm->getWallSegmentDatabase();
+   for(S32 i = 0; i < segments->getObjectCount(); i++)
+      append(fills, *static_cast<WallSegment *>(segments->getObjectByIndex(i))->getTriangulatedFillPoints());
+
+   ASSERT_TRUE(fills.size() > 0);
+
+   const StaticGeometryCache &cache = wsm->getRenderCache();
+   EXPECT_TRUE(getPrimitives(*wsm->getWallEdgePoints(), 2) == getCachedLines(cache));
+   EXPECT_TRUE(getPrimitives(fills, 3) == getCachedTriangles(cache));
+
+   // Selected walls are drawn separately, so their fills come out of the cache
+   wsm->setSelected(walls[1]->getSerialNumber(), true);
+
+   Vector<Point> unselectedFills;
+   for(S32 i = 0; i < segments->getObjectCount(); i++)
+   {
+      WallSegment *segment = static_cast<WallSegment *>(segments->getObjectByIndex(i));
+      if(!segment->isSelected())
+         append(unselectedFills, *segment->getTriangulatedFillPoints());
+   }
+
+   EXPECT_LT(unselectedFills.size(), fills.size());
+   EXPECT_TRUE(getPrimitives(unselectedFills, 3) == getCachedTriangles(wsm->getRenderCache()));
+
+   // Moving a wall rebuilds its edges
+   wsm->clearSelected();
+   walls[2]->setVert(Point(2000, 5000), 0);
+   walls[2]->onGeomChanged();
+
+   EXPECT_TRUE(getPrimitives(*wsm->getWallEdgePoints(), 2) == getCachedLines(wsm->getRenderCache()));
+
+   wsm->clear();
+   EXPECT_TRUE(wsm->getRenderCache().isEmpty());
+}
+
+
+};
@@ -15,6 +15,8 @@
 #include "../zap/stringUtils.h"
 #include "gtest/gtest.h"
 
+#include "tnlPlatform.h"
+
 #include <string>
 
 using namespace std;
@@ -135,6 +137,23 @@ void GamePair::idle(U32 timeDelta, U32 cycles)
 }
 
 
+// Idles the games in real time, as that's what TNL's simulated loss and latency run on
+void GamePair::idleRealTime(U32 milliseconds)
+{
+   U32 start = Platform::getRealMilliseconds();
+   U32 last = start;
+
+   while(Platform::getRealMilliseconds() - start < milliseconds)
+   {
+      Platform::sleep(5);
+
+      U32 now = Platform::getRealMilliseconds();
+      idle(now - last);
+      last = now;
+   }
+}
+
+
 // Simulates player joining game from new client
 void GamePair::addClient(const string &name, S32 team)
 {
@@ -7,10 +7,10 @@
 #define _TEST_UTILS_H
 
 #include "GameSettings.h"    // For GameSettingsPtr def
+#include "gameConnection.h"
 #include "TeamConstants.h"
 
 #include <tnl.h>
-#include <tnlGhostConnection.h>
 
 #include <string>
 
@@ -33,7 +33,7 @@ template <class T>
 void packUnpack(T input, T &output, U32 mask = 0xFFFFFFFF)
 {
    BitStream stream;       
-   GhostConnection conn;
+   GameConnection conn;       // Objects' packUpdate may treat the connection as a GameConnection
    
    output.markAsGhost(); 
 
@@ -57,6 +57,7 @@ struct GamePair
 
 
 	static void idle(U32 timeDelta, U32 cycles = 1);
+   static void idleRealTime(U32 milliseconds);     // For when TNL's simulated loss or latency is in play
 	ServerGame *server;
 
    void addClient(const string &name, S32 team = NO_TEAM);
@@ -10,6 +10,8 @@
 #include "tnlThread.h"
 #include "tnlLog.h"
 
+#include <deque>
+
 namespace Master
 {
 
@@ -22,95 +24,330 @@ public:
    virtual void finish() {};  // finishes the entry on primary thread after "run()" is done to avoid 2 threads crashing in to the same network TNL and others.
 };
 
-class DatabaseAccessThread : public TNL::Thread
+
+// A pool of worker threads pulling entries off a set of priority lanes.  Workers sleep on a semaphore until
+// there is work, always take from the highest priority lane that has something in it, and hand finished entries
+// back to the main thread, which calls finish() on them from idle().  Entries on the bulk lane are run one at a
+// time, so long runs of writes don't tie up every worker, and stay in the order they were queued.
+//
+// Nothing is ever dropped; if a lane backs up past its soft limit we log it, and the queue depth and wait time
+// of each lane are tracked so the owner can keep an eye on how far behind we are.
+class DatabaseAccessThread
 {
+public:
+   enum Priority {
+      HighPriority,        // Someone is waiting on this, e.g. logging in
+      NormalPriority,      // Lookups
+      BulkPriority,        // Writes nobody is waiting for
+      PriorityCount
+   };
+
+   struct LaneStats
+   {
+      U32 queued;          // Entries waiting right now
+      U32 peakQueued;
+      U32 processed;
+      U32 totalWaitMs;     // Time between being queued and starting to run, summed over processed entries
+      U32 maxWaitMs;
+      U32 overloads;       // Times the lane went over its soft limit
+
+      U32 getAverageWaitMs() const { return processed == 0 ? 0 : totalWaitMs / processed; }
+   };
+
 private:
-   U32 mEntryStart;
-   U32 mEntryThread;
-   U32 mEntryEnd;
+   struct QueuedEntry
+   {
+      RefPtr<ThreadEntry> entry;
+      U32 queueTime;
+   };
+
+   class Worker : public TNL::Thread
+   {
+      DatabaseAccessThread *mOwner;
+   public:
+      Worker(DatabaseAccessThread *owner) { mOwner = owner; }
+      U32 run() { mOwner->workerLoop(); return 0; }
+   };
+
+   static const U32 LaneSoftLimit = 128;
+
+   std::deque<QueuedEntry> mLanes[PriorityCount];
+   LaneStats mLaneStats[PriorityCount];
+   bool mLaneOverloaded[PriorityCount];
+   bool mBulkEntryRunning;
+
+   Vector<RefPtr<ThreadEntry> > mFinishedEntries;
 
+   Mutex mMutex;              // Protects everything above
+   Semaphore mWorkAvailable;  // One count per queued entry, plus one per worker when shutting down
+
+   Vector<Worker *> mWorkers;
+   S32 mWorkerCount;
+   S32 mRunningWorkers;
+   S32 mBusyWorkers;
    bool mRunning;
-   bool mThreadActive;
 
-   static const U32 mEntrySize = 128;
+   void (*mOutOfWorkCallback)();    // Runs on a worker each time the queue empties out
+
+   // Returns false if there was nothing we could run; called with mMutex held
+   bool takeNextEntry(QueuedEntry &queuedEntry, S32 &lane)
+   {
+      for(lane = 0; lane < PriorityCount; lane++)
+      {
+         if(mLanes[lane].empty() || (lane == BulkPriority && mBulkEntryRunning))
+            continue;
+
+         queuedEntry = mLanes[lane].front();
+         mLanes[lane].pop_front();
+
+         LaneStats &stats = mLaneStats[lane];
+         U32 waitMs = Platform::getRealMilliseconds() - queuedEntry.queueTime;
+
+         stats.queued--;
+         stats.processed++;
+         stats.totalWaitMs += waitMs;
+         stats.maxWaitMs = getMax(stats.maxWaitMs, waitMs);
+
+         if(stats.queued < LaneSoftLimit / 2)
+            mLaneOverloaded[lane] = false;
+
+         if(lane == BulkPriority)
+            mBulkEntryRunning = true;
+
+         return true;
+      }
+
+      return false;
+   }
+
+
+   void workerLoop()
+   {
+      while(true)
+      {
+         mWorkAvailable.wait();
+
+         mMutex.lock();
+
+         if(!mRunning)
+         {
+            mRunningWorkers--;
+            mMutex.unlock();
+            return;
+         }
+
+         QueuedEntry queuedEntry;
+         S32 lane;
+
+         // If the only thing queued is bulk work another worker is already on, leave it to that worker, which
+         // will signal again when it's done
+         if(!takeNextEntry(queuedEntry, lane))
+         {
+            mMutex.unlock();
+            continue;
+         }
+
+         mBusyWorkers++;
+         mMutex.unlock();
+
+         queuedEntry.entry->run();
+
+         mMutex.lock();
+
+         mFinishedEntries.push_back(queuedEntry.entry);
+         mBusyWorkers--;
+
+         bool outOfWork = (mBusyWorkers == 0);
+         for(S32 i = 0; i < PriorityCount; i++)
+            if(!mLanes[i].empty())
+               outOfWork = false;
+
+         if(lane == BulkPriority)
+         {
+            mBulkEntryRunning = false;
+
+            if(!mLanes[BulkPriority].empty())
+               mWorkAvailable.increment();      // Make up for any signal skipped while we were busy
+         }
+
+         mMutex.unlock();
+
+         if(outOfWork && mOutOfWorkCallback)
+            mOutOfWorkCallback();
+      }
+   }
 
-   RefPtr<ThreadEntry> mEntry[mEntrySize];
+
+   void startWorkers()
+   {
+      for(S32 i = 0; i < mWorkerCount; i++)
+      {
+         Worker *worker = new Worker(this);     // Deleted in destructor
+         mWorkers.push_back(worker);
+
+         mRunningWorkers++;
+         if(!worker->start())
+         {
+            logprintf(LogConsumer::LogError, "Could not start database worker thread!");
+            mRunningWorkers--;
+         }
+      }
+   }
 
 public:
-   DatabaseAccessThread() // Constructor
+   explicit DatabaseAccessThread(S32 workerCount = 1) : mWorkAvailable(0, S32_MAX) // Constructor
    {
-      mEntryStart = 0;
-      mEntryThread = 0;
-      mEntryEnd = 0;
+      for(S32 i = 0; i < PriorityCount; i++)
+      {
+         mLaneStats[i] = LaneStats();
+         mLaneOverloaded[i] = false;
+      }
 
+      mBulkEntryRunning = false;
+
+      mWorkerCount = getMax(workerCount, 1);
+      mRunningWorkers = 0;
+      mBusyWorkers = 0;
       mRunning = true;
-      mThreadActive = false;
+
+      mOutOfWorkCallback = NULL;
    }
 
 
-   void addEntry(ThreadEntry *entry)
+   // Lets the owner finish off anything it deferred while the workers were busy, e.g. batched database writes
+   void setOutOfWorkCallback(void (*callback)())
    {
-      U32 entryEnd = mEntryEnd + 1;
+      mOutOfWorkCallback = callback;
+   }
 
-      if(entryEnd >= mEntrySize)
-         entryEnd = 0;
 
-      if(entryEnd == mEntryStart)      // Too many entries
+   void addEntry(ThreadEntry *entry, Priority priority = NormalPriority)
+   {
+      QueuedEntry queuedEntry;
+      queuedEntry.entry = entry;
+      queuedEntry.queueTime = Platform::getRealMilliseconds();
+
+      mMutex.lock();
+
+      if(!mRunning)
       {
-         logprintf(LogConsumer::LogError, "Database thread overloaded - database access too slow?");
+         mMutex.unlock();
          return;
       }
 
-      mEntry[mEntryEnd] = entry;
-      mEntryEnd = entryEnd;
-      if(!mThreadActive)
+      // Workers are only started once there's something for them to do
+      if(mWorkers.size() == 0)
+         startWorkers();
+
+      mLanes[priority].push_back(queuedEntry);
+
+      LaneStats &stats = mLaneStats[priority];
+      stats.queued++;
+      stats.peakQueued = getMax(stats.peakQueued, stats.queued);
+
+      U32 queued = stats.queued;
+      bool overloaded = (queued > LaneSoftLimit && !mLaneOverloaded[priority]);
+      if(overloaded)
       {
-         mThreadActive = true;
-         start();
+         mLaneOverloaded[priority] = true;
+         stats.overloads++;
       }
+
+      mMutex.unlock();
+
+      mWorkAvailable.increment();
+
+      if(overloaded)
+         logprintf(LogConsumer::LogError, "Database queue backing up - %d entries waiting in lane %d; database access too slow?",
+                   queued, priority);
+   }
+
+
+   // Called periodically from the main thread
+   void idle()
+   {
+      Vector<RefPtr<ThreadEntry> > finishedEntries;
+
+      mMutex.lock();
+      finishedEntries.getStlVector().swap(mFinishedEntries.getStlVector());
+      mMutex.unlock();
+
+      for(S32 i = 0; i < finishedEntries.size(); i++)
+         finishedEntries[i]->finish();
    }
 
 
-   U32 run()
+   LaneStats getLaneStats(Priority priority)
    {
-      mThreadActive = true;
-      while(mRunning)
+      mMutex.lock();
+      LaneStats stats = mLaneStats[priority];
+      mMutex.unlock();
+
+      return stats;
+   }
+
+
+   // Clears everything but the current queue depth
+   void resetStats()
+   {
+      mMutex.lock();
+
+      for(S32 i = 0; i < PriorityCount; i++)
       {
-         if(mEntryThread != mEntryEnd)
-         {
-            mEntry[mEntryThread]->run();
-            mEntryThread++;
-            if(mEntryThread >= mEntrySize)
-               mEntryThread = 0;
-         }
-         else
-            Platform::sleep(50);
+         U32 queued = mLaneStats[i].queued;
+         mLaneStats[i] = LaneStats();
+         mLaneStats[i].queued = queued;
+         mLaneStats[i].peakQueued = queued;
       }
 
-      mThreadActive = false;
-
-      return 0;
+      mMutex.unlock();
    }
 
 
-   void idle()
+   void logStats()
    {
-      while(mEntryStart != mEntryThread)
+      static const char *laneNames[PriorityCount] = { "high", "normal", "bulk" };
+
+      for(S32 i = 0; i < PriorityCount; i++)
       {
-         mEntry[mEntryStart]->finish();
-         mEntry[mEntryStart].set(NULL);  // RefPtr, we can just set to NULL and it will delete itself
-         mEntryStart++;
+         LaneStats stats = getLaneStats(Priority(i));
+
+         if(stats.processed == 0 && stats.queued == 0)
+            continue;
 
-         if(mEntryStart >= mEntrySize)
-            mEntryStart = 0;
+         logprintf(LogConsumer::LogConnectionManager, "Database %s lane: %d processed, %d waiting (peak %d), wait avg %dms max %dms, %d overloads",
+                   laneNames[i], stats.processed, stats.queued, stats.peakQueued, stats.getAverageWaitMs(), stats.maxWaitMs, stats.overloads);
       }
    }
 
+
+   // Waits for the workers to finish what they're running; anything still queued is abandoned
    void terminate()
    {
+      mMutex.lock();
+      bool wasRunning = mRunning;
       mRunning = false;
-      while(mThreadActive)
-         Platform::sleep(50);
+      mMutex.unlock();
+
+      if(wasRunning)
+         mWorkAvailable.increment(mWorkers.size());
+
+      while(true)
+      {
+         mMutex.lock();
+         S32 runningWorkers = mRunningWorkers;
+         mMutex.unlock();
+
+         if(runningWorkers == 0)
+            break;
+
+         Platform::sleep(10);
+      }
+
+      for(S32 i = 0; i < mWorkers.size(); i++)
+         delete mWorkers[i];
+
+      mWorkers.clear();
    }
 
    ~DatabaseAccessThread()
@@ -123,4 +360,4 @@ public:
 
 }
 
-#endif
\ No newline at end of file
+#endif
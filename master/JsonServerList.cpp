@@ -0,0 +1,248 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "JsonServerList.h"
+
+#include "../zap/stringUtils.h"     // For sanitizeForJson, itos
+
+#include <stdio.h>
+
+using namespace Zap;
+
+namespace Master
+{
+
+// Constructor
+JsonServerList::JsonServerList()
+{
+   mDocumentDirty = true;
+   mUnwritten = true;
+}
+
+
+S32 JsonServerList::findServer(const void *key) const
+{
+   for(S32 i = 0; i < mServers.size(); i++)
+      if(mServers[i].key == key)
+         return i;
+
+   return -1;
+}
+
+
+S32 JsonServerList::findPlayer(const void *key) const
+{
+   for(S32 i = 0; i < mPlayers.size(); i++)
+      if(mPlayers[i].key == key)
+         return i;
+
+   return -1;
+}
+
+
+void JsonServerList::markDirty()
+{
+   mDocumentDirty = true;
+   mUnwritten = true;
+}
+
+
+void JsonServerList::updateServer(const void *key, const string &name, S32 protocolVersion, const string &levelName, 
+                                  const string &levelType, S32 playerCount)
+{
+   string json = "\n\t\t{\n\t\t\t\"serverName\": \"" + sanitizeForJson(name.c_str()) + "\",\n"
+                 "\t\t\t\"protocolVersion\": "       + itos(protocolVersion) + ",\n"
+                 "\t\t\t\"currentLevelName\": \""    + sanitizeForJson(levelName.c_str()) + "\",\n"
+                 "\t\t\t\"currentLevelType\": \""    + sanitizeForJson(levelType.c_str()) + "\",\n"
+                 "\t\t\t\"playerCount\": "           + itos(playerCount) + "\n\t\t}";
+
+   S32 index = findServer(key);
+
+   if(index == -1)
+   {
+      ServerEntry entry;
+      entry.key = key;
+      mServers.push_back(entry);
+      index = mServers.size() - 1;
+   }
+   else if(mServers[index].json == json)
+      return;        // Nothing we publish has changed
+
+   mServers[index].json = json;
+   mServers[index].playerCount = playerCount;
+
+   markDirty();
+}
+
+
+void JsonServerList::removeServer(const void *key)
+{
+   S32 index = findServer(key);
+
+   if(index == -1)
+      return;
+
+   mServers.erase(index);     // Not erase_fast, keep servers in the order they joined
+   markDirty();
+}
+
+
+void JsonServerList::updatePlayer(const void *key, const string &name, bool authenticated)
+{
+   string nameJson = "\"" + sanitizeForJson(name.c_str()) + "\"";
+
+   S32 index = findPlayer(key);
+
+   if(index == -1)
+   {
+      PlayerEntry entry;
+      entry.key = key;
+      mPlayers.push_back(entry);
+      index = mPlayers.size() - 1;
+   }
+   else if(mPlayers[index].nameJson == nameJson && mPlayers[index].authenticated == authenticated)
+      return;
+
+   mPlayers[index].nameJson = nameJson;
+   mPlayers[index].authenticated = authenticated;
+
+   markDirty();
+}
+
+
+void JsonServerList::removePlayer(const void *key)
+{
+   S32 index = findPlayer(key);
+
+   if(index == -1)
+      return;
+
+   mPlayers.erase(index);
+   markDirty();
+}
+
+
+void JsonServerList::setMotd(const string &motd)
+{
+   string motdJson = sanitizeForJson(motd.c_str());
+
+   if(motdJson == mMotd)
+      return;
+
+   mMotd = motdJson;
+   markDirty();
+}
+
+
+S32 JsonServerList::getServerCount() const
+{
+   return mServers.size();
+}
+
+
+S32 JsonServerList::getPlayerCount() const
+{
+   S32 playerCount = 0;
+
+   for(S32 i = 0; i < mServers.size(); i++)
+      playerCount += mServers[i].playerCount;
+
+   return playerCount;
+}
+
+
+// See MasterServerConnection::writeClientServerList_JSON() for what this looks like
+void JsonServerList::rebuildDocument()
+{
+   string::size_type size = 128 + mMotd.length();
+
+   for(S32 i = 0; i < mServers.size(); i++)
+      size += mServers[i].json.length() + 2;
+
+   for(S32 i = 0; i < mPlayers.size(); i++)
+      size += mPlayers[i].nameJson.length() + 9;
+
+   mDocument.clear();
+   mDocument.reserve(size);
+
+   // First the servers
+   mDocument += "{\n\t\"servers\": [";
+
+   for(S32 i = 0; i < mServers.size(); i++)
+   {
+      if(i > 0)
+         mDocument += ", ";
+      mDocument += mServers[i].json;
+   }
+
+   // Next the player names      // "players": [ "chris", "colin", "fred", "george", "Peter99" ],
+   mDocument += "\n\t],\n\t\"players\": [";
+
+   for(S32 i = 0; i < mPlayers.size(); i++)
+   {
+      if(i > 0)
+         mDocument += ", ";
+      mDocument += mPlayers[i].nameJson;
+   }
+
+   // Authentication status      // "authenticated": [ true, false, false, true, true ],
+   mDocument += "],\n\t\"authenticated\": [";
+
+   for(S32 i = 0; i < mPlayers.size(); i++)
+   {
+      if(i > 0)
+         mDocument += ", ";
+      mDocument += mPlayers[i].authenticated ? "true" : "false";
+   }
+
+   // Finally, the player and server counts, and the message-of-the-day
+   mDocument += "],\n\t\"serverCount\": " + itos(getServerCount()) + ",\n\t\"playerCount\": " + itos(getPlayerCount()) + ",\n";
+   mDocument += "\t\"motd\": \"" + mMotd + "\"\n}\n";
+
+   mDocumentDirty = false;
+}
+
+
+const string &JsonServerList::getDocument()
+{
+   if(mDocumentDirty)
+      rebuildDocument();
+
+   return mDocument;
+}
+
+
+// Write to a temp file and rename it over the old one, so anyone reading the file never sees half of it
+bool JsonServerList::writeFile(const string &filename)
+{
+   if(!mUnwritten)
+      return true;
+
+   const string &document = getDocument();
+   string tempFilename = filename + ".tmp";
+
+   FILE *f = fopen(tempFilename.c_str(), "wb");
+   if(!f)
+      return false;
+
+   bool ok = fwrite(document.c_str(), 1, document.length(), f) == document.length();
+   ok = (fclose(f) == 0) && ok;
+
+#ifdef TNL_OS_WIN32
+   if(ok)
+      remove(filename.c_str());     // Windows won't rename over an existing file
+#endif
+
+   if(!ok || rename(tempFilename.c_str(), filename.c_str()) != 0)
+   {
+      remove(tempFilename.c_str());
+      return false;
+   }
+
+   mUnwritten = false;
+   return true;
+}
+
+}
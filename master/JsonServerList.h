@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _JSON_SERVER_LIST_H_
+#define _JSON_SERVER_LIST_H_
+
+#include "tnlVector.h"
+
+#include <string>
+
+using namespace TNL;
+using namespace std;
+
+namespace Master
+{
+
+// The list of servers and players we publish for the website, in JSON form.  Each server and player is
+// serialized once, when it joins or something about it changes, and the full document is only reassembled
+// from those pieces when one of them has changed since it was last built.  Entries are keyed by whatever
+// pointer the caller likes to identify them with; the master uses the connection.
+class JsonServerList
+{
+private:
+   struct ServerEntry
+   {
+      const void *key;
+      string json;
+      S32 playerCount;
+   };
+
+   struct PlayerEntry
+   {
+      const void *key;
+      string nameJson;     // Quoted and escaped
+      bool authenticated;
+   };
+
+   Vector<ServerEntry> mServers;
+   Vector<PlayerEntry> mPlayers;
+   string mMotd;
+
+   string mDocument;
+   bool mDocumentDirty;    // Need to rebuild mDocument
+   bool mUnwritten;        // mDocument has changed since we last wrote it out
+
+   S32 findServer(const void *key) const;
+   S32 findPlayer(const void *key) const;
+   void markDirty();
+   void rebuildDocument();
+
+public:
+   JsonServerList();       // Constructor
+
+   void updateServer(const void *key, const string &name, S32 protocolVersion, const string &levelName, 
+                     const string &levelType, S32 playerCount);
+   void removeServer(const void *key);
+
+   void updatePlayer(const void *key, const string &name, bool authenticated);
+   void removePlayer(const void *key);
+
+   void setMotd(const string &motd);
+
+   S32 getServerCount() const;
+   S32 getPlayerCount() const;      // Sum of players reported by the servers, not the number of players listed
+
+   const string &getDocument();
+   bool writeFile(const string &filename);      // Only touches the disk if something has changed
+};
+
+}
+
+#endif
@@ -221,7 +221,7 @@ MasterServerConnection::PHPBB3AuthenticationStatus MasterServerConnection::check
    auth->playerName = mPlayerOrServerName.getString();
    strncpy(auth->password, password, sizeof(auth->password));
    auth->stat = UnknownStatus;
-   mMaster->getDatabaseAccessThread()->addEntry(auth);
+   mMaster->getDatabaseAccessThread()->addEntry(auth, DatabaseAccessThread::HighPriority);
 
    if(doNotDelay)  // Wait up to 1000 milliseconds so we can return some value, for clients version 017 and older
    {
@@ -259,7 +259,6 @@ void MasterServerConnection::processAutentication(StringTableEntry newName, PHPB
       mIsIgnoredFromList = false;   // Just for authenticating
       logprintf(LogConsumer::LogConnection, "Authenticated user %s", mPlayerOrServerName.getString());
       mAuthenticated = true;
-      mMaster->writeJsonNow();      // Make sure JSON shows authenticated state
       GameJolt::onPlayerAuthenticated(mMaster->getSettings(), this);
 
       if(mPlayerOrServerName != newName)
@@ -282,6 +281,9 @@ void MasterServerConnection::processAutentication(StringTableEntry newName, PHPB
          mPlayerOrServerName = newName;
       }
 
+      updateJsonEntry();
+      mMaster->writeJsonNow();      // Make sure JSON shows authenticated state
+
       mBadges = badges;
       mGamesPlayed = gamesPlayed;
 
@@ -499,8 +501,30 @@ static bool listClient(MasterServerConnection *client)
 }
 
 
-// Write a current count of clients/servers for display on a website, using JSON format
-// This gets updated whenever we gain or lose a server, at most every 5 seconds (currently)
+void MasterServerConnection::updateJsonEntry()
+{
+   JsonServerList *jsonServerList = mMaster->getJsonServerList();
+
+   if(mConnectionType == MasterConnectionTypeServer)
+   {
+      if(!mIsIgnoredFromList && mMaster->getServerList()->contains(this))
+         jsonServerList->updateServer(this, mPlayerOrServerName.getString(), mCSProtocolVersion, mLevelName.getString(), 
+                                      mLevelType.getString(), mPlayerCount);
+      else
+         jsonServerList->removeServer(this);
+   }
+   else if(mConnectionType == MasterConnectionTypeClient)
+   {
+      if(listClient(this) && mMaster->getClientList()->contains(this))
+         jsonServerList->updatePlayer(this, mPlayerOrServerName.getString(), mAuthenticated);
+      else
+         jsonServerList->removePlayer(this);
+   }
+}
+
+
+// Write a current count of clients/servers for display on a website, using JSON format.  The list itself is kept
+// up to date as servers and players come and go (see updateJsonEntry()), so all we do here is write it out.
 void MasterServerConnection::writeClientServerList_JSON()
 {
    string jsonfile = mMaster->getSetting<string>("JsonOutfile");
@@ -509,71 +533,10 @@ void MasterServerConnection::writeClientServerList_JSON()
    if(jsonfile == "")
       return;
 
-   bool first = true;
-   S32 playerCount = 0;
-   S32 serverCount = 0;
-
-   FILE *f = fopen(jsonfile.c_str(), "w");
-   if(f)
-   {
-      // First the servers
-      fprintf(f, "{\n\t\"servers\": [");
+   JsonServerList *jsonServerList = mMaster->getJsonServerList();
+   jsonServerList->setMotd(mMaster->getSettings()->getMotd());
 
-      const Vector<MasterServerConnection *> *serverList = mMaster->getServerList();
-
-      for(S32 i = 0; i < serverList->size(); i++)
-      {
-         MasterServerConnection *server = serverList->get(i);
-
-         if(server->mIsIgnoredFromList)
-            continue;
-
-         fprintf(f, "%s\n\t\t{\n\t\t\t\"serverName\": \"%s\",\n\t\t\t\"protocolVersion\": %d,\n\t\t\t\"currentLevelName\": \"%s\",\n\t\t\t\"currentLevelType\": \"%s\",\n\t\t\t\"playerCount\": %d\n\t\t}",
-                     first ? "" : ", ", sanitizeForJson(server->mPlayerOrServerName.getString()).c_str(),
-                     server->mCSProtocolVersion, server->mLevelName.getString(), server->mLevelType.getString(), server->mPlayerCount);
-         playerCount += server->mPlayerCount;
-         serverCount++;
-         first = false;
-      }
-
-      // Next the player names      // "players": [ "chris", "colin", "fred", "george", "Peter99" ],
-      fprintf(f, "\n\t],\n\t\"players\": [");
-      first = true;
-
-      const Vector<MasterServerConnection *> *clientList = mMaster->getClientList();
-
-      for(S32 i = 0; i < clientList->size(); i++)
-      {
-         if(listClient(clientList->get(i)))
-         {
-            fprintf(f, "%s\"%s\"", first ? "" : ", ", sanitizeForJson(clientList->get(i)->mPlayerOrServerName.getString()).c_str());
-            first = false;
-         }
-      }
-
-      // Authentication status      // "authenticated": [ true, false, false, true, true ],
-      fprintf(f, "],\n\t\"authenticated\": [");
-      first = true;
-
-      for(S32 i = 0; i < clientList->size(); i++)
-      {
-         if(listClient(clientList->get(i)))
-         {
-            fprintf(f, "%s%s", first ? "" : ", ", clientList->get(i)->mAuthenticated ? "true" : "false");
-            first = false;
-         }
-      }
-
-      // Finally, the player and server counts
-      fprintf(f, "],\n\t\"serverCount\": %d,\n\t\"playerCount\": %d,\n", serverCount, playerCount);
-
-      // And the message-of-the-day
-      fprintf(f, "\t\"motd\": \"%s\"\n}\n", sanitizeForJson(mMaster->getSettings()->getMotd().c_str()).c_str());
-
-      fflush(f);
-      fclose(f);
-   }
-   else
+   if(!jsonServerList->writeFile(jsonfile))
       logprintf(LogConsumer::LogError, "Could not write to JSON file \"%s\"", jsonfile.c_str());
 }
 
@@ -749,6 +712,7 @@ TNL_IMPLEMENT_RPC_OVERRIDE(MasterServerConnection, s2mUpdateServerStatus, (Strin
       // Check to ensure we're not getting flooded with these requests
       checkActivityTime(FOUR_SECONDS);
 
+      updateJsonEntry();
       mMaster->writeJsonNow();
    }
 }
@@ -825,7 +789,7 @@ void MasterServerConnection::writeStatisticsToDb(VersionedGameStats &stats)
 
    RefPtr<AddGameReport> gameReport = new AddGameReport(mMaster->getSettings());
    gameReport->mStats = *gameStats;  // copy so we keep data during a thread
-   mMaster->getDatabaseAccessThread()->addEntry(gameReport);
+   mMaster->getDatabaseAccessThread()->addEntry(gameReport, DatabaseAccessThread::BulkPriority);
 }
 
    
@@ -861,7 +825,7 @@ void MasterServerConnection::writeAchievementToDb(U8 achievementId, const String
    a_writer->playerNick = playerNick;
    a_writer->mPlayerOrServerName = mPlayerOrServerName;
    a_writer->addressString = getNetAddressString();
-   mMaster->getDatabaseAccessThread()->addEntry(a_writer);
+   mMaster->getDatabaseAccessThread()->addEntry(a_writer, DatabaseAccessThread::BulkPriority);
 }
 
 
@@ -907,7 +871,7 @@ void MasterServerConnection::writeLevelInfoToDb(const string &hash, const string
    l_writer->teamCount = teamCount;
    l_writer->winningScore = winningScore;
    l_writer->gameDurationInSeconds = gameDurationInSeconds;
-   mMaster->getDatabaseAccessThread()->addEntry(l_writer);
+   mMaster->getDatabaseAccessThread()->addEntry(l_writer, DatabaseAccessThread::BulkPriority);
 }
 
 
@@ -1087,7 +1051,7 @@ HighScores *MasterServerConnection::getHighScores(S32 scoresPerGroup)
          highScores.resetClock();
 
          RefPtr<HighScoresReader> highScoreReader = new HighScoresReader(mMaster->getSettings(), scoresPerGroup);
-         mMaster->getDatabaseAccessThread()->addEntry(highScoreReader);
+         mMaster->getDatabaseAccessThread()->addEntry(highScoreReader, DatabaseAccessThread::NormalPriority);
       }
       
    return &highScores;
@@ -1121,7 +1085,7 @@ TotalLevelRating *MasterServerConnection::getLevelRating(U32 databaseId)
          // Queue the request!
          RefPtr<TotalLevelRatingsReader> totalLevelRatingsReader = 
                            new TotalLevelRatingsReader(mMaster->getSettings(), databaseId);
-         mMaster->getDatabaseAccessThread()->addEntry(totalLevelRatingsReader);
+         mMaster->getDatabaseAccessThread()->addEntry(totalLevelRatingsReader, DatabaseAccessThread::NormalPriority);
       }
 
    return rating;
@@ -1167,7 +1131,7 @@ PlayerLevelRating *MasterServerConnection::getLevelRating(U32 databaseId, const
          // Queue the request
          RefPtr<PlayerLevelRatingsReader> playerLevelRatingsReader =
                         new PlayerLevelRatingsReader(mMaster->getSettings(), databaseId, playerName);
-         mMaster->getDatabaseAccessThread()->addEntry(playerLevelRatingsReader);
+         mMaster->getDatabaseAccessThread()->addEntry(playerLevelRatingsReader, DatabaseAccessThread::NormalPriority);
       }
 
    return rating;
@@ -1778,6 +1742,7 @@ TNL_IMPLEMENT_RPC_OVERRIDE(MasterServerConnection, c2mSendChat, (StringPtr messa
                if(server->getNetAddress().isEqualAddress(addr) && (addr.port == 0 || addr.port == server->getNetAddress().port))
                {
                   server->mIsIgnoredFromList = true;
+                  server->updateJsonEntry();
                   m2cSendChat(server->mPlayerOrServerName, true, "dropped");
                   droppedServer = true;
                }
@@ -1797,6 +1762,7 @@ TNL_IMPLEMENT_RPC_OVERRIDE(MasterServerConnection, c2mSendChat, (StringPtr messa
                {
                   broughtBackServer = true;
                   serverList->get(i)->mIsIgnoredFromList = false;
+                  serverList->get(i)->updateJsonEntry();
                   m2cSendChat(serverList->get(i)->mPlayerOrServerName, true, "servers restored");
                }
             if(!broughtBackServer)
@@ -1813,6 +1779,7 @@ TNL_IMPLEMENT_RPC_OVERRIDE(MasterServerConnection, c2mSendChat, (StringPtr messa
                if(strcmp(words[1].c_str(), client->mPlayerOrServerName.getString()) == 0)
                {
                   client->mIsIgnoredFromList = !client->mIsIgnoredFromList;
+                  client->updateJsonEntry();
                   m2cSendChat(client->mPlayerOrServerName, true, client->mIsIgnoredFromList ? "player hidden" : "player not hidden anymore");
                   found = true;
                }
@@ -1834,6 +1801,7 @@ TNL_IMPLEMENT_RPC_OVERRIDE(MasterServerConnection, c2mSendChat, (StringPtr messa
                if(addr.isEqualAddress(client->getNetAddress()))
                {
                   client->mIsIgnoredFromList = true;
+                  client->updateJsonEntry();
                   m2cSendChat(client->mPlayerOrServerName, true, "player now hidden");
                   c2mLeaveGlobalChat_remote();  // Also mute and delist the player
                   found = true;
@@ -1932,6 +1900,7 @@ TNL_IMPLEMENT_RPC_OVERRIDE(MasterServerConnection, s2mChangeName, (StringTableEn
    if(mConnectionType == MasterConnectionTypeServer)  // server only, don't want clients to rename yet (client names need to authenticate)
    {
       mPlayerOrServerName = name;
+      updateJsonEntry();
       mMaster->writeJsonNow();  // update server name in ".json"
    }
 }
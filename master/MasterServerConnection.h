@@ -234,6 +234,9 @@ public:
    // This gets updated whenver we gain or lose a server, at most every 5 seconds (currently)
    static void writeClientServerList_JSON();
 
+   // Refresh what the JSON list shows for us; call whenever anything that appears there changes
+   void updateJsonEntry();
+
    bool isAuthenticated();
 
    // This is called when a client wishes to arrange a connection with a server
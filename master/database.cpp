@@ -26,24 +26,30 @@ using namespace Master;
 namespace DbWriter
 {
 
-   
-// TODO: Should we be reusing these?
+
+// Writers are cheap to make; the connections behind them are pooled and live on between writers
 DatabaseWriter getDatabaseWriter(const MasterSettings *settings)
 {
+   DatabaseWriter databaseWriter;
+
    if(settings->getVal<YesNo>("WriteStatsToMySql"))
-      return DatabaseWriter(settings->getVal<string>("StatsDatabaseAddress").c_str(), 
-                            settings->getVal<string>("StatsDatabaseName").c_str(),
-                            settings->getVal<string>("StatsDatabaseUsername").c_str(), 
-                            settings->getVal<string>("StatsDatabasePassword").c_str());
+      databaseWriter = DatabaseWriter(settings->getVal<string>("StatsDatabaseAddress").c_str(), 
+                                      settings->getVal<string>("StatsDatabaseName").c_str(),
+                                      settings->getVal<string>("StatsDatabaseUsername").c_str(), 
+                                      settings->getVal<string>("StatsDatabasePassword").c_str());
    else
-      return DatabaseWriter("stats.db");
+      databaseWriter = DatabaseWriter("stats.db");
+
+   databaseWriter.setStatsBatchSize(settings->getVal<U32>("StatsGamesPerTransaction"));
+
+   return databaseWriter;
 }
 
 
 // Default constructor -- don't use this one!
 DatabaseWriter::DatabaseWriter()
 {
-   // Do nothing
+   initialize("", "", "", "");
 }
 
 
@@ -64,7 +70,7 @@ DatabaseWriter::DatabaseWriter(const char *db, const char *user, const char *pas
 // Sqlite Constructor
 DatabaseWriter::DatabaseWriter(const char *db)
 {
-   strncpy(mDb, db, sizeof(mDb) - 1);
+   initialize("", db, "", "");
 
    if(!fileExists(mDb))
       createStatsDatabase();
@@ -77,6 +83,13 @@ void DatabaseWriter::initialize(const char *server, const char *db, const char *
    strncpy(mDb,       db,       sizeof(mDb)       - 1);
    strncpy(mUser,     user,     sizeof(mUser)     - 1);
    strncpy(mPassword, password, sizeof(mPassword) - 1);
+
+   mServer[sizeof(mServer) - 1] = 0;
+   mDb[sizeof(mDb) - 1] = 0;
+   mUser[sizeof(mUser) - 1] = 0;
+   mPassword[sizeof(mPassword) - 1] = 0;
+
+   mStatsBatchSize = 1;
 }
 
 
@@ -93,64 +106,75 @@ void DatabaseWriter::initialize(const char *server, const char *db, const char *
 #endif
 
 
-static void insertStatsLoadout(const DbQuery &query, U64 playerId, const Vector<LoadoutStats> loadoutStats)
+// Thrown when SQLite reports an error, so callers can handle it the same way as a mysql++ exception
+class DatabaseException : public Exception
+{
+private:
+   string mMessage;
+
+public:
+   DatabaseException(const string &message) : mMessage(message) { }
+   virtual ~DatabaseException() throw() { }
+
+   virtual const char *what() const throw() { return mMessage.c_str(); }
+};
+
+
+static void insertStatsLoadout(DbQuery &query, U64 playerId, const Vector<LoadoutStats> &loadoutStats)
 {
    for(S32 i = 0; i < loadoutStats.size(); i++)
    {
-         string sql = "INSERT INTO stats_player_loadout(stats_player_id, loadout) "
-                       "VALUES(" + itos(playerId) + ", " + itos(loadoutStats[i].loadoutHash) + ");";
-
-         query.runQuery(sql);
+      DbStatement(query, "INSERT INTO stats_player_loadout(stats_player_id, loadout) VALUES(?, ?);")
+            .bind(playerId).bind(loadoutStats[i].loadoutHash).execute();
    }
 }
 
 
-static void insertStatsShots(const DbQuery &query, U64 playerId, const Vector<WeaponStats> weaponStats)
+static void insertStatsShots(DbQuery &query, U64 playerId, const Vector<WeaponStats> &weaponStats)
 {
    for(S32 i = 0; i < weaponStats.size(); i++)
    {
       if(weaponStats[i].shots > 0)
       {
-         string sql = "INSERT INTO stats_player_shots(stats_player_id, weapon, shots, shots_struck) "
-                       "VALUES(" + itos(playerId) + ", '" + WeaponInfo::getWeaponName(weaponStats[i].weaponType) + "', " + 
-                                  itos(weaponStats[i].shots) + ", " + itos(weaponStats[i].hits) + ");";
-         
-         query.runQuery(sql);
+         DbStatement(query, "INSERT INTO stats_player_shots(stats_player_id, weapon, shots, shots_struck) VALUES(?, ?, ?, ?);")
+               .bind(playerId).bind(WeaponInfo::getWeaponName(weaponStats[i].weaponType))
+               .bind(weaponStats[i].shots).bind(weaponStats[i].hits).execute();
       }
    }
 }
 
 
 // Inserts player and all associated weapon stats
-static U64 insertStatsPlayer(const DbQuery &query, const PlayerStats *playerStats, U64 gameId, const string &teamId)
-{
-   string sql = "INSERT INTO stats_player(stats_game_id, stats_team_id, player_name, "
-                                               "is_authenticated,               is_robot, "
-                                               "result,                         points, "
-                                               "kill_count,                     death_count, "
-                                               "suicide_count,                  switched_team_count, "
-                                               "asteroid_crashes,               flag_drops, "
-                                               "flag_pickups,                   flag_returns, "
-                                               "flag_scores,                    teleport_uses, "
-                                               "turret_kills,                   ff_kills, "
-                                               "asteroid_kills,                 turrets_engineered, "
-                                               "ffs_engineered,                 teleports_engineered, "
-                                               "distance_traveled )"                      
-                         "VALUES(" + itos(gameId) + ", " + teamId + ", '"     + sanitizeForSql(playerStats->name)           + "', " +
-                                 btos(playerStats->isAuthenticated)     + ", " + btos(playerStats->isRobot)           + ", " +
-                                 "'" + playerStats->gameResult + "'"    + ", " + itos(playerStats->points)            + ", " + 
-                                 itos(playerStats->kills)               + ", " + itos(playerStats->deaths)            + ", " +
-                                 itos(playerStats->suicides)            + ", " + itos(playerStats->switchedTeamCount) + ", " +
-                                 itos(playerStats->crashedIntoAsteroid) + ", " + itos(playerStats->flagDrop)          + ", " + 
-                                 itos(playerStats->flagPickup)          + ", " + itos(playerStats->flagReturn)        + ", " + 
-                                 itos(playerStats->flagScore)           + ", " + itos(playerStats->teleport)          + ", " + 
-                                 itos(playerStats->turretKills)         + ", " + itos(playerStats->ffKills)           + ", " + 
-                                 itos(playerStats->astKills)            + ", " + itos(playerStats->turretsEngr)       + ", " + 
-                                 itos(playerStats->ffEngr)              + ", " + itos(playerStats->telEngr)           + ", " + 
-                                 itos(playerStats->distTraveled)        + 
-                         ")";
-
-   U64 playerId = query.runQuery(sql);
+static U64 insertStatsPlayer(DbQuery &query, const PlayerStats *playerStats, U64 gameId, U64 teamId)
+{
+   DbStatement statement(query, "INSERT INTO stats_player(stats_game_id, stats_team_id, player_name, "
+                                                         "is_authenticated,               is_robot, "
+                                                         "result,                         points, "
+                                                         "kill_count,                     death_count, "
+                                                         "suicide_count,                  switched_team_count, "
+                                                         "asteroid_crashes,               flag_drops, "
+                                                         "flag_pickups,                   flag_returns, "
+                                                         "flag_scores,                    teleport_uses, "
+                                                         "turret_kills,                   ff_kills, "
+                                                         "asteroid_kills,                 turrets_engineered, "
+                                                         "ffs_engineered,                 teleports_engineered, "
+                                                         "distance_traveled ) "
+                                "VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);");
+
+   statement.bind(gameId)                           .bind(teamId)                          .bind(playerStats->name)
+            .bind(playerStats->isAuthenticated)     .bind(playerStats->isRobot)
+            .bind(string(1, playerStats->gameResult)).bind(playerStats->points)
+            .bind(playerStats->kills)               .bind(playerStats->deaths)
+            .bind(playerStats->suicides)            .bind(playerStats->switchedTeamCount)
+            .bind(playerStats->crashedIntoAsteroid) .bind(playerStats->flagDrop)
+            .bind(playerStats->flagPickup)          .bind(playerStats->flagReturn)
+            .bind(playerStats->flagScore)           .bind(playerStats->teleport)
+            .bind(playerStats->turretKills)         .bind(playerStats->ffKills)
+            .bind(playerStats->astKills)            .bind(playerStats->turretsEngr)
+            .bind(playerStats->ffEngr)              .bind(playerStats->telEngr)
+            .bind(playerStats->distTraveled);
+
+   U64 playerId = statement.execute();
 
    insertStatsShots(query, playerId, playerStats->weaponStats);
    insertStatsLoadout(query, playerId, playerStats->loadoutStats);
@@ -160,31 +184,27 @@ static U64 insertStatsPlayer(const DbQuery &query, const PlayerStats *playerStat
 
 
 // Inserts stats of team and all players
-static U64 insertStatsTeam(const DbQuery &query, const TeamStats *teamStats, U64 &gameId)
+static U64 insertStatsTeam(DbQuery &query, const TeamStats *teamStats, U64 gameId)
 {
-   string sql = "INSERT INTO stats_team(stats_game_id, team_name, team_score, result, color_hex) "
-                "VALUES(" + itos(gameId) + ", '" + sanitizeForSql(teamStats->name) + "', " + itos(teamStats->score) + " ,'" + 
-                ctos(teamStats->gameResult) + "' ,'" + teamStats->hexColor + "');";
-
-   U64 teamId = query.runQuery(sql);
+   U64 teamId = DbStatement(query, "INSERT INTO stats_team(stats_game_id, team_name, team_score, result, color_hex) VALUES(?, ?, ?, ?, ?);")
+         .bind(gameId).bind(teamStats->name).bind(teamStats->score).bind(ctos(teamStats->gameResult)).bind(teamStats->hexColor)
+         .execute();
 
    for(S32 i = 0; i < teamStats->playerStats.size(); i++)
-      insertStatsPlayer(query, &teamStats->playerStats[i], gameId, itos(teamId));
+      insertStatsPlayer(query, &teamStats->playerStats[i], gameId, teamId);
 
    return teamId;
 }
 
 
-static U64 insertStatsGame(const DbQuery &query, const GameStats *gameStats, U64 serverId)
+static U64 insertStatsGame(DbQuery &query, const GameStats *gameStats, U64 serverId)
 {
-   string sql = "INSERT INTO stats_game(server_id, game_type, is_official, player_count, "
-                                       "duration_seconds, level_name, is_team_game, team_count) "
-                "VALUES( " + itos(serverId) + ", '" + gameStats->gameType + "', " + btos(gameStats->isOfficial) + ", " + 
-                             itos(gameStats->playerCount) + ", " + itos(gameStats->duration) + ", '" + 
-                             sanitizeForSql(gameStats->levelName) + "', " + btos(gameStats->isTeamGame) + ", " + 
-                             itos(gameStats->teamStats.size())  + ");";
-
-   U64 gameId = query.runQuery(sql);
+   U64 gameId = DbStatement(query, "INSERT INTO stats_game(server_id, game_type, is_official, player_count, "
+                                                         "duration_seconds, level_name, is_team_game, team_count) "
+                                   "VALUES(?, ?, ?, ?, ?, ?, ?, ?);")
+         .bind(serverId).bind(gameStats->gameType).bind(gameStats->isOfficial).bind(gameStats->playerCount)
+         .bind(gameStats->duration).bind(gameStats->levelName).bind(gameStats->isTeamGame).bind(gameStats->teamStats.size())
+         .execute();
 
    for(S32 i = 0; i < gameStats->teamStats.size(); i++)
       insertStatsTeam(query, &gameStats->teamStats[i], gameId);
@@ -193,34 +213,20 @@ static U64 insertStatsGame(const DbQuery &query, const GameStats *gameStats, U64
 }
 
 
-static U64 insertStatsServer(const DbQuery &query, const string &serverName, const string &serverIP)
+static U64 insertStatsServer(DbQuery &query, const string &serverName, const string &serverIP)
 {
-   string sql = "INSERT INTO server(server_name, ip_address) "
-                "VALUES('" + sanitizeForSql(serverName) + "', '" + serverIP + "');";
-
-   if(query.query)
-     return query.runQuery(sql);
-
-   if(query.sqliteDb)
-   {
-      query.runQuery(sql);
-      return sqlite3_last_insert_rowid(query.sqliteDb);
-   }
-
-   return U64_MAX;
+   return DbStatement(query, "INSERT INTO server(server_name, ip_address) VALUES(?, ?);")
+         .bind(serverName).bind(serverIP).execute();
 }
 
 
 // Looks in database to find server mathcing the one in gameStats... returns server_id, or -1 if no match was found
-S32 DatabaseWriter::getServerIdFromDatabase(const DbQuery &query, const string &serverName, const string &serverIP)
+S32 DatabaseWriter::getServerIdFromDatabase(DbQuery &query, const string &serverName, const string &serverIP)
 {
-   // Find server in database
-   string sql = "SELECT server_id FROM server AS server "
-                "WHERE server_name = '" + sanitizeForSql(serverName) + "' AND ip_address = '" + serverIP + "' LIMIT 1;";
-                //"WHERE server_name = 'Bitfighter sam686' AND ip_address = '96.2.123.136';";
-
    Vector<Vector<string> > results;
-   selectHandler(sql, 1, results);
+
+   DbStatement(query, "SELECT server_id FROM server AS server WHERE server_name = ? AND ip_address = ? LIMIT 1;")
+         .bind(serverName).bind(serverIP).select(1, results);
 
    if(results.size() == 1 && results[0].size() == 1)
       return atoi(results[0][0].c_str());
@@ -243,7 +249,7 @@ void DatabaseWriter::addToServerCache(U64 id, const string &serverName, const st
 
 // Get the serverID given its name and IP.  First we'll check our cache to see if this is a known server; if we can't find
 // it there, we'll go to the database to retrieve it.
-U64 DatabaseWriter::getServerID(const DbQuery &query, const string &serverName, const string &serverIP)
+U64 DatabaseWriter::getServerID(DbQuery &query, const string &serverName, const string &serverIP)
 {
    U64 serverId = getServerIDFromCache(serverName, serverIP);
 
@@ -274,45 +280,74 @@ U64 DatabaseWriter::getServerIDFromCache(const string &serverName, const string
 }
 
 
+// Games are written inside a transaction that is only committed once mStatsBatchSize games have gone in, or when
+// commitPendingWrites() is called, which the master does whenever its database thread runs out of work.  Under an
+// end-of-game rush that saves a disk sync (or server round trip) per game.  Each game gets its own savepoint, so one
+// that fails partway through is taken back out without losing the rest of the batch.
 void DatabaseWriter::insertStats(const GameStats &gameStats) 
 {
-   DbQuery query(mDb, mServer, mUser, mPassword);
+   PooledDbQuery query(mDb, mServer, mUser, mPassword, mStatsBatchSize > 1);
+
+   if(!query->isValid)
+      return;
+
+   query->beginTransaction();
+
+   bool inSavepoint = query->isInTransaction() && query->setSavepoint();
 
    try
    {
-      if(query.isValid)
-      {
-         U64 serverId = getServerID(query, gameStats.serverName, gameStats.serverIP);
-         insertStatsGame(query, &gameStats, serverId);
-      }
+      U64 serverId = getServerID(*query, gameStats.serverName, gameStats.serverIP);
+      insertStatsGame(*query, &gameStats, serverId);
+
+      if(inSavepoint)
+         query->releaseSavepoint();
+
+      if(query->isInTransaction() && query->addBatchedWrite() >= mStatsBatchSize)
+         query->commitTransaction();
    }
    catch(const Exception &ex) 
    {
       logprintf("[%s] Failure writing stats to database: %s", getTimeStamp().c_str(), ex.what());
+
+      if(inSavepoint)
+         query->rollbackToSavepoint();
+
+      cachedServers.clear();     // May hold the id of a server row we just took back out
    }
 }
 
 
+// Achievements and level info come in on the same lane as stats, so when stats are batched they go through the batch
+// connection too, and into its open transaction.  Any other connection would have to wait for that transaction to be
+// committed before it could write to the file, and would give up long before then.
 void DatabaseWriter::insertAchievement(U8 achievementId, const StringTableEntry &playerNick, const string &serverName, const string &serverIP) 
 {
-   DbQuery query(mDb, mServer, mUser, mPassword);
+   PooledDbQuery query(mDb, mServer, mUser, mPassword, mStatsBatchSize > 1);
+
+   if(!query->isValid)
+      return;
+
+   bool inSavepoint = query->isInTransaction() && query->setSavepoint();
 
    try
    {
-      if(query.isValid)
-      {
-         U64 serverId = getServerID(query, serverName, serverIP);
+      U64 serverId = getServerID(*query, serverName, serverIP);
 
-         string sql = "INSERT INTO player_achievements(player_name, achievement_id, server_id) "
-                      "VALUES( '" + sanitizeForSql(playerNick.getString()) + "', "
-                              "'" + itos(achievementId) + "', " + itos(serverId) + ");";
+      DbStatement(*query, "INSERT INTO player_achievements(player_name, achievement_id, server_id) VALUES(?, ?, ?);")
+            .bind(playerNick.getString()).bind(achievementId).bind(serverId).execute();
 
-         query.runQuery(sql);
-      }
+      if(inSavepoint)
+         query->releaseSavepoint();
    }
    catch(const Exception &ex) 
    {
       logprintf("[%s] Failure writing achievement to database: %s", getTimeStamp().c_str(), ex.what());
+
+      if(inSavepoint)
+         query->rollbackToSavepoint();
+
+      cachedServers.clear();     // May hold the id of a server row we just took back out
    }
 }
 
@@ -320,35 +355,30 @@ void DatabaseWriter::insertAchievement(U8 achievementId, const StringTableEntry
 void DatabaseWriter::insertLevelInfo(const string &hash, const string &levelName, const string &creator, 
                                      const string &gameType, bool hasLevelGen, U8 teamCount, S32 winningScore, S32 gameDurationInSeconds)
 {
-   DbQuery query(mDb, mServer, mUser, mPassword);
+   // Sanity check
+   if(hash.length() != 32)
+      return;
+
+   PooledDbQuery query(mDb, mServer, mUser, mPassword, mStatsBatchSize > 1);     // See insertAchievement()
 
    try
    {
-      if(!query.isValid)
+      if(!query->isValid)
          return;
 
-      // Sanity check
-      if(hash.length() != 32)
-         return;
-
-      string sql;
-
       // We only want to insert a record of this server if the hash does not yet exist
-      sql = "SELECT hash FROM stats_level WHERE hash = '" + sanitizeForSql(hash) + "' LIMIT 1;";
-
       Vector<Vector<string> > results;
-      selectHandler(sql, 1, results);
+      DbStatement(*query, "SELECT hash FROM stats_level WHERE hash = ? LIMIT 1;").bind(hash).select(1, results);
 
       bool found = (results.size() == 1 && results[0].size() == 1);
 
       if(!found) 
       {
-         sql = "INSERT INTO stats_level(hash, level_name, creator, game_type, has_levelgen, team_count, winning_score, game_duration) "
-               "VALUES('" + sanitizeForSql(hash)      + "', '" + sanitizeForSql(levelName)         + "', " + 
-                      "'" + sanitizeForSql(creator)   + "', '" + sanitizeForSql(gameType)          + "', " +
-                      "'" + btos(hasLevelGen)   + "', '" + itos(teamCount)             + "', " + 
-                      "'" + itos(winningScore)  + "', '" + itos(gameDurationInSeconds) + "');";
-         query.runQuery(sql);
+         DbStatement(*query, "INSERT INTO stats_level(hash, level_name, creator, game_type, has_levelgen, team_count, winning_score, game_duration) "
+                             "VALUES(?, ?, ?, ?, ?, ?, ?, ?);")
+               .bind(hash).bind(levelName).bind(creator).bind(gameType)
+               .bind(hasLevelGen).bind(teamCount).bind(winningScore).bind(gameDurationInSeconds)
+               .execute();
       }
    }
    catch(const Exception &ex) 
@@ -428,11 +458,10 @@ Vector<string> DatabaseWriter::getGameJoltCredentialStrings(const string &phpbbD
 // Returns rating of the specified level 
 S16 DatabaseWriter::getLevelRating(U32 databaseId)
 {
-   string sql = "SELECT levels.rating from pleiades.levels WHERE id=" + itos(databaseId) + "; ";
-
    Vector<Vector<string> > results;
 
-   selectHandler(sql, 1, results);
+   PooledDbQuery query(mDb, mServer, mUser, mPassword);
+   DbStatement(*query, "SELECT levels.rating from pleiades.levels WHERE id = ?;").bind(databaseId).select(1, results);
 
    // If no results, it means that the client expected the level to be in the database, but it wasn't.
    if(results.size() == 0)
@@ -457,19 +486,19 @@ S32 DatabaseWriter::getLevelRating(U32 databaseId, const StringTableEntry &name)
    // user is not in the database and no records are returned.  With the UNION, we'll get back at least
    // one record with 0, the default rating for a player who hasn't rated a level, even if that player
    // has not rated it.  Add a sort column to ensure that we get results in the order we expect.
-   string sql =
+   Vector<Vector<string> > results;
+
+   PooledDbQuery query(mDb, mServer, mUser, mPassword);
+   DbStatement(*query,
       "SELECT 1 as sort, ratings.value FROM pleiades.ratings "
       "INNER JOIN bf_phpbb.phpbb_users "
-      "WHERE ratings.level_id = " + itos(databaseId) + " AND "
+      "WHERE ratings.level_id = ? AND "
          "ratings.user_id = phpbb_users.user_id AND "
-         "phpbb_users.username = '" + name.getString() + "' "
+         "phpbb_users.username = ? "
        "UNION ALL "
        "SELECT 2 as sort, 0 "
-       "ORDER BY sort;";
-
-   Vector<Vector<string> > results;
-
-   selectHandler(sql, 1, results);
+       "ORDER BY sort;")
+      .bind(databaseId).bind(name.getString()).select(2, results);
 
    if(results.size() == 0)    // <== signifies an error getting the rating
       return UnknownRating;
@@ -480,11 +509,10 @@ S32 DatabaseWriter::getLevelRating(U32 databaseId, const StringTableEntry &name)
 
 Int<BADGE_COUNT> DatabaseWriter::getAchievements(const char *name)
 {
-   string sql = "SELECT achievement_id FROM player_achievements WHERE player_name = '" + string(name) + "';";
-
    Vector<Vector<string> > results;
 
-   selectHandler(sql, 1, results);
+   PooledDbQuery query(mDb, mServer, mUser, mPassword);
+   DbStatement(*query, "SELECT achievement_id FROM player_achievements WHERE player_name = ?;").bind(name).select(1, results);
 
    S32 badges = 0;
 
@@ -497,11 +525,10 @@ Int<BADGE_COUNT> DatabaseWriter::getAchievements(const char *name)
 
 U16 DatabaseWriter::getGamesPlayed(const char *name)
 {
-   string sql = "SELECT count(*) FROM stats_player WHERE player_name = '" + string(name) + "';";
-
    Vector<Vector<string> > results;
 
-   selectHandler(sql, 1, results);
+   PooledDbQuery query(mDb, mServer, mUser, mPassword);
+   DbStatement(*query, "SELECT count(*) FROM stats_player WHERE player_name = ?;").bind(name).select(1, results);
 
    if(results.size() == 0)
       return 0;
@@ -510,57 +537,11 @@ U16 DatabaseWriter::getGamesPlayed(const char *name)
 }
 
 
+// For queries whose table or column names vary, so can't be prepared
 void DatabaseWriter::selectHandler(const string &sql, S32 cols, Vector<Vector<string> > &values)
 {
-   DbQuery query(mDb, mServer, mUser, mPassword);
-
-   try
-   {
-
-#ifdef BF_WRITE_TO_MYSQL
-      if(query.query)
-      {
-         //S32 serverId_int = -1;
-         StoreQueryResult results = query.query->store(sql.c_str(), sql.length());
-
-         S32 rows = results.num_rows();
-
-         for(S32 i = 0; i < rows; i++)
-         {
-            values.push_back(Vector<string>());     // Add another row
-
-            for(S32 j = 0; j < cols; j++)
-               values[i].push_back(string(results[i][j]));
-         }
-      }
-      else
-#endif
-      if(query.sqliteDb)
-      {
-         char *err = 0;
-         char **results;
-         int rows, cols;
-
-         sqlite3_get_table(query.sqliteDb, sql.c_str(), &results, &rows, &cols, &err);
-
-         // results[0]...results[cols] contain the col headers ==> http://www.sqlite.org/c3ref/free_table.html
-         for(S32 i = 0; i < rows * cols; i += cols)
-         {
-            values.push_back(Vector<string>());     // Add another row
-
-            for(S32 j = 0; j < cols; j++)
-               values[i].push_back(results[cols + i + j]);
-         }
-
-         sqlite3_free_table(results);
-         sqlite3_free(err);
-      }
-   }
-   catch(const Exception &ex)
-   {
-      logprintf(LogConsumer::LogError, "[%s]SQL Execution Error \"%s\"\n\trunning sql: %s", 
-                getTimeStamp().c_str(), ex.what(), sql.c_str());
-   }
+   PooledDbQuery query(mDb, mServer, mUser, mPassword);
+   DbStatement(*query, sql).select(cols, values);
 }
 
 
@@ -580,7 +561,14 @@ void DatabaseWriter::createStatsDatabase()
 
    sqlite3_open(mDb, &sqliteDb);
 
-   query.runQuery(getSqliteSchema());
+   try
+   {
+      query.runQuery(getSqliteSchema());
+   }
+   catch(const Exception &ex)
+   {
+      logprintf(LogConsumer::LogError, "Failure building stats database schema: %s", ex.what());
+   }
 
    if(sqliteDb)
       sqlite3_close(sqliteDb);
@@ -592,21 +580,57 @@ void DatabaseWriter::setDumpSql(bool dump)
    DbQuery::dumpSql = dump;
 }
 
+
+void DatabaseWriter::setStatsBatchSize(S32 gamesPerTransaction)
+{
+   mStatsBatchSize = getMax(gamesPerTransaction, 1);
+}
+
+
+void DatabaseWriter::commitPendingWrites()
+{
+   DbConnectionPool::commitPendingTransactions();
+}
+
+
 ////////////////////////////////////////
 ////////////////////////////////////////
 
 bool DbQuery::dumpSql = false;
 
 
+static string getPoolKey(const char *db, const char *server, const char *user, const char *password)
+{
+   string key = db;
+   key += '\n';
+
+   // SQLite connections only care about the filename
+   if(server && server[0] != 0)
+   {
+      key += server;
+      key += '\n';
+      key += user ? user : "";
+      key += '\n';
+      key += password ? password : "";
+   }
+
+   return key;
+}
+
+
 // Constructor
 DbQuery::DbQuery(const char *db, const char *server, const char *user, const char *password)
 {
    query = NULL;
    sqliteDb = NULL;
    isValid = true;
+   mInTransaction = false;
+   mBatchedWrites = 0;
 
    TNLAssert(db && db[0] != 0, "must have a database");
 
+   poolKey = getPoolKey(db, server, user, password);
+
 #ifdef BF_WRITE_TO_MYSQL
 
    if(server && server[0] != 0) // mysql have a server to connect to
@@ -631,13 +655,22 @@ DbQuery::DbQuery(const char *db, const char *server, const char *user, const cha
       {
          logprintf("ERROR: Can't open stats database %s: %s", db, sqlite3_errmsg(sqliteDb));
          sqlite3_close(sqliteDb);
+         sqliteDb = NULL;
          isValid = false;
       }
+      else
+         sqlite3_busy_timeout(sqliteDb, 1000);     // Other pooled connections may be writing to the same file
 }
 
 // Destructor
 DbQuery::~DbQuery()
 {
+   if(mInTransaction)
+      commitTransaction();
+
+   for(map<string, sqlite3_stmt *>::iterator it = mPreparedStatements.begin(); it != mPreparedStatements.end(); it++)
+      sqlite3_finalize(it->second);
+
    if(query)
       delete query;
 
@@ -669,9 +702,11 @@ U64 DbQuery::runQuery(const string &sql) const
       sqlite3_exec(sqliteDb, sql.c_str(), NULL, 0, &err);
 
       if(err)
-         logprintf("Database error accessing sqlite databse: %s", err);
-
-      sqlite3_free(err);
+      {
+         string error = err;
+         sqlite3_free(err);
+         throw DatabaseException("Database error accessing sqlite database: " + error);
+      }
 
       return sqlite3_last_insert_rowid(sqliteDb);  
    }
@@ -680,6 +715,517 @@ U64 DbQuery::runQuery(const string &sql) const
 }
 
 
+// Returns a compiled statement for sql, reset and ready to be bound, or NULL if it won't compile
+sqlite3_stmt *DbQuery::getPreparedStatement(const string &sql)
+{
+   TNLAssert(sqliteDb, "Only SQLite connections have prepared statements");
+
+   map<string, sqlite3_stmt *>::iterator it = mPreparedStatements.find(sql);
+
+   if(it != mPreparedStatements.end())
+   {
+      sqlite3_reset(it->second);
+      sqlite3_clear_bindings(it->second);
+      return it->second;
+   }
+
+   // selectHandler() can be fed arbitrary SQL, so don't let the cache grow without bound
+   if((S32)mPreparedStatements.size() >= MaxPreparedStatements)
+   {
+      for(it = mPreparedStatements.begin(); it != mPreparedStatements.end(); it++)
+         sqlite3_finalize(it->second);
+
+      mPreparedStatements.clear();
+   }
+
+   sqlite3_stmt *statement = NULL;
+
+   if(sqlite3_prepare_v2(sqliteDb, sql.c_str(), -1, &statement, NULL) != SQLITE_OK)
+   {
+      logprintf("Database error preparing sqlite statement: %s", sqlite3_errmsg(sqliteDb));
+      sqlite3_finalize(statement);
+      return NULL;
+   }
+
+   mPreparedStatements[sql] = statement;
+   return statement;
+}
+
+
+// Has the connection survived sitting in the pool?  MySQL servers drop connections that are idle too long.
+bool DbQuery::isAlive()
+{
+   if(!isValid)
+      return false;
+
+#ifdef BF_WRITE_TO_MYSQL
+   if(query)
+      return conn.ping();
+#endif
+
+   return true;
+}
+
+
+void DbQuery::beginTransaction()
+{
+   if(mInTransaction)
+      return;
+
+   try
+   {
+      runQuery(query ? "START TRANSACTION;" : "BEGIN;");
+      mInTransaction = true;
+      mBatchedWrites = 0;
+   }
+   catch(const Exception &ex)
+   {
+      logprintf(LogConsumer::LogError, "[%s] Could not start database transaction: %s", getTimeStamp().c_str(), ex.what());
+   }
+}
+
+
+void DbQuery::commitTransaction()
+{
+   if(!mInTransaction)
+      return;
+
+   mInTransaction = false;
+   mBatchedWrites = 0;
+
+   try
+   {
+      runQuery("COMMIT;");
+   }
+   catch(const Exception &ex)
+   {
+      logprintf(LogConsumer::LogError, "[%s] Could not commit database transaction: %s", getTimeStamp().c_str(), ex.what());
+   }
+}
+
+
+bool DbQuery::isInTransaction() const
+{
+   return mInTransaction;
+}
+
+
+// Marks the point rollbackToSavepoint() goes back to; returns false if we couldn't set one
+bool DbQuery::setSavepoint()
+{
+   try
+   {
+      runQuery("SAVEPOINT stats_game;");
+      return true;
+   }
+   catch(const Exception &ex)
+   {
+      logprintf(LogConsumer::LogError, "[%s] Could not set database savepoint: %s", getTimeStamp().c_str(), ex.what());
+      return false;
+   }
+}
+
+
+void DbQuery::releaseSavepoint()
+{
+   runQuery("RELEASE SAVEPOINT stats_game;");
+}
+
+
+// Undoes everything since setSavepoint(), leaving the rest of the transaction alone
+void DbQuery::rollbackToSavepoint()
+{
+   try
+   {
+      runQuery("ROLLBACK TO SAVEPOINT stats_game;");
+      runQuery("RELEASE SAVEPOINT stats_game;");
+   }
+   catch(const Exception &ex)
+   {
+      logprintf(LogConsumer::LogError, "[%s] Could not roll back to database savepoint: %s", getTimeStamp().c_str(), ex.what());
+   }
+}
+
+
+S32 DbQuery::addBatchedWrite()
+{
+   return ++mBatchedWrites;
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+Vector<DbQuery *> &DbConnectionPool::getIdleConnections()
+{
+   static Vector<DbQuery *> idleConnections;
+   return idleConnections;
+}
+
+
+Mutex &DbConnectionPool::getMutex()
+{
+   static Mutex mutex;
+   return mutex;
+}
+
+
+// Caller owns the returned connection until it is handed back with release()
+DbQuery *DbConnectionPool::acquire(const char *db, const char *server, const char *user, const char *password)
+{
+   string key = getPoolKey(db, server, user, password);
+   DbQuery *found = NULL;
+
+   getMutex().lock();
+
+   Vector<DbQuery *> &idle = getIdleConnections();
+
+   for(S32 i = idle.size() - 1; i >= 0; i--)
+      if(idle[i]->poolKey == key)
+      {
+         found = idle[i];
+         idle.erase(i);
+         break;
+      }
+
+   getMutex().unlock();
+
+   if(found && found->isAlive())
+      return found;
+
+   delete found;
+
+   return new DbQuery(db, server, user, password);
+}
+
+
+void DbConnectionPool::release(DbQuery *query)
+{
+   // No point keeping a broken connection around, next user can try again with a fresh one
+   if(!query->isValid)
+   {
+      delete query;
+      return;
+   }
+
+   // Whoever gets this next shouldn't find themselves inside our transaction
+   if(query->isInTransaction())
+      query->commitTransaction();
+
+   DbQuery *surplus = NULL;
+
+   getMutex().lock();
+
+   Vector<DbQuery *> &idle = getIdleConnections();
+   idle.push_back(query);
+
+   if(idle.size() > MaxIdleConnections)
+   {
+      surplus = idle[0];      // Least recently used
+      idle.erase(0);
+   }
+
+   getMutex().unlock();
+
+   delete surplus;            // Commits anything it had pending
+}
+
+
+DbQuery *&DbConnectionPool::getBatchConnection()
+{
+   static DbQuery *batchConnection = NULL;
+   return batchConnection;
+}
+
+
+Mutex &DbConnectionPool::getBatchMutex()
+{
+   static Mutex mutex;
+   return mutex;
+}
+
+
+// Blocks until any other thread is done with the batch connection; hand it back with releaseBatchConnection()
+DbQuery *DbConnectionPool::acquireBatchConnection(const char *db, const char *server, const char *user, const char *password)
+{
+   getBatchMutex().lock();
+
+   DbQuery *&batch = getBatchConnection();
+
+   if(batch && (batch->poolKey != getPoolKey(db, server, user, password) || !batch->isAlive()))
+   {
+      delete batch;           // Commits anything it had pending
+      batch = NULL;
+   }
+
+   if(!batch)
+      batch = new DbQuery(db, server, user, password);
+
+   return batch;
+}
+
+
+void DbConnectionPool::releaseBatchConnection(DbQuery *query)
+{
+   DbQuery *&batch = getBatchConnection();
+
+   TNLAssert(query == batch, "Not the batch connection!");
+
+   if(!query->isValid)
+   {
+      delete batch;
+      batch = NULL;
+   }
+
+   getBatchMutex().unlock();
+}
+
+
+void DbConnectionPool::commitPendingTransactions()
+{
+   getBatchMutex().lock();
+
+   if(getBatchConnection())
+      getBatchConnection()->commitTransaction();
+
+   getBatchMutex().unlock();
+}
+
+
+void DbConnectionPool::closeAll()
+{
+   getBatchMutex().lock();
+
+   delete getBatchConnection();      // Commits anything still batched up
+   getBatchConnection() = NULL;
+
+   getBatchMutex().unlock();
+
+   getMutex().lock();
+
+   Vector<DbQuery *> &idle = getIdleConnections();
+
+   for(S32 i = 0; i < idle.size(); i++)
+      delete idle[i];
+
+   idle.clear();
+
+   getMutex().unlock();
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+PooledDbQuery::PooledDbQuery(const char *db, const char *server, const char *user, const char *password, bool forBatchedWrites)
+{
+   mIsBatchConnection = forBatchedWrites;
+
+   if(forBatchedWrites)
+      mQuery = DbConnectionPool::acquireBatchConnection(db, server, user, password);
+   else
+      mQuery = DbConnectionPool::acquire(db, server, user, password);
+}
+
+
+PooledDbQuery::~PooledDbQuery()
+{
+   if(mIsBatchConnection)
+      DbConnectionPool::releaseBatchConnection(mQuery);
+   else
+      DbConnectionPool::release(mQuery);
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+DbStatement::DbStatement(DbQuery &query, const string &sql) : mQuery(query), mSql(sql)
+{
+   // Do nothing
+}
+
+
+DbStatement &DbStatement::bind(S64 value)
+{
+   Param param;
+   param.isText = false;
+   param.intValue = value;
+   mParams.push_back(param);
+
+   return *this;
+}
+
+
+DbStatement &DbStatement::bind(S32 value)  { return bind(S64(value)); }
+DbStatement &DbStatement::bind(U32 value)  { return bind(S64(value)); }
+DbStatement &DbStatement::bind(U64 value)  { return bind(S64(value)); }
+DbStatement &DbStatement::bind(bool value) { return bind(S64(value ? 1 : 0)); }
+
+
+DbStatement &DbStatement::bind(const string &value)
+{
+   Param param;
+   param.isText = true;
+   param.intValue = 0;
+   param.textValue = value;
+   mParams.push_back(param);
+
+   return *this;
+}
+
+
+DbStatement &DbStatement::bind(const char *value)
+{
+   return bind(string(value));
+}
+
+
+// Build the full SQL for databases where we can't bind parameters
+string DbStatement::getSubstitutedSql() const
+{
+   string sql;
+   sql.reserve(mSql.length() + mParams.size() * 8);
+
+   S32 param = 0;
+
+   for(U32 i = 0; i < mSql.length(); i++)
+   {
+      if(mSql[i] != '?')
+         sql += mSql[i];
+
+      else if(param >= mParams.size())
+      {
+         TNLAssert(false, "Not enough parameters bound to statement!");
+         sql += "NULL";
+      }
+
+      else
+      {
+         const Param &p = mParams[param++];
+         sql += p.isText ? "'" + sanitizeForSql(p.textValue) + "'" : itos(p.intValue);
+      }
+   }
+
+   return sql;
+}
+
+
+sqlite3_stmt *DbStatement::bindSqlite()
+{
+   sqlite3_stmt *statement = mQuery.getPreparedStatement(mSql);
+
+   if(!statement)
+      return NULL;
+
+   TNLAssert(sqlite3_bind_parameter_count(statement) == mParams.size(), "Wrong number of parameters bound to statement!");
+
+   for(S32 i = 0; i < mParams.size(); i++)
+   {
+      if(mParams[i].isText)
+         sqlite3_bind_text(statement, i + 1, mParams[i].textValue.c_str(), mParams[i].textValue.length(), SQLITE_TRANSIENT);
+      else
+         sqlite3_bind_int64(statement, i + 1, mParams[i].intValue);
+   }
+
+   return statement;
+}
+
+
+U64 DbStatement::execute()
+{
+   if(!mQuery.isValid)
+      return U64_MAX;
+
+   if(mQuery.query)
+      return mQuery.runQuery(getSubstitutedSql());
+
+   if(!mQuery.sqliteDb)
+      return U64_MAX;
+
+   if(DbQuery::dumpSql)
+      logprintf("SQL: %s", getSubstitutedSql().c_str());
+
+   sqlite3_stmt *statement = bindSqlite();
+
+   if(!statement)
+      throw DatabaseException("Could not prepare statement: " + mSql);
+
+   // Whatever sqlite3_last_insert_rowid() says now belongs to some earlier insert, so it can't be returned as ours
+   if(sqlite3_step(statement) != SQLITE_DONE)
+   {
+      string error = sqlite3_errmsg(mQuery.sqliteDb);
+      sqlite3_reset(statement);
+      throw DatabaseException("Database error accessing sqlite database: " + error);
+   }
+
+   sqlite3_reset(statement);     // Don't hold any locks while it sits in the cache
+
+   return sqlite3_last_insert_rowid(mQuery.sqliteDb);
+}
+
+
+void DbStatement::select(S32 cols, Vector<Vector<string> > &values)
+{
+   if(!mQuery.isValid)
+      return;
+
+   try
+   {
+#ifdef BF_WRITE_TO_MYSQL
+      if(mQuery.query)
+      {
+         string sql = getSubstitutedSql();
+         StoreQueryResult results = mQuery.query->store(sql.c_str(), sql.length());
+
+         S32 rows = results.num_rows();
+
+         for(S32 i = 0; i < rows; i++)
+         {
+            values.push_back(Vector<string>());     // Add another row
+
+            for(S32 j = 0; j < cols; j++)
+               values.last().push_back(string(results[i][j]));
+         }
+      }
+      else
+#endif
+      if(mQuery.sqliteDb)
+      {
+         sqlite3_stmt *statement = bindSqlite();
+
+         if(!statement)
+            return;
+
+         S32 resultCols = getMin(cols, sqlite3_column_count(statement));
+         S32 status;
+
+         while((status = sqlite3_step(statement)) == SQLITE_ROW)
+         {
+            values.push_back(Vector<string>());     // Add another row
+
+            for(S32 j = 0; j < resultCols; j++)
+            {
+               const char *text = (const char *)sqlite3_column_text(statement, j);
+               values.last().push_back(text ? text : "");
+            }
+         }
+
+         if(status != SQLITE_DONE)
+            logprintf(LogConsumer::LogError, "[%s]SQL Execution Error \"%s\"\n\trunning sql: %s", 
+                      getTimeStamp().c_str(), sqlite3_errmsg(mQuery.sqliteDb), mSql.c_str());
+
+         sqlite3_reset(statement);
+      }
+   }
+   catch(const Exception &ex)
+   {
+      logprintf(LogConsumer::LogError, "[%s]SQL Execution Error \"%s\"\n\trunning sql: %s", 
+                getTimeStamp().c_str(), ex.what(), mSql.c_str());
+   }
+}
+
+
 ////////////////////////////////////////
 ////////////////////////////////////////
 
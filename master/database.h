@@ -13,8 +13,10 @@
 #include "tnlTypes.h"
 #include "tnlVector.h"
 #include "tnlNonce.h"
+#include "tnlThread.h"
 #include <sqlite3.h>
 #include <string>
+#include <map>
 
 
 #ifdef BF_WRITE_TO_MYSQL
@@ -64,10 +66,19 @@ class DbQuery
    Connection conn;
 #endif
 
+   // SQLite only -- compiled statements, keyed by their SQL, so we only parse each one once per connection
+   map<string, sqlite3_stmt *> mPreparedStatements;
+   static const S32 MaxPreparedStatements = 32;
+
+   bool mInTransaction;
+   S32 mBatchedWrites;        // Writes done in the current transaction
+
 public:
    Query *query;
    sqlite3 *sqliteDb;
 
+   string poolKey;            // Which connection parameters this was opened with
+
    bool isValid;
    static bool dumpSql;
    
@@ -75,6 +86,106 @@ public:
    ~DbQuery();                      // Destructor
 
    U64 runQuery(const string &sql) const;
+
+   sqlite3_stmt *getPreparedStatement(const string &sql);
+   bool isAlive();
+
+   void beginTransaction();
+   void commitTransaction();
+   bool isInTransaction() const;
+
+   bool setSavepoint();
+   void releaseSavepoint();
+   void rollbackToSavepoint();
+   S32 addBatchedWrite();     // Returns number of writes done in the current transaction
+};
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+// Opening a database connection costs far more than most of the queries we run on it, so connections are
+// kept open and handed out again as they are needed.  Connections are released LIFO, so a thread doing
+// a series of operations will keep getting the same one back.  Thread safe.
+//
+// Batched writes leave a transaction open between uses, so they get a connection of their own that never
+// goes into the shared pool; otherwise someone else's lookup could end up running inside that transaction.
+// Only one thread can hold the batch connection at a time.
+class DbConnectionPool
+{
+private:
+   static const S32 MaxIdleConnections = 8;
+
+   static Vector<DbQuery *> &getIdleConnections();
+   static Mutex &getMutex();
+
+   static DbQuery *&getBatchConnection();
+   static Mutex &getBatchMutex();
+
+public:
+   static DbQuery *acquire(const char *db, const char *server, const char *user, const char *password);
+   static void release(DbQuery *query);
+
+   static DbQuery *acquireBatchConnection(const char *db, const char *server, const char *user, const char *password);
+   static void releaseBatchConnection(DbQuery *query);
+
+   static void commitPendingTransactions();     // Commit any writes batched up on the batch connection
+   static void closeAll();
+};
+
+
+// Borrows a connection from the pool for as long as it is in scope
+class PooledDbQuery
+{
+private:
+   DbQuery *mQuery;
+   bool mIsBatchConnection;
+
+public:
+   PooledDbQuery(const char *db, const char *server, const char *user, const char *password, bool forBatchedWrites = false);
+   ~PooledDbQuery();
+
+   DbQuery &operator*()  { return *mQuery; }
+   DbQuery *operator->() { return mQuery; }
+};
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+// SQL with ? placeholders, and the values to go in them.  On SQLite these are real prepared statements,
+// cached on the connection; mysql++ has no server-side prepared statements, so there we substitute the
+// escaped values into the SQL instead.  Either way, callers never have to sanitize anything themselves.
+class DbStatement
+{
+private:
+   struct Param
+   {
+      bool isText;
+      S64 intValue;
+      string textValue;
+   };
+
+   DbQuery &mQuery;
+   string mSql;
+   Vector<Param> mParams;
+
+   string getSubstitutedSql() const;
+   sqlite3_stmt *bindSqlite();
+
+public:
+   DbStatement(DbQuery &query, const string &sql);
+
+   DbStatement &bind(S32 value);
+   DbStatement &bind(U32 value);
+   DbStatement &bind(S64 value);
+   DbStatement &bind(U64 value);
+   DbStatement &bind(bool value);
+   DbStatement &bind(const string &value);
+   DbStatement &bind(const char *value);
+
+   U64 execute();                                                 // Returns id of inserted row -- throws exceptions!
+   void select(S32 cols, Vector<Vector<string> > &values);        // Appends one row to values per result row
 };
 
 
@@ -92,17 +203,18 @@ private:
    Vector<ServerInfo> cachedServers;
 
    S32 lastGameID;
+   S32 mStatsBatchSize;
 
    void initialize(const char *server, const char *db, const char *user, const char *password);
    void createStatsDatabase();
    string getSqliteSchema();
 
-   U64 getServerID(const DbQuery &query, const string &serverName, const string &serverIP);
+   U64 getServerID(DbQuery &query, const string &serverName, const string &serverIP);
 
    void addToServerCache(U64 id, const string &serverName, const string &serverIPAddr);         // Add database ID to our cache
    U64 getServerIDFromCache(const string &serverName, const string &serverIPAddr);              // And get it back out again
 
-   S32 getServerIdFromDatabase(const DbQuery &query, const string &serverName, const string &serverIP);
+   S32 getServerIdFromDatabase(DbQuery &query, const string &serverName, const string &serverIP);
 
 public:
    DatabaseWriter();
@@ -118,6 +230,10 @@ public:
 
    void setDumpSql(bool dump);
 
+   // Games per stats transaction; 1 commits each game as it arrives
+   void setStatsBatchSize(S32 gamesPerTransaction);
+   static void commitPendingWrites();
+
    void insertStats(const GameStats &gameStats);
    void insertAchievement(U8 achievementId, const StringTableEntry &playerNick, const string &serverName, const string &serverIP);
    void insertLevelInfo(const string &hash, const string &levelName, const string &creator, 
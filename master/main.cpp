@@ -37,15 +37,8 @@ using namespace DbWriter;
 namespace Master
 {
 
-// Create a test database and write some records to it.  Return exit code.
-S32 testDb(const char *dbName)
+static GameStats makeTestGameStats()
 {
-   DatabaseWriter databaseWriter(dbName);
-   databaseWriter.setDumpSql(true);
-
-   databaseWriter.insertAchievement(1, "ChumpChange", "Achievement Server", "99.99.99.99:9999");
-   databaseWriter.insertLevelInfo("9aa6e5f2256c17d2d430b100032b997c", "Clown Car", "Jenkins!", "Core", false, 2, 20, 600);
-
    GameStats gameStats;
    gameStats.build_version = 100;
    gameStats.cs_protocol_version = 101;
@@ -113,7 +106,20 @@ S32 testDb(const char *dbName)
 
    gameStats.teamStats.push_back(teamStats);
 
-   databaseWriter.insertStats(gameStats);
+   return gameStats;
+}
+
+
+// Create a test database and write some records to it.  Return exit code.
+S32 testDb(const char *dbName)
+{
+   DatabaseWriter databaseWriter(dbName);
+   databaseWriter.setDumpSql(true);
+
+   databaseWriter.insertAchievement(1, "ChumpChange", "Achievement Server", "99.99.99.99:9999");
+   databaseWriter.insertLevelInfo("9aa6e5f2256c17d2d430b100032b997c", "Clown Car", "Jenkins!", "Core", false, 2, 20, 600);
+
+   databaseWriter.insertStats(makeTestGameStats());
 
    printf("Created database %s", dbName);
 
@@ -121,6 +127,71 @@ S32 testDb(const char *dbName)
 }
 
 
+// Write gameCount games the way a burst of game reports would arrive, and report how long it took
+static void benchmarkInserts(const char *label, DatabaseWriter &databaseWriter, const GameStats &gameStats, S32 gameCount, bool reconnectEachTime)
+{
+   U32 start = Platform::getRealMilliseconds();
+
+   for(S32 i = 0; i < gameCount; i++)
+   {
+      databaseWriter.insertStats(gameStats);
+
+      if(reconnectEachTime)
+         DbConnectionPool::closeAll();
+   }
+
+   DatabaseWriter::commitPendingWrites();
+
+   U32 elapsed = getMax(Platform::getRealMilliseconds() - start, U32(1));
+   printf("%-40s %6d games in %6d ms (%.1f games/sec)\n", label, gameCount, elapsed, gameCount * 1000.0f / elapsed);
+}
+
+
+static void benchmarkLookups(const char *label, DatabaseWriter &databaseWriter, S32 lookupCount, bool reconnectEachTime)
+{
+   U32 start = Platform::getRealMilliseconds();
+
+   for(S32 i = 0; i < lookupCount; i++)
+   {
+      databaseWriter.getGamesPlayed("Player 1");
+      databaseWriter.getAchievements("ChumpChange");
+
+      if(reconnectEachTime)
+         DbConnectionPool::closeAll();
+   }
+
+   U32 elapsed = getMax(Platform::getRealMilliseconds() - start, U32(1));
+   printf("%-40s %6d lookups in %6d ms (%.1f lookups/sec)\n", label, lookupCount * 2, elapsed, lookupCount * 2000.0f / elapsed);
+}
+
+
+// Time stats writes and player lookups against a scratch SQLite database, with and without connection reuse
+// and batching.  Return exit code.
+S32 benchmarkDb(const char *dbName, S32 gameCount)
+{
+   remove(dbName);
+
+   DatabaseWriter databaseWriter(dbName);
+   GameStats gameStats = makeTestGameStats();
+
+   databaseWriter.insertAchievement(1, "ChumpChange", "Achievement Server", "99.99.99.99:9999");
+
+   benchmarkInserts("New connection per game, no batching", databaseWriter, gameStats, gameCount, true);
+   benchmarkInserts("Pooled connection, no batching",       databaseWriter, gameStats, gameCount, false);
+
+   databaseWriter.setStatsBatchSize(16);
+   benchmarkInserts("Pooled connection, 16 games per commit", databaseWriter, gameStats, gameCount, false);
+
+   benchmarkLookups("New connection per lookup", databaseWriter, gameCount, true);
+   benchmarkLookups("Pooled connection",         databaseWriter, gameCount, false);
+
+   DbConnectionPool::closeAll();
+   remove(dbName);
+
+   return 0;
+}
+
+
 void seedRandomNumberGenerator()
 {
    U32 time = Platform::getRealMilliseconds();
@@ -146,6 +217,9 @@ int main(int argc, const char **argv)
    if(argc == 2 && strcmp(argv[1], "-testdb") == 0)
       exit(testDb("test_db"));
 
+   if(argc >= 2 && strcmp(argv[1], "-benchdb") == 0)
+      exit(benchmarkDb("bench_db", argc >= 3 ? atoi(argv[2]) : 500));
+
    // Configure logging
    S32 events = LogConsumer::AllErrorTypes | LogConsumer::LogConnection | LogConsumer::LogConnectionManager | LogConsumer::LogChat;
 
@@ -34,6 +34,7 @@ MasterSettings::MasterSettings(const string &iniFile)
    mSettings.add(new Setting<U32>   ("Port",                                 25955,            "port",                                 "host"));
    mSettings.add(new Setting<U32>   ("LatestReleasedCSProtocol",               0,              "latest_released_cs_protocol",          "host"));
    mSettings.add(new Setting<U32>   ("LatestReleasedBuildVersion",             0,              "latest_released_client_build_version", "host"));
+   mSettings.add(new Setting<U32>   ("DatabaseWorkerThreads",                  4,              "database_worker_threads",              "host"));
                                                                                                
    // Variables for managing access to MySQL                                                   
    mSettings.add(new Setting<string>("MySqlAddress",                           "",             "phpbb_database_address",               "phpbb"));
@@ -50,6 +51,7 @@ MasterSettings::MasterSettings(const string &iniFile)
    mSettings.add(new Setting<string>("StatsDatabaseName",                      "",             "stats_database_name",                  "stats"));
    mSettings.add(new Setting<string>("StatsDatabaseUsername",                  "",             "stats_database_username",              "stats"));
    mSettings.add(new Setting<string>("StatsDatabasePassword",                  "",             "stats_database_password",              "stats"));
+   mSettings.add(new Setting<U32>   ("StatsGamesPerTransaction",               16,             "stats_games_per_transaction",          "stats"));
 
    // GameJolt settings
    mSettings.add(new Setting<YesNo> ("UseGameJolt",                            Yes,            "UseGameJolt",                          "GameJolt"));
@@ -194,7 +196,11 @@ MasterServer::MasterServer(MasterSettings *settings)
 
    mJsonWritingSuspended = false;
    
-   mDatabaseAccessThread = new DatabaseAccessThread();    // Deleted in destructor
+   // Deleted in destructor
+   mDatabaseAccessThread = new DatabaseAccessThread(mSettings->getVal<U32>("DatabaseWorkerThreads"));
+
+   // Stats are written in batches while games are pouring in; whenever the rush stops, commit what we have
+   mDatabaseAccessThread->setOutOfWorkCallback(DbWriter::DatabaseWriter::commitPendingWrites);
 
    MasterServerConnection::setMasterServer(this);
 }
@@ -206,6 +212,8 @@ MasterServer::~MasterServer()
    delete mNetInterface;
 
    delete mDatabaseAccessThread;
+
+   DbWriter::DbConnectionPool::closeAll();      // Commits anything still batched up
 }
 
 
@@ -250,6 +258,12 @@ void MasterServer::writeJsonNow()
 }
 
 
+JsonServerList *MasterServer::getJsonServerList()
+{
+   return &mJsonServerList;
+}
+
+
 const Vector<MasterServerConnection *> *MasterServer::getServerList() const
 {
    return &mServerList;
@@ -265,18 +279,21 @@ const Vector<MasterServerConnection *> *MasterServer::getClientList() const
 void MasterServer::addServer(MasterServerConnection *server)
 {
    mServerList.push_back(server);
+   server->updateJsonEntry();
 }
 
 
 void MasterServer::addClient(MasterServerConnection *client)
 {
    mClientList.push_back(client);
+   client->updateJsonEntry();
 }
 
 
 void MasterServer::removeServer(S32 index)
 {
    TNLAssert(index >= 0 && index < mServerList.size(), "Index out of range!");
+   mJsonServerList.removeServer(mServerList[index]);
    mServerList.erase_fast(index);
 }
 
@@ -284,6 +301,7 @@ void MasterServer::removeServer(S32 index)
 void MasterServer::removeClient(S32 index)
 {
    TNLAssert(index >= 0 && index < mClientList.size(), "Index out of range!");
+   mJsonServerList.removePlayer(mClientList[index]);
    mClientList.erase_fast(index);
 }
 
@@ -310,6 +328,10 @@ void MasterServer::idle(const U32 timeDelta)
    if(mCleanupTimer.update(timeDelta))
    {
       MasterServerConnection::removeOldEntriesFromRatingsCache();    //<== need non-static access
+
+      mDatabaseAccessThread->logStats();
+      mDatabaseAccessThread->resetStats();
+
       mCleanupTimer.reset();
    }
 
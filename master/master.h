@@ -6,6 +6,7 @@
 #include "masterInterface.h"
 
 #include "MasterServerConnection.h"
+#include "JsonServerList.h"
 
 #include "../zap/IniFile.h"
 
@@ -75,6 +76,7 @@ private:
 
    Timer mJsonWriteTimer;
    bool mJsonWritingSuspended;
+   JsonServerList mJsonServerList;
 
    Timer mPingGameJoltTimer;
 
@@ -104,6 +106,7 @@ public:
    DatabaseAccessThread *getDatabaseAccessThread();
    void writeJsonDelayed();
    void writeJsonNow();
+   JsonServerList *getJsonServerList();
 
    const Vector<MasterServerConnection *> *getServerList() const;
    const Vector<MasterServerConnection *> *getClientList() const;
@@ -38,6 +38,7 @@ DataChunker::DataChunker(S32 size)
    curBlock           = new DataBlock(size);
    curBlock->next     = NULL;
    curBlock->curIndex = 0;
+   spareBlocks        = NULL;
 }
 
 DataChunker::~DataChunker()
@@ -52,7 +53,12 @@ void *DataChunker::alloc(S32 size)
 
    if(!curBlock || size + curBlock->curIndex > chunkSize)
    {
-      DataBlock *temp = new DataBlock(chunkSize);
+      DataBlock *temp = spareBlocks;
+      if(temp)
+         spareBlocks = temp->next;
+      else
+         temp = new DataBlock(chunkSize);
+
       temp->next = curBlock;
       temp->curIndex = 0;
       curBlock = temp;
@@ -80,6 +86,30 @@ void DataChunker::freeBlocks()
       delete curBlock;
       curBlock = temp;
    }
+
+   while(spareBlocks)
+   {
+      DataBlock *temp = spareBlocks->next;
+      delete spareBlocks;
+      spareBlocks = temp;
+   }
+}
+
+void DataChunker::reset()
+{
+   if(!curBlock)
+      return;
+
+   // Keep the current page in place, and park the rest for alloc to pick up again
+   while(curBlock->next)
+   {
+      DataBlock *temp = curBlock->next;
+      curBlock->next = temp->next;
+      temp->next = spareBlocks;
+      spareBlocks = temp;
+   }
+
+   curBlock->curIndex = 0;
 }
 
 };
@@ -549,9 +549,10 @@ void NetConnection::readPacketRateInfo(BitStream *bstream)
    }
 }
 
-void NetConnection::useZeroLatencyForTesting()
+void NetConnection::useZeroLatencyForTesting(bool zeroLatency)
 {
-   mUseZeroLatencyForTesting = true;
+   mUseZeroLatencyForTesting = zeroLatency;
+   computeNegotiatedRate();
 }
 
 void NetConnection::computeNegotiatedRate()
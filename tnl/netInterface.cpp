@@ -50,6 +50,7 @@ NetInterface::NetInterface(const Address &bindAddress) : mSocket(bindAddress)
    mRequiresKeyExchange = false;
 
    Random::read(mRandomHashData, sizeof(mRandomHashData));
+   mConnectRateLimiter.setHashSalt(Random::readI());
 
    mConnectionHashTable.resize(129);
    for(S32 i = 0; i < mConnectionHashTable.size(); i++)
@@ -137,7 +138,7 @@ void NetInterface::sendtoDelayed(const Address *address, NetConnection *receiveT
 // NetInterface utility functions
 //-----------------------------------------------------------------------------
 
-U32 NetInterface::computeClientIdentityToken(const Address &address, const Nonce &theNonce)
+U32 NetInterface::computeClientIdentityToken(const Address &address, const Nonce &theNonce, const Nonce &serverNonce)
 {
    hash_state hashState;
    U32 hash[8];
@@ -146,12 +147,137 @@ U32 NetInterface::computeClientIdentityToken(const Address &address, const Nonce
    sha256_process(&hashState, (const U8 *) &address.port, sizeof(address.port));
    sha256_process(&hashState, (const U8 *) address.netNum, sizeof(address.netNum));
    sha256_process(&hashState, theNonce.data, Nonce::NonceSize);
+   sha256_process(&hashState, serverNonce.data, Nonce::NonceSize);
    sha256_process(&hashState, mRandomHashData, sizeof(mRandomHashData));
    sha256_done(&hashState, (U8 *) hash);
 
    return hash[0];
 }
 
+bool NetInterface::checkConnectRateLimit(const Address &address, U8 packetType)
+{
+   // Hosts we're connected to, or are arranging a connection with, have already shown they really are at that
+   // address, so a flood from spoofed ones mustn't be able to crowd them out of the global bucket
+   bool knownHost = findConnection(address) || findPendingConnection(address);
+
+   if(mConnectRateLimiter.allow(address, getCurrentTime(), knownHost))
+      return true;
+
+   if(packetType == ConnectChallengeRequest)
+      mFloodStats.challengeRequestsDropped++;
+   else
+      mFloodStats.connectRequestsDropped++;
+
+   return false;
+}
+
+//-----------------------------------------------------------------------------
+// ConnectRateLimiter
+//-----------------------------------------------------------------------------
+
+ConnectRateLimiter::ConnectRateLimiter()
+{
+   // A legitimate client sends at most a handful of challenge and connect requests while it
+   // connects, but several clients may share a NAT'd address or a network, so be generous there
+   Limit addressLimit = {   4,  16 };
+   Limit networkLimit = {  16,  64 };
+   Limit globalLimit  = { 128, 256 };
+
+   mHashSalt = 0;
+   mEnabled = true;
+
+   setLimits(addressLimit, networkLimit, globalLimit);
+}
+
+void ConnectRateLimiter::setLimits(const Limit &addressLimit, const Limit &networkLimit, const Limit &globalLimit)
+{
+   mAddressLimit = addressLimit;
+   mNetworkLimit = networkLimit;
+   mGlobalLimit = globalLimit;
+
+   reset();
+}
+
+void ConnectRateLimiter::reset()
+{
+   for(U32 i = 0; i < TableSize; i++)
+   {
+      mAddressBuckets[i].inUse = false;
+      mNetworkBuckets[i].inUse = false;
+   }
+   mGlobalBucket.inUse = false;
+}
+
+U32 ConnectRateLimiter::hashKey(U32 key) const
+{
+   // Fibonacci hashing; the salt keeps remote hosts from choosing addresses that all collide
+   U32 hash = (key ^ mHashSalt) * 2654435761U;
+   return (hash >> 16) & (TableSize - 1);
+}
+
+void ConnectRateLimiter::refill(Bucket &bucket, const Limit &limit, U32 currentTime)
+{
+   U32 elapsed = currentTime - bucket.lastUpdateTime;
+   U32 maxTokens = limit.burst * TokenScale;
+
+   // Rate is in packets per second and tokens are in thousandths, so milliseconds * rate is exactly right
+   if(elapsed >= maxTokens / limit.ratePerSecond)
+      bucket.tokens = maxTokens;
+   else
+      bucket.tokens = getMin(bucket.tokens + elapsed * limit.ratePerSecond, maxTokens);
+
+   bucket.lastUpdateTime = currentTime;
+}
+
+bool ConnectRateLimiter::take(Bucket &bucket, U32 key, const Limit &limit, U32 currentTime)
+{
+   if(limit.ratePerSecond == 0)
+      return true;
+
+   if(!bucket.inUse || bucket.key != key)
+   {
+      bucket.inUse = true;
+      bucket.key = key;
+      bucket.tokens = limit.burst * TokenScale;
+      bucket.lastUpdateTime = currentTime;
+   }
+   else
+      refill(bucket, limit, currentTime);
+
+   if(bucket.tokens < TokenScale)
+      return false;
+
+   bucket.tokens -= TokenScale;
+   return true;
+}
+
+bool ConnectRateLimiter::allow(const Address &address, U32 currentTime, bool knownHost)
+{
+   if(!mEnabled)
+      return true;
+
+   U32 host = address.netNum[0];
+
+   // Packets from ourselves are never throttled -- that's the local client of a hosted game
+   if(address.transport == IPProtocol && (host >> 24) == 127)
+      return true;
+
+   U32 network = host & (~U32(0) << (32 - NetworkPrefixBits));
+
+   // Check the most specific bucket first, so a single noisy host burns its own tokens before
+   // it starts eating into the ones its neighbors and everybody else need
+   if(!take(mAddressBuckets[hashKey(host)], host, mAddressLimit, currentTime))
+      return false;
+
+   if(!take(mNetworkBuckets[hashKey(network)], network, mNetworkLimit, currentTime))
+      return false;
+
+   if(knownHost)
+      return true;
+
+   return take(mGlobalBucket, 0, mGlobalLimit, currentTime);
+}
+
 //-----------------------------------------------------------------------------
 // NetInterface pending connection list management
 //-----------------------------------------------------------------------------
@@ -492,6 +618,12 @@ void NetInterface::processPacket(const Address &sourceAddress, BitStream *pStrea
          handleInfoPacket(sourceAddress, packetType, pStream);
       else
       {
+         // Unsolicited handshake packets have to get past the rate limiter before we spend any
+         // effort on them.  This is the first line of defense against connect floods.
+         if((packetType == ConnectChallengeRequest || packetType == ConnectRequest || packetType == ArrangedConnectRequest) &&
+               !checkConnectRateLimit(sourceAddress, packetType))
+            return;
+
          // Check if there's a connection already:
          switch(packetType)
          {
@@ -578,12 +710,13 @@ void NetInterface::sendConnectChallengeResponse(const Address &addr, Nonce &clie
    out.write(U8(ConnectChallengeResponse));
    clientNonce.write(&out);
 
-   U32 identityToken = computeClientIdentityToken(addr, clientNonce);
-   out.write(identityToken);
-
    // write out a client puzzle
    Nonce serverNonce = mPuzzleManager.getCurrentNonce();
    U32 difficulty = mPuzzleManager.getCurrentDifficulty();
+
+   U32 identityToken = computeClientIdentityToken(addr, clientNonce, serverNonce);
+   out.write(identityToken);
+
    serverNonce.write(&out);
    out.write(difficulty);
 
@@ -745,8 +878,14 @@ void NetInterface::handleConnectRequest(const Address &address, BitStream *strea
    theParams.mServerNonce.read(stream);
    stream->read(&theParams.mClientIdentity);
 
-   if(theParams.mClientIdentity != computeClientIdentityToken(address, theParams.mNonce))
+   // Our cookie is only good for the puzzle nonce it was issued with; checking that nonce is a
+   // cheap way to discard stale or forged requests before we hash anything
+   if(!mPuzzleManager.isServerNonceValid(theParams.mServerNonce) ||
+         theParams.mClientIdentity != computeClientIdentityToken(address, theParams.mNonce, theParams.mServerNonce))
+   {
+      mFloodStats.invalidCookies++;
       return;
+   }
 
    stream->read(&theParams.mPuzzleDifficulty);
    stream->read(&theParams.mPuzzleSolution);
@@ -774,6 +913,7 @@ void NetInterface::handleConnectRequest(const Address &address, BitStream *strea
 
    if(result != ClientPuzzleManager::Success)      // Wrong answer!
    {
+      mFloodStats.puzzleRejects++;
       sendConnectReject(&theParams, address, NetConnection::ReasonPuzzle);
       return;
    }
@@ -123,9 +123,11 @@ void NetObject::clearMaskBits(U32 orMask)
 
 void NetObject::collapseDirtyList()
 {
-   Vector<NetObject *> tempV;
+#ifdef TNL_ENABLE_ASSERTS
+   Vector<NetObject *> tempV;    // Only used to verify the collapse below
    for(NetObject *t = mDirtyList; t; t = t->mNextDirtyList)
       tempV.push_back(t);
+#endif
 
    for(NetObject *obj = mDirtyList; obj; )
    {
@@ -152,10 +154,12 @@ void NetObject::collapseDirtyList()
       obj = next;
    }
    mDirtyList = NULL;
+#ifdef TNL_ENABLE_ASSERTS
    for(S32 i = 0; i < tempV.size(); i++)
    {
       TNLAssert(tempV[i]->mNextDirtyList == NULL && tempV[i]->mPrevDirtyList == NULL && tempV[i]->mDirtyMaskBits == 0, "Error in collapse");
    }
+#endif
 }
 
 bool NetObject::onGhostAdd(GhostConnection *theConnection)
@@ -42,6 +42,11 @@
 #include <unistd.h>
 #include <signal.h>
 #include <sys/time.h>
+#include <time.h>
+
+#if defined (TNL_OS_MAC_OSX)
+#include <mach/mach_time.h>
+#endif
 
 #endif
 
@@ -416,17 +421,35 @@ U32 x86UNIXGetTickCountMicro()
 
 class UnixTimer
 {
+#if defined (TNL_OS_MAC_OSX)
+      F64 mPeriod;      // Microseconds per mach_absolute_time() tick
+#endif
    public:
       UnixTimer()
       {
+#if defined (TNL_OS_MAC_OSX)
+         mach_timebase_info_data_t info;
+         mach_timebase_info(&info);
+         mPeriod = F64(info.numer) / F64(info.denom) / 1000.0;
+#endif
       }
+      // Microsecond resolution -- x86UNIXGetTickCount() only gives us whole ms, which is too coarse for timing
+      // anything that happens within a frame.  The monotonic clock won't jump if someone resets the system time.
       S64 getCurrentTime()
       {
-         return x86UNIXGetTickCount();
+#if defined (TNL_OS_MAC_OSX)
+         // OS X only got clock_gettime() in 10.12, but mach_absolute_time() is monotonic too, and has been there forever
+         return S64(F64(mach_absolute_time()) * mPeriod);
+#else
+         timespec t;
+         ::clock_gettime(CLOCK_MONOTONIC, &t);
+
+         return S64(t.tv_sec) * 1000000 + t.tv_nsec / 1000;
+#endif
       }
       F64 convertToMS(S64 delta)
       {
-         return F64(delta);
+         return F64(delta) / 1000.0;
       }
 };
 
@@ -135,6 +135,9 @@ public:
    /// Returns the current server nonce
    Nonce getCurrentNonce() { return mCurrentNonce; }
 
+   /// Returns true if serverNonce is the current or previous server nonce, i.e. one a client could still be solving for
+   bool isServerNonceValid(const Nonce &serverNonce) { return serverNonce == mCurrentNonce || serverNonce == mLastNonce; }
+
    /// Returns the current client puzzle difficulty
    U32 getCurrentDifficulty() { return mCurrentDifficulty; }
 };
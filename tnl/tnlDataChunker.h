@@ -47,7 +47,8 @@ namespace TNL {
 ///
 /// Note that new/free/realloc WILL NOT WORK on memory gotten from the
 /// DataChunker. This also only grows (you can call freeBlocks to deallocate
-/// and reset things).
+/// and reset things, or reset to forget every allocation but keep the pages
+/// for reuse).
 class DataChunker
 {
   public:
@@ -68,10 +69,12 @@ class DataChunker
    DataBlock *curBlock;       ///< current page we're allocating data from.  If the
                               ///< data size request is greater than the memory space currently
                               ///< available in the current page, a new page will be allocated.
+   DataBlock *spareBlocks;    ///< pages released by reset, handed out again before we allocate new ones
    S32 chunkSize;             ///< The size allocated for each page in the DataChunker
   public:
    void *alloc(S32 size);     ///< allocate a pointer to memory of size bytes from the DataChunker
    void freeBlocks();         ///< free all pages currently allocated in the DataChunker
+   void reset();              ///< invalidate everything allocated so far, keeping the pages for reuse
 
    DataChunker(S32 size=ChunkSize); ///< Construct a DataChunker with a page size of size bytes.
    ~DataChunker();
@@ -615,7 +615,7 @@ public:
    void setFixedRateParameters( U32 minPacketSendPeriod, U32 minPacketRecvPeriod, U32 maxSendBandwidth, U32 maxRecvBandwidth );
 
    /// Flag to override computed packet size limitations, used for testing to allow tests to run faster than they otherwise would
-   void useZeroLatencyForTesting();    ///< Only for testing purposes!!!
+   void useZeroLatencyForTesting(bool zeroLatency = true);    ///< Only for testing purposes!!!
 
    /// Query the adaptive status of the connection.
    bool isAdaptive()    { return mTypeFlags.test(ConnectionAdaptive | ConnectionRemoteAdaptive); }
@@ -95,6 +95,10 @@ struct ConnectionParameters;
 /// the client puzzle, thereby making a resource depletion DoS attack successively more
 /// difficult to launch.
 ///
+/// Ahead of all of this, unsolicited handshake packets are run past a ConnectRateLimiter,
+/// which drops floods from a single host, network, or the internet at large before they
+/// can cost the server any hashing or key exchange work.
+///
 /// If the server accepts the connection, it sends a connect accept packet that is
 /// encrypted and hashed using the shared secret.  The contents of the packet are
 /// another sequence number (sequence2) and another key (key2).  The sequence numbers 
@@ -140,6 +144,92 @@ struct ConnectionParameters;
 /// of the receiver.
 
 
+/// ConnectRateLimiter throttles unsolicited connection handshake packets.
+///
+/// Every ConnectChallengeRequest, ConnectRequest and ArrangedConnectRequest is run
+/// past the limiter before the NetInterface does any hashing, key exchange or puzzle
+/// validation.  The limiter is a set of token buckets: one per source address, one per
+/// source network (the /24 containing the address), and one shared by everybody, so that
+/// a flood from spoofed random addresses still can't push more than a fixed amount of
+/// handshake work per second onto the game thread.  Hosts we already have a connection
+/// (or pending connection) with skip the global bucket, so such a flood can't lock them out.
+///
+/// Buckets live in fixed size hash tables, so the limiter never allocates.  A collision
+/// simply replaces the old bucket with a full one; that errs on the side of letting
+/// a legitimate host through rather than locking it out.
+class ConnectRateLimiter
+{
+public:
+   enum {
+      TableSize  = 1024,      ///< Number of buckets in each of the per-address and per-network tables; must be a power of 2
+      TokenScale = 1000,      ///< Tokens are stored in thousandths so refills can be computed in whole milliseconds
+      NetworkPrefixBits = 24, ///< Size of the network whose hosts share a per-network bucket
+   };
+
+   /// Refill rate and maximum size of a bucket, both in packets
+   struct Limit
+   {
+      U32 ratePerSecond;
+      U32 burst;
+   };
+
+private:
+   struct Bucket
+   {
+      U32 key;
+      U32 tokens;             ///< In TokenScale units
+      U32 lastUpdateTime;
+      bool inUse;
+   };
+
+   Bucket mAddressBuckets[TableSize];
+   Bucket mNetworkBuckets[TableSize];
+   Bucket mGlobalBucket;
+
+   Limit mAddressLimit;
+   Limit mNetworkLimit;
+   Limit mGlobalLimit;
+
+   U32 mHashSalt;
+   bool mEnabled;
+
+   U32 hashKey(U32 key) const;
+   bool take(Bucket &bucket, U32 key, const Limit &limit, U32 currentTime);
+   void refill(Bucket &bucket, const Limit &limit, U32 currentTime);
+
+public:
+   ConnectRateLimiter();
+
+   /// Sets the limits for each bucket type.  A rate of 0 disables that bucket.
+   void setLimits(const Limit &addressLimit, const Limit &networkLimit, const Limit &globalLimit);
+
+   void setEnabled(bool enabled) { mEnabled = enabled; }
+   bool isEnabled() const { return mEnabled; }
+
+   /// Sets the random value used to scatter addresses across the tables, so remote hosts can't pick colliding addresses
+   void setHashSalt(U32 salt) { mHashSalt = salt; }
+
+   /// Returns true if a handshake packet from the given address may be processed, consuming a token from each bucket.
+   /// A knownHost is only held to its per-address and per-network limits.
+   bool allow(const Address &address, U32 currentTime, bool knownHost = false);
+
+   /// Forgets all buckets
+   void reset();
+};
+
+/// Counters kept by NetInterface about handshake packets it has refused to process.
+struct ConnectFloodStats
+{
+   U32 challengeRequestsDropped;    ///< ConnectChallengeRequests refused by the rate limiter
+   U32 connectRequestsDropped;      ///< ConnectRequests and ArrangedConnectRequests refused by the rate limiter
+   U32 invalidCookies;              ///< ConnectRequests whose identity token was stale, or never issued by us
+   U32 puzzleRejects;               ///< ConnectRequests with a bad puzzle solution or replayed client nonce
+
+   ConnectFloodStats() { clear(); }
+   void clear() { challengeRequestsDropped = connectRequestsDropped = invalidCookies = puzzleRejects = 0; }
+   U32 getTotalDropped() const { return challengeRequestsDropped + connectRequestsDropped + invalidCookies + puzzleRejects; }
+};
+
 class NetInterface : public Object
 {
    friend class NetConnection;
@@ -178,6 +268,8 @@ protected:
    RefPtr<AsymmetricKey> mPrivateKey;  /// The private key used by this NetInterface for secure key exchange.
    RefPtr<Certificate> mCertificate;   /// A certificate, signed by some Certificate Authority, to authenticate this host.
    ClientPuzzleManager mPuzzleManager; /// The object that tracks the current client puzzle difficulty, current puzzle and solutions for this NetInterface.
+   ConnectRateLimiter mConnectRateLimiter; /// Throttles incoming handshake packets before we do any real work on them.
+   ConnectFloodStats mFloodStats;      /// Counts of handshake packets we've dropped.
 
    /// @name NetInterfaceSocket Socket
    ///
@@ -225,9 +317,16 @@ protected:
       PuzzleSolutionTimeout = 30000,   /// If the server gives us a puzzle that takes more than 30 seconds, time out.
    };
 
-   /// Computes an identity token for the connecting client based on the address of the client and the
-   /// client's unique nonce value.
-   U32 computeClientIdentityToken(const Address &theAddress, const Nonce &theNonce);
+   /// Computes an identity token for the connecting client based on the address of the client, the
+   /// client's unique nonce value, and the server puzzle nonce current when the token was issued.
+   ///
+   /// The token acts as a stateless cookie: we keep nothing for a client that has only sent us a
+   /// challenge request, and because the puzzle nonce rotates every ClientPuzzleManager::PuzzleRefreshTime,
+   /// a token stops being accepted within two refresh periods of being issued.
+   U32 computeClientIdentityToken(const Address &theAddress, const Nonce &theNonce, const Nonce &serverNonce);
+
+   /// Runs an unsolicited handshake packet past the rate limiter, counting it if it is dropped.
+   bool checkConnectRateLimit(const Address &address, U8 packetType);
 
    /// Finds a connection instance that this NetInterface has initiated.
    NetConnection *findPendingConnection(const Address &address);
@@ -381,6 +480,14 @@ public:
 
    /// returns the current process time for this NetInterface
    U32 getCurrentTime() { return mCurrentTime; }
+
+   /// Returns the rate limiter applied to incoming handshake packets, so its limits can be adjusted
+   ConnectRateLimiter &getConnectRateLimiter() { return mConnectRateLimiter; }
+
+   /// Returns counts of handshake packets dropped since the last call to resetConnectFloodStats()
+   const ConnectFloodStats &getConnectFloodStats() const { return mFloodStats; }
+
+   void resetConnectFloodStats() { mFloodStats.clear(); }
 };
 
 };
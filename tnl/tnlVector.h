@@ -31,6 +31,7 @@
 //Includes
 #include <vector>
 #include <algorithm>
+#include <utility>
 
 
 #ifndef _TNL_TYPES_H_
@@ -78,11 +79,13 @@ template<class T> class Vector : public VectorBase<T>
 public:
    Vector(const U32 initialSize = 0);
    Vector(const Vector& p);
+   Vector(Vector&& p);
    Vector(const std::vector<T>& p);
    Vector(const T *array, U32 length);
    ~Vector();
 
    Vector<T>& operator=(const Vector<T>& p);
+   Vector<T>& operator=(Vector<T>&& p);
 
    S32 size() const;
    bool empty() const;
@@ -92,6 +95,8 @@ public:
 
    void push_front(const T&);
    void push_back(const T&);
+   void push_back(T&&);
+   template<class... Args> void emplace_back(Args&&... args);
    T& pop_front();
    T& pop_back();
 
@@ -143,6 +148,11 @@ template<class T> inline Vector<T>::Vector(const Vector& p)        // Copy const
    this->innerVector = p.innerVector;
 }
 
+template<class T> inline Vector<T>::Vector(Vector&& p)             // Move constructor -- takes p's storage, leaving p empty
+{
+   this->innerVector.swap(p.innerVector);
+}
+
 template<class T> inline Vector<T>::Vector(const std::vector<T>& p)        // Constructor to wrap std::vector
 {
    this->innerVector = p;
@@ -298,6 +308,14 @@ template<class T> inline Vector<T>& Vector<T>::operator=(const Vector<T>& p)
    return *this;
 }
 
+// Takes over p's storage rather than copying it; p is left empty
+template<class T> inline Vector<T>& Vector<T>::operator=(Vector<T>&& p)
+{
+   this->innerVector.swap(p.innerVector);
+   p.innerVector.clear();
+   return *this;
+}
+
 template<class T> inline S32 Vector<T>::size() const
 {
    return (S32)this->innerVector.size();
@@ -331,6 +349,17 @@ template<class T> inline void Vector<T>::push_back(const T &x)
    this->innerVector.push_back(x);
 }
 
+template<class T> inline void Vector<T>::push_back(T &&x)
+{
+   this->innerVector.push_back(std::move(x));
+}
+
+// Constructs the new element in place from args
+template<class T> template<class... Args> inline void Vector<T>::emplace_back(Args&&... args)
+{
+   this->innerVector.emplace_back(std::forward<Args>(args)...);
+}
+
 template<class T> inline T& Vector<T>::pop_front()
 {
    TNLAssert(this->innerVector.size() != 0, "Vector is empty");
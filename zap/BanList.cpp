@@ -11,6 +11,7 @@
 
 #include <chrono>
 #include <ctime>
+#include <functional>
 
 namespace Zap
 {
@@ -25,6 +26,10 @@ BanList::BanList(const string &iniDir)
 
    defaultBanDurationMinutes = 60;
    kickDurationMilliseconds = 30 * 1000;     // 30 seconds is a good breather
+
+   mKickClock = 0;
+
+   clearIndices();
 }
 
 
@@ -90,7 +95,7 @@ void BanList::addToBanList(const Address &address, S32 durationMinutes, bool non
    banItem.nickname = nonAuthenticatedOnly ? "*NonAuthenticated" : "*";
    banItem.startDateTime = timeNowToISOString();
 
-   serverBanList.push_back(banItem);
+   addBanItem(banItem);
 }
 
 void BanList::addPlayerNameToBanList(const char *playerName, S32 durationMinutes)
@@ -101,7 +106,7 @@ void BanList::addPlayerNameToBanList(const char *playerName, S32 durationMinutes
    banItem.nickname = playerName;
    banItem.startDateTime = timeNowToISOString();
 
-   serverBanList.push_back(banItem);
+   addBanItem(banItem);
 }
 
 
@@ -133,8 +138,10 @@ bool BanList::processBanListLine(const string &line)
    string startDateTime = words[2];
    string durationMinutes = words[3];
 
-   // Validate IP address string
-   if (!(Address(address.c_str()).isValid()) && address.compare(banListWildcardCharater) != 0)
+   // Validate IP address string; we accept a full address, a wildcard, or a range like 10.1.*.* or 10.1.0.0/16
+   U32 netNum;
+   U8 prefixLength;
+   if(!parseAddressRange(address, netNum, prefixLength))
       return false;
 
    // nickname could be anything...
@@ -166,7 +173,7 @@ bool BanList::processBanListLine(const string &line)
    banItem.startDateTime = startDateTime;
    banItem.durationMinutes = durationMinutes;
 
-   serverBanList.push_back(banItem);
+   addBanItem(banItem);
 
    // Phoew! we made it..
    return true;
@@ -185,41 +192,312 @@ string BanList::banItemToString(BanItem *banItem)
 }
 
 
-bool BanList::isBanned(const Address &address, const string &nickname, bool isAuthenticated)
+// Parse an address column from the ban list.  Returns false if the string is not a usable address.
+// Allowed forms are "*", "a.b.c.d", "a.b.*.*" (trailing octet wildcards), and "a.b.c.d/n" (CIDR).
+bool BanList::parseAddressRange(const string &address, U32 &netNum, U8 &prefixLength) const
 {
-   string addressString = addressToString(address);
-   auto currentTime = system_clock::now();
+   netNum = 0;
+   prefixLength = 0;
+
+   if(address == banListWildcardCharater)
+      return true;
+
+   // Split off CIDR suffix, if there is one
+   string addressPart = address;
+   S32 cidrBits = -1;
 
-   for (S32 i = 0; i < serverBanList.size(); i++)
+   size_t slashPos = address.find('/');
+   if(slashPos != string::npos)
    {
-      // Check IP
-      if (addressString.compare(serverBanList[i].address) != 0 && serverBanList[i].address.compare("*") != 0)
-         continue;
+      addressPart = address.substr(0, slashPos);
+      string bitsPart = address.substr(slashPos + 1);
 
-      // Check if authenticated
-      if (serverBanList[i].nickname.compare("*NonAuthenticated") == 0 && isAuthenticated)
-         continue;
+      if(bitsPart.empty() || bitsPart.length() > 2 || bitsPart.find_first_not_of("0123456789") != string::npos)
+         return false;
 
-      // Check nickname
-      else if (nickname.compare(serverBanList[i].nickname) != 0 && serverBanList[i].nickname.compare("*") != 0)
-         continue;
+      cidrBits = atoi(bitsPart.c_str());
+      if(cidrBits > 32)
+         return false;
+   }
 
-      // Check time
-      time_t banTime = ISOStringToTime(serverBanList[i].startDateTime);
-      auto chronoBanTime = system_clock::from_time_t(banTime);
-      auto timeDifference = duration_cast<minutes>(currentTime - chronoBanTime).count();
+   // We parse dotted quads by hand -- Address::set() will happily do a blocking DNS lookup on anything
+   // it doesn't recognize, which is not something we want to do here
+   Vector<string> octets;
+   parseString(addressPart.c_str(), octets, '.');
 
-      int banDurationMinutes = atoi(serverBanList[i].durationMinutes.c_str());
+   if(octets.size() != 4)
+   {
+      // Could be a hostname or an "ip:" style address; let TNL sort it out (exact matches only)
+      if(cidrBits >= 0 || addressPart.find(banListWildcardCharater) != string::npos)
+         return false;
 
-      // See if ban has run out
-      if (timeDifference < banDurationMinutes)
-         continue;
+      Address parsed(addressPart.c_str());
+      if(!parsed.isValid())
+         return false;
 
-      // If we get here, that means nickname and IP address matched and we are still in the
-      // ban allotted time period
+      netNum = parsed.netNum[0];
+      prefixLength = 32;
       return true;
    }
 
+   S32 fixedOctets = 0;
+   bool seenWildcard = false;
+
+   for(S32 i = 0; i < 4; i++)
+   {
+      if(octets[i] == banListWildcardCharater)
+      {
+         seenWildcard = true;
+         continue;
+      }
+
+      // Once we've hit a wildcard, everything after it must be one too
+      if(seenWildcard)
+         return false;
+
+      if(octets[i].empty() || octets[i].length() > 3 || octets[i].find_first_not_of("0123456789") != string::npos)
+         return false;
+
+      S32 value = atoi(octets[i].c_str());
+      if(value > 255)
+         return false;
+
+      netNum |= U32(value) << (24 - 8 * i);
+      fixedOctets++;
+   }
+
+   if(seenWildcard && cidrBits >= 0)      // Pick one or the other, please
+      return false;
+
+   prefixLength = cidrBits >= 0 ? U8(cidrBits) : U8(fixedOctets * 8);
+
+   // Clear any host bits beyond the prefix so lookups can compare directly
+   if(prefixLength == 0)
+      netNum = 0;
+   else if(prefixLength < 32)
+      netNum &= ~U32(0) << (32 - prefixLength);
+
+   return true;
+}
+
+
+// Compile a ban into its lookup form, and add it to the list and indices
+void BanList::addBanItem(BanItem &banItem)
+{
+   if(!parseAddressRange(banItem.address, banItem.netNum, banItem.prefixLength))
+   {
+      // Shouldn't happen: addresses we generate ourselves are always well formed
+      banItem.netNum = 0;
+      banItem.prefixLength = 32;
+   }
+
+   banItem.anyNickname = (banItem.nickname == banListWildcardCharater);
+   banItem.nonAuthenticatedOnly = (banItem.nickname == "*NonAuthenticated");
+   banItem.expireTime = S64(ISOStringToTime(banItem.startDateTime)) + S64(atoi(banItem.durationMinutes.c_str())) * 60;
+   banItem.indexed = false;
+
+   serverBanList.push_back(banItem);
+   indexBanItem(serverBanList.size() - 1);
+}
+
+
+void BanList::indexBanItem(S32 banIndex)
+{
+   BanItem &banItem = serverBanList[banIndex];
+   bool wildNickname = banItem.anyNickname || banItem.nonAuthenticatedOnly;
+
+   if(banItem.prefixLength == 32)
+      mExactAddressIndex[banItem.netNum].push_back(banIndex);
+
+   else if(banItem.prefixLength == 0)
+   {
+      if(wildNickname)
+         mGlobalBans.push_back(banIndex);
+      else
+         mNicknameIndex[banItem.nickname].push_back(banIndex);
+   }
+
+   else
+   {
+      // Walk down the trie, creating nodes as we go
+      S32 node = 0;
+      for(S32 bit = 0; bit < banItem.prefixLength; bit++)
+      {
+         U32 branch = (banItem.netNum >> (31 - bit)) & 1;
+
+         if(mPrefixTrie[node].child[branch] == 0)
+         {
+            PrefixNode newNode;
+            newNode.child[0] = newNode.child[1] = 0;
+            mPrefixTrie.push_back(newNode);
+
+            mPrefixTrie[node].child[branch] = mPrefixTrie.size() - 1;
+         }
+
+         node = mPrefixTrie[node].child[branch];
+      }
+
+      mPrefixTrie[node].bans.push_back(banIndex);
+   }
+
+   banItem.indexed = true;
+
+   BanExpiry expiry;
+   expiry.expireTime = banItem.expireTime;
+   expiry.banIndex = banIndex;
+
+   mExpiryHeap.push_back(expiry);
+   push_heap(mExpiryHeap.getStlVector().begin(), mExpiryHeap.getStlVector().end(), greater<BanExpiry>());
+}
+
+
+static void removeBanIndex(Vector<S32> &list, S32 banIndex)
+{
+   S32 pos = list.getIndex(banIndex);
+   if(pos != -1)
+      list.erase_fast(pos);
+}
+
+
+// Pull an expired ban out of the lookup structures.  The ban itself stays in serverBanList so
+// that indices held elsewhere remain valid; trie nodes are left in place and reused.
+void BanList::unindexBanItem(S32 banIndex)
+{
+   BanItem &banItem = serverBanList[banIndex];
+
+   if(!banItem.indexed)
+      return;
+
+   bool wildNickname = banItem.anyNickname || banItem.nonAuthenticatedOnly;
+
+   if(banItem.prefixLength == 32)
+   {
+      auto it = mExactAddressIndex.find(banItem.netNum);
+      if(it != mExactAddressIndex.end())
+      {
+         removeBanIndex(it->second, banIndex);
+         if(it->second.size() == 0)
+            mExactAddressIndex.erase(it);
+      }
+   }
+
+   else if(banItem.prefixLength == 0)
+   {
+      if(wildNickname)
+         removeBanIndex(mGlobalBans, banIndex);
+      else
+      {
+         auto it = mNicknameIndex.find(banItem.nickname);
+         if(it != mNicknameIndex.end())
+         {
+            removeBanIndex(it->second, banIndex);
+            if(it->second.size() == 0)
+               mNicknameIndex.erase(it);
+         }
+      }
+   }
+
+   else
+   {
+      S32 node = 0;
+      for(S32 bit = 0; bit < banItem.prefixLength && node != -1; bit++)
+      {
+         S32 next = mPrefixTrie[node].child[(banItem.netNum >> (31 - bit)) & 1];
+         node = (next == 0) ? -1 : next;
+      }
+
+      if(node != -1)
+         removeBanIndex(mPrefixTrie[node].bans, banIndex);
+   }
+
+   banItem.indexed = false;
+}
+
+
+void BanList::clearIndices()
+{
+   mExactAddressIndex.clear();
+   mNicknameIndex.clear();
+   mGlobalBans.clear();
+   mExpiryHeap.clear();
+
+   // Root node always exists
+   PrefixNode root;
+   root.child[0] = root.child[1] = 0;
+
+   mPrefixTrie.clear();
+   mPrefixTrie.push_back(root);
+}
+
+
+// Pop everything off the expiry heap that has run out
+void BanList::removeExpiredBans(S64 now)
+{
+   std::vector<BanExpiry> &heap = mExpiryHeap.getStlVector();
+
+   while(!heap.empty() && heap.front().expireTime <= now)
+   {
+      S32 banIndex = heap.front().banIndex;
+
+      pop_heap(heap.begin(), heap.end(), greater<BanExpiry>());
+      heap.pop_back();
+
+      unindexBanItem(banIndex);
+   }
+}
+
+
+bool BanList::banItemMatches(const BanItem &banItem, const string &nickname, bool isAuthenticated, S64 now) const
+{
+   // Has the ban run out?
+   if(now >= banItem.expireTime)
+      return false;
+
+   if(banItem.nonAuthenticatedOnly)
+      return !isAuthenticated;
+
+   return banItem.anyNickname || banItem.nickname == nickname;
+}
+
+
+bool BanList::isBanned(const Address &address, const string &nickname, bool isAuthenticated)
+{
+   S64 now = S64(time(NULL));
+   U32 netNum = address.netNum[0];
+
+   // Exact address bans
+   auto exact = mExactAddressIndex.find(netNum);
+   if(exact != mExactAddressIndex.end())
+      for(S32 i = 0; i < exact->second.size(); i++)
+         if(banItemMatches(serverBanList[exact->second[i]], nickname, isAuthenticated, now))
+            return true;
+
+   // Address ranges -- walk the trie as far as this address takes us
+   S32 node = 0;
+   for(S32 bit = 0; bit < 32; bit++)
+   {
+      const Vector<S32> &bans = mPrefixTrie[node].bans;
+      for(S32 i = 0; i < bans.size(); i++)
+         if(banItemMatches(serverBanList[bans[i]], nickname, isAuthenticated, now))
+            return true;
+
+      node = mPrefixTrie[node].child[(netNum >> (31 - bit)) & 1];
+      if(node == 0)
+         break;
+   }
+
+   // Nickname bans from any address
+   auto named = mNicknameIndex.find(nickname);
+   if(named != mNicknameIndex.end())
+      for(S32 i = 0; i < named->second.size(); i++)
+         if(banItemMatches(serverBanList[named->second[i]], nickname, isAuthenticated, now))
+            return true;
+
+   // Finally, bans on everybody (usually "*NonAuthenticated")
+   for(S32 i = 0; i < mGlobalBans.size(); i++)
+      if(banItemMatches(serverBanList[mGlobalBans[i]], nickname, isAuthenticated, now))
+         return true;
+
    return false;
 }
 
@@ -261,6 +539,8 @@ Vector<string> BanList::banListToString()
 void BanList::loadBanList(const Vector<string> &banItemList)
 {
    serverBanList.clear();  // Clear old list for /loadini command.
+   clearIndices();
+
    for(S32 i = 0; i < banItemList.size(); i++)
       if(!processBanListLine(banItemList[i]))
          logprintf("Ban list item on line %d is malformed: %s", i+1, banItemList[i].c_str());
@@ -273,33 +553,37 @@ void BanList::kickHost(const Address &address)
 {
    KickedHost h;
    h.address = address;
-   h.kickTimeRemaining = kickDurationMilliseconds;
+   h.kickExpireTime = mKickClock + kickDurationMilliseconds;
    serverKickList.push_back(h);
+
+   mKickedAddressCounts[address.netNum[0]]++;
 }
 
 
 bool BanList::isAddressKicked(const Address &address)
 {
-   for(S32 i = 0; i < serverKickList.size(); i++)
-      if(address.isEqualAddress(serverKickList[i].address))
-         return true;
-
-   return false;
+   return mKickedAddressCounts.find(address.netNum[0]) != mKickedAddressCounts.end();
 }
 
 
+// Called every tick; only touches kicks and bans that have actually expired
 void BanList::updateKickList(U32 timeElapsed)
 {
-   for(S32 i = 0; i < serverKickList.size(); )
+   mKickClock += timeElapsed;
+
+   // Kicks expire in the order they were added, so we only ever need to look at the front
+   while(!serverKickList.empty() && S32(mKickClock - serverKickList.front().kickExpireTime) > 0)
    {
-      if(serverKickList[i].kickTimeRemaining < timeElapsed)
-         serverKickList.erase_fast(i);
-      else
-      {
-         serverKickList[i].kickTimeRemaining -= timeElapsed;
-         i++;
-      }
+      auto it = mKickedAddressCounts.find(serverKickList.front().address.netNum[0]);
+      if(it != mKickedAddressCounts.end() && --it->second <= 0)
+         mKickedAddressCounts.erase(it);
+
+      serverKickList.pop_front();
    }
+
+   // Drop expired bans from the lookup indices while we're here
+   if(!mExpiryHeap.empty())
+      removeExpiredBans(S64(time(NULL)));
 }
 
 
@@ -10,6 +10,8 @@
 #include "tnlUDP.h"
 
 #include <string>
+#include <unordered_map>
+#include <deque>
 
 using namespace TNL;
 using namespace std;
@@ -17,6 +19,11 @@ using namespace std;
 namespace Zap
 {
 
+// Bans are kept in their original string form so they can be written back to the INI unchanged,
+// but every entry is also compiled into an index when it is added.  Exact IP addresses and
+// nicknames live in hash tables, wildcard/CIDR address ranges live in a binary prefix trie, and
+// start time + duration is pre-computed into an integer expiry time.  A min-heap keyed on expiry
+// lets us prune dead bans from the indices without scanning the whole list.
 class BanList
 {
 private:
@@ -26,15 +33,48 @@ private:
       string nickname;
       string startDateTime;
       string durationMinutes;
+
+      // Compiled form of the above
+      U32 netNum;             // Host byte order, only the top prefixLength bits are meaningful
+      U8 prefixLength;        // 32 for a single address, 0 for an address wildcard
+      bool anyNickname;
+      bool nonAuthenticatedOnly;
+      S64 expireTime;         // Seconds since epoch
+      bool indexed;           // False once the ban has expired and been pulled from the indices
    };
 
    struct KickedHost {
       Address address;
-      U32 kickTimeRemaining;
+      U32 kickExpireTime;     // Expressed in mKickClock time
+   };
+
+   // Node of our binary prefix trie, children are indices into mPrefixTrie, 0 meaning "none"
+   struct PrefixNode
+   {
+      S32 child[2];
+      Vector<S32> bans;       // Bans whose range ends at this node
+   };
+
+   // Min-heap element: expiry time of a ban, and its index into serverBanList
+   struct BanExpiry
+   {
+      S64 expireTime;
+      S32 banIndex;
+      bool operator>(const BanExpiry &other) const { return expireTime > other.expireTime; }
    };
 
    Vector<BanItem> serverBanList;
-   Vector<KickedHost> serverKickList;
+
+   unordered_map<U32, Vector<S32> > mExactAddressIndex;   // Full IP address (no wildcards) --> bans
+   unordered_map<string, Vector<S32> > mNicknameIndex;    // Address-wildcard bans with a specific nickname
+   Vector<PrefixNode> mPrefixTrie;                        // Partial address ranges; node 0 is the root
+   Vector<S32> mGlobalBans;                               // Address and nickname both wildcards
+   Vector<BanExpiry> mExpiryHeap;
+
+   // Kicks all have the same duration, so the order they are added is also the order they expire
+   deque<KickedHost> serverKickList;
+   unordered_map<U32, S32> mKickedAddressCounts;          // IPv4 address --> number of live kicks
+   U32 mKickClock;
 
    string banListTokenDelimiter;
    string banListWildcardCharater;
@@ -45,6 +85,14 @@ private:
    bool processBanListLine(const string &line);
    string banItemToString(BanItem *banItem);
 
+   bool parseAddressRange(const string &address, U32 &netNum, U8 &prefixLength) const;
+   void addBanItem(BanItem &banItem);
+   void indexBanItem(S32 banIndex);
+   void unindexBanItem(S32 banIndex);
+   void clearIndices();
+   void removeExpiredBans(S64 now);
+   bool banItemMatches(const BanItem &banItem, const string &nickname, bool isAuthenticated, S64 now) const;
+
 public:
    explicit BanList(const string &iniDir);
    virtual ~BanList();
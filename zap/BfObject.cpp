@@ -467,6 +467,7 @@ void BfObject::setTeam(S32 team)
       return;
 
    mTeam = team;
+   refreshHotState();
    setMaskBits(TeamMask);
 }
 
@@ -996,12 +997,8 @@ S32 BfObject::radiusDamage(Point pos, S32 innerRad, S32 outerRad, TestFunc objec
       if(!getGame()->objectCanDamageObject(info.damagingObject, foundObject))
          continue;
 
-      // Do an LOS check...
-      F32 t;
-      Point n;
-
-      // No damage through walls or forcefields
-      if(findObjectLOS((TestFunc)isWallType, ActualState, pos, objPos, t, n))
+      // Do an LOS check...  No damage through walls
+      if(!getDatabase()->pointCanSeePoint(pos, objPos))
          continue;
 
       // Figure the impulse and damage
@@ -1014,7 +1011,8 @@ S32 BfObject::radiusDamage(Point pos, S32 innerRad, S32 outerRad, TestFunc objec
       //localInfo.collisionPoint  = objPos;
       localInfo.collisionPoint -= info.impulseVector;
 
-      // Reuse t from above to represent interpolation based on distance
+      // t represents interpolation based on distance
+      F32 t;
       F32 dist = delta.len();
       if(dist < innerRad)           // Inner radius gets full force of blast
          t = 1.f;
@@ -1332,6 +1330,7 @@ static const U8 TeamOffset = 2;     // To account for Neutral and Hostile teams
 void BfObject::readThisTeam(BitStream *stream)
 {
    mTeam = stream->readInt(TeamBits) - TeamOffset;
+   refreshHotState();
 }
 
 
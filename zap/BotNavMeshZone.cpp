@@ -784,11 +784,11 @@ Vector<Point> AStar::findPath(const Vector<BotNavMeshZone *> *zones, S32 startZo
          // Add these adjacent child squares to the open list
          //   for later consideration if appropriate.
 
-         Vector<NeighboringZone> neighboringZones = zones->get(parentZone)->mNeighbors;
+         const Vector<NeighboringZone> &neighboringZones = zones->get(parentZone)->mNeighbors;
 
          for(S32 a = 0; a < neighboringZones.size(); a++)
          {
-            NeighboringZone zone = neighboringZones[a];
+            const NeighboringZone &zone = neighboringZones[a];
             S32 zoneID = zone.zoneID;
 
             //   Check if zone is already on the closed list (items on the closed list have
@@ -0,0 +1,244 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "BotPerception.h"
+
+#include "gameType.h"
+#include "robot.h"
+#include "ServerGame.h"
+
+namespace Zap
+{
+
+static bool pointLess(const Point &a, const Point &b)
+{
+   return a.x < b.x || (a.x == b.x && a.y < b.y);
+}
+
+
+BotPerception::LosKey::LosKey(const Point &from, const Point &to, LosType type)
+{
+   // Put symmetric queries in a canonical order so A -> B and B -> A share an entry
+   if(pointLess(to, from))
+   {
+      this->from = to;
+      this->to = from;
+   }
+   else
+   {
+      this->from = from;
+      this->to = to;
+   }
+
+   this->type = type;
+}
+
+
+bool BotPerception::LosKey::operator<(const LosKey &other) const
+{
+   if(type != other.type)  return type < other.type;
+   if(from != other.from)  return pointLess(from, other.from);
+   return pointLess(to, other.to);
+}
+
+
+// Constructor
+BotPerception::BotPerception(ServerGame *game)
+{
+   mGame = game;
+   mValid = false;
+}
+
+
+// Destructor
+BotPerception::~BotPerception()
+{
+   // Do nothing
+}
+
+
+// Forget everything; the next query will take a fresh look at the world
+void BotPerception::invalidate()
+{
+   if(!mValid)
+      return;
+
+   mValid = false;
+   mShips.clear();
+   mClosestEnemies.clear();
+   mLos.clear();
+}
+
+
+void BotPerception::build()
+{
+   static Vector<DatabaseObject *> ships;    // Don't disturb the global fillVector; our callers are probably using it
+
+   ships.clear();
+   mGame->getGameObjDatabase()->findObjects((TestFunc)isShipType, ships);
+
+   mShips.resize(ships.size());
+
+   for(S32 i = 0; i < ships.size(); i++)
+   {
+      mShips[i].ship = static_cast<Ship *>(ships[i]);
+      mShips[i].extent = ships[i]->getExtent();
+   }
+
+   mValid = true;
+}
+
+
+// Appends ships overlapping extents (or all ships, if extents is NULL) to fillVector, like GridDatabase::findObjects()
+void BotPerception::findShips(Vector<DatabaseObject *> &fillVector, const Rect *extents)
+{
+   if(!mValid)
+      build();
+
+   for(S32 i = 0; i < mShips.size(); i++)
+   {
+      Ship *ship = mShips[i].ship;
+
+      if(ship && (!extents || mShips[i].extent.intersects(*extents)))
+         fillVector.push_back(ship);
+   }
+}
+
+
+// Drop-in for GridDatabase::findObjects(); ships come from the snapshot, and only the other types hit the database
+void BotPerception::findObjects(const Vector<U8> &types, Vector<DatabaseObject *> &fillVector, const Rect &extents)
+{
+   static Vector<U8> otherTypes;
+
+   otherTypes.clear();
+   bool wantShips = false;
+
+   for(S32 i = 0; i < types.size(); i++)
+      if(isShipType(types[i]))
+         wantShips = true;
+      else
+         otherTypes.push_back(types[i]);
+
+   if(otherTypes.size() > 0)
+      mGame->getGameObjDatabase()->findObjects(otherTypes, fillVector, extents);
+
+   if(!wantShips)
+      return;
+
+   // Both ship types are usually requested together; if only one was, filter for it
+   bool wantPlayers = types.contains(PlayerShipTypeNumber);
+   bool wantRobots  = types.contains(RobotShipTypeNumber);
+
+   S32 first = fillVector.size();
+   findShips(fillVector, &extents);
+
+   if(wantPlayers && wantRobots)
+      return;
+
+   U8 unwanted = wantPlayers ? RobotShipTypeNumber : PlayerShipTypeNumber;
+
+   for(S32 i = fillVector.size() - 1; i >= first; i--)
+      if(fillVector[i]->getObjectTypeNumber() == unwanted)
+         fillVector.erase(i);
+}
+
+
+// Closest ship overlapping extents (or anywhere, if extents is NULL) that robot considers an enemy and can detect
+Ship *BotPerception::findClosestEnemy(Robot *robot, const Rect *extents)
+{
+   if(!mValid)
+      build();
+
+   bool hasSensor = robot->hasModule(ModuleSensor);
+   bool isTeamGame = mGame->getGameType()->isTeamGame();
+   Point pos = robot->getActualPos();
+
+   S32 team = robot->getTeam();
+   const HotStateTable *hotStates = mGame->getGameObjDatabase()->getHotStateTable();
+
+   F32 minDist = F32_MAX;
+   Ship *closest = NULL;
+
+   for(S32 i = 0; i < mShips.size(); i++)
+   {
+      Ship *ship = mShips[i].ship;
+
+      // Ignore self, and anything outside the search area
+      if(!ship || ship == robot || (extents && !mShips[i].extent.intersects(*extents)))
+         continue;
+
+      // Cheap tests first: team and distance come from the hot state table
+      S32 slot = ship->getHotSlot();
+      if(slot == -1)
+         continue;
+
+      // Ignore ships on same team during team games
+      if(isTeamGame && hotStates->getTeam(slot) == team)
+         continue;
+
+      F32 dist = hotStates->getPos(slot).distSquared(pos);
+      if(dist >= minDist)
+         continue;
+
+      // Ignore ship/robot if it's dead or cloaked
+      if(ship->mHasExploded || !ship->isVisible(hasSensor))
+         continue;
+
+      minDist = dist;
+      closest = ship;
+   }
+
+   return closest;
+}
+
+
+// Every bot asks this every tick, so we remember the answers
+Ship *BotPerception::findClosestEnemyInScannerRange(Robot *robot)
+{
+   if(!mValid)
+      build();
+
+   // Only a handful of bots, and clearing a Vector keeps its storage, unlike a map
+   for(S32 i = 0; i < mClosestEnemies.size(); i++)
+      if(mClosestEnemies[i].robot == robot)
+         return mClosestEnemies[i].enemy;
+
+   Point pos = robot->getActualPos();
+   Rect queryRect(pos, pos);
+   queryRect.expand(mGame->computePlayerVisArea(robot));
+
+   Ship *closest = findClosestEnemy(robot, &queryRect);
+   mClosestEnemies.resize(mClosestEnemies.size() + 1);
+   mClosestEnemies.last().robot = robot;
+   mClosestEnemies.last().enemy = closest;
+
+   return closest;
+}
+
+
+bool BotPerception::getCachedLos(const Point &from, const Point &to, LosType type, bool &canSee) const
+{
+   if(!mValid)
+      return false;
+
+   LosMap::const_iterator it = mLos.find(LosKey(from, to, type));
+   if(it == mLos.end())
+      return false;
+
+   canSee = it->second;
+   return true;
+}
+
+
+void BotPerception::cacheLos(const Point &from, const Point &to, LosType type, bool canSee)
+{
+   if(!mValid)
+      build();
+
+   mLos[LosKey(from, to, type)] = canSee;
+}
+
+
+};
@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _BOT_PERCEPTION_H_
+#define _BOT_PERCEPTION_H_
+
+#include "FrameAllocator.h"
+#include "Rect.h"
+
+#include "tnlNetBase.h"    // For SafePtr
+#include "tnlVector.h"
+
+#include <map>
+
+using namespace TNL;
+
+namespace Zap
+{
+
+class DatabaseObject;
+class Robot;
+class ServerGame;
+class Ship;
+
+// What the bots know about the world, gathered at most once per frame and shared by all of them.  Every bot asks
+// the same questions about the same handful of ships each tick -- where are they, which is closest, can I see it --
+// so rather than have each bot query the database and cast its own rays, we answer from here.
+//
+// Ship positions are those at the time of the first query of the frame; ServerGame invalidates the snapshot whenever
+// things may have moved, and EventManager does so before each bot handles any event other than onTick, as those can
+// fire mid-frame.
+class BotPerception
+{
+public:
+   // Ship-wide corridors, as tested by Robot::canSeePoint().  All ships are the same size, so these give the same
+   // answer in either direction.
+   enum LosType {
+      LosCollideable,      // Blocked by anything collideable
+      LosWall,             // Blocked by walls only
+   };
+
+private:
+   struct ShipInfo {
+      SafePtr<Ship> ship;
+      Rect extent;
+   };
+
+   struct ClosestEnemy {
+      Robot *robot;
+      SafePtr<Ship> enemy;
+   };
+
+   struct LosKey {
+      Point from;
+      Point to;
+      LosType type;
+
+      LosKey(const Point &from, const Point &to, LosType type);
+      bool operator<(const LosKey &other) const;
+   };
+
+   // Rebuilt every tick, so the nodes come from the frame arena
+   typedef std::map<LosKey, bool, std::less<LosKey>, FrameStlAllocator<std::pair<const LosKey, bool> > > LosMap;
+
+   ServerGame *mGame;
+   bool mValid;
+
+   Vector<ShipInfo> mShips;
+   Vector<ClosestEnemy> mClosestEnemies;     // Results of findClosestEnemy() at the bot's scanner range; one per bot
+   LosMap mLos;
+
+   void build();
+
+public:
+   explicit BotPerception(ServerGame *game);
+   virtual ~BotPerception();
+
+   void invalidate();
+
+   void findShips(Vector<DatabaseObject *> &fillVector, const Rect *extents = NULL);
+   void findObjects(const Vector<U8> &types, Vector<DatabaseObject *> &fillVector, const Rect &extents);
+
+   Ship *findClosestEnemy(Robot *robot, const Rect *extents);
+   Ship *findClosestEnemyInScannerRange(Robot *robot);
+
+   bool getCachedLos(const Point &from, const Point &to, LosType type, bool &canSee) const;
+   void cacheLos(const Point &from, const Point &to, LosType type, bool canSee);
+};
+
+
+};
+
+#endif
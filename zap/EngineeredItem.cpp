@@ -2102,38 +2102,66 @@ void Turret::idle(IdleCallPath path)
    F32 bestRange = F32_MAX;
    Point bestDelta;
 
+   // Every turret target is a MoveObject, so the first cuts can be made from the hot state table without touching
+   // the objects themselves
+   const HotStateTable *hotStates = getDatabase()->getHotStateTable();
+
    Point delta;
    for(S32 i = 0; i < fillVector.size(); i++)
    {
-      if(isShipType(fillVector[i]->getObjectTypeNumber()))
-      {
-         Ship *potential = static_cast<Ship *>(fillVector[i]);
+      BfObject *potential = static_cast<BfObject *>(fillVector[i]);
 
-         // Is it dead or cloaked?  Carrying objects makes ship visible, except in nexus game
-         if(!potential->isVisible(false) || potential->mHasExploded)
-            continue;
+      S32 slot = potential->getHotSlot();
+      TNLAssert(slot != -1, "Turret targets should all be in the hot state table!");
+
+      S32 team;
+      U8 type;
+      bool mounted;
+      Point targetPos, Vs;
+
+      if(slot != -1)
+      {
+         team      = hotStates->getTeam(slot);
+         type      = hotStates->getType(slot);
+         mounted   = hotStates->hasFlag(slot, HotStateTable::MountedFlag);
+         targetPos = hotStates->getPos(slot);
+         Vs        = hotStates->getVel(slot);
       }
+      else     // Not in the table, so ask the object itself
+      {
+         team      = potential->getTeam();
+         type      = potential->getObjectTypeNumber();
+         mounted   = isMountableItemType(type) && static_cast<MountableItem *>(potential)->isMounted();
+         targetPos = potential->getPos();
+         Vs        = potential->getVel();
+      }
+
+      if(team == getTeam())      // Is target on our team?
+         continue;               // ...if so, skip it!
 
       // Don't target mounted items (like resourceItems and flagItems)
-      if(isMountableItemType(fillVector[i]->getObjectTypeNumber()))
-         if(static_cast<MountableItem *>(fillVector[i])->isMounted())
+      if(mounted)
+         continue;
+
+      if(isShipType(type))
+      {
+         Ship *ship = static_cast<Ship *>(potential);
+
+         // Is it dead or cloaked?  Carrying objects makes ship visible, except in nexus game
+         if(!ship->isVisible(false) || ship->mHasExploded)
             continue;
-      
-      BfObject *potential = static_cast<BfObject *>(fillVector[i]);
-      if(potential->getTeam() == getTeam())     // Is target on our team?
-         continue;                              // ...if so, skip it!
+      }
 
       // Calculate where we have to shoot to hit this...
-      Point Vs = potential->getVel();
       F32 S = (F32)WeaponInfo::getWeaponInfo(mWeaponFireType).projVelocity;
-      Point d = potential->getPos() - aimPos;
+      Point d = targetPos - aimPos;
 
 // This could possibly be combined with Robot's getFiringSolution, as it's essentially the same thing
       F32 t;      // t is set in next statement
       if(!findLowestRootInInterval(Vs.dot(Vs) - S * S, 2 * Vs.dot(d), d.dot(d), WeaponInfo::getWeaponInfo(mWeaponFireType).projLiveTime * 0.001f, t))
          continue;
 
-      Point leadPos = potential->getPos() + Vs * t;
+      Point leadPos = targetPos + Vs * t;
 
       // Calculate distance
       delta = (leadPos - aimPos);
@@ -2146,12 +2174,12 @@ void Turret::idle(IdleCallPath path)
          continue;
 
       // See if we can see it...
-      Point n;
-      if(findObjectLOS((TestFunc)isWallType, ActualState, aimPos, potential->getPos(), t, n))
+      if(!getDatabase()->pointCanSeePoint(aimPos, targetPos))
          continue;
 
       // See if we're gonna clobber our own stuff...
       disableCollision();
+      Point n;
       Point delta2 = delta;
       delta2.normalize(WeaponInfo::getWeaponInfo(mWeaponFireType).projLiveTime * (F32)WeaponInfo::getWeaponInfo(mWeaponFireType).projVelocity / 1000.f);
       BfObject *hitObject = findObjectLOS((TestFunc) isWithHealthType, 0, aimPos, aimPos + delta2, t, n);
@@ -5,9 +5,11 @@
 
 #include "EventManager.h"
 
+#include "BotPerception.h"
 #include "CoreGame.h"
 #include "playerInfo.h"          // For RobotPlayerInfo constructor
 #include "robot.h"
+#include "ServerGame.h"
 #include "Zone.h"
 
 //#include "../lua/luaprofiler-2.0.2/src/luaprofiler.h"      // For... the profiler!
@@ -28,6 +30,7 @@ namespace Zap
 struct Subscription {
    LuaScriptRunner *subscriber;
    ScriptContext context;
+   S32 zoneFilter;            // For zone events, only fire for the zone with this id; NoZoneFilter means fire for all zones
 };
 
 
@@ -38,6 +41,7 @@ static Vector<Subscription>      pendingSubscriptions  [EventManager::EventTypes
 static Vector<LuaScriptRunner *> pendingUnsubscriptions[EventManager::EventTypes];
 
 bool EventManager::mConstructed = false;  // Prevent duplicate instantiation
+F64  EventManager::mTickBudget = 0;       // In ms; 0 means bots may take as long as they like
 
 
 struct EventDef {
@@ -64,6 +68,7 @@ EventManager::EventManager()
 
    mIsPaused = false;
    mStepCount = -1;
+   mNextTickSubscriber = 0;
    mConstructed = true;
 }
 
@@ -101,11 +106,44 @@ EventManager *EventManager::get()
 }
 
 
-void EventManager::subscribe(LuaScriptRunner *subscriber, EventType eventType, ScriptContext context, bool failSilently)
+static bool isZoneEvent(EventManager::EventType eventType)
 {
-   // First, see if we're already subscribed
-   if(isSubscribed(subscriber, eventType) || isPendingSubscribed(subscriber, eventType))
+   return eventType == EventManager::ShipEnteredZoneEvent   || eventType == EventManager::ShipLeftZoneEvent ||
+          eventType == EventManager::ObjectEnteredZoneEvent || eventType == EventManager::ObjectLeftZoneEvent;
+}
+
+
+// Find subscriber's entry in list, or NULL if it's not there
+static Subscription *findSubscription(Vector<Subscription> &list, LuaScriptRunner *subscriber)
+{
+   for(S32 i = 0; i < list.size(); i++)
+      if(list[i].subscriber == subscriber)
+         return &list[i];
+
+   return NULL;
+}
+
+
+void EventManager::subscribe(LuaScriptRunner *subscriber, EventType eventType, ScriptContext context, bool failSilently, S32 zoneFilter)
+{
+   if(zoneFilter != NoZoneFilter && !isZoneEvent(eventType))
+   {
+      logprintf(LogConsumer::LogError, "Only zone events can be filtered by zone id; subscribing to all %s events.",
+                                       eventDefs[eventType].name);
+      zoneFilter = NoZoneFilter;
+   }
+
+   // First, see if we're already subscribed; if so, all we might need to do is change the filter
+   Subscription *existing = findSubscription(subscriptions[eventType], subscriber);
+   if(!existing)
+      existing = findSubscription(pendingSubscriptions[eventType], subscriber);
+
+   if(existing)
+   {
+      existing->zoneFilter = zoneFilter;
+      removeFromPendingUnsubscribeList(subscriber, eventType);    // In case we're resubscribing before an unsubscribe went through
       return;
+   }
 
    lua_State *L = LuaScriptRunner::getL();
 
@@ -127,6 +165,7 @@ void EventManager::subscribe(LuaScriptRunner *subscriber, EventType eventType, S
    Subscription s;
    s.subscriber = subscriber;
    s.context = context;
+   s.zoneFilter = zoneFilter;
 
    pendingSubscriptions[eventType].push_back(s);
    anyPending = true;
@@ -225,6 +264,14 @@ void EventManager::update()
 {
    if(anyPending)
    {
+      // A bot that was waiting its turn when it stopped listening for onTick would otherwise stay deferred, and never
+      // have its move cleared again
+      for(S32 i = 0; i < pendingUnsubscriptions[TickEvent].size(); i++)
+         for(S32 j = 0; j < subscriptions[TickEvent].size(); j++)
+            if(subscriptions[TickEvent][j].subscriber == pendingUnsubscriptions[TickEvent][i] &&
+               subscriptions[TickEvent][j].context == RobotContext)
+               static_cast<Robot *>(subscriptions[TickEvent][j].subscriber)->cancelDeferredThink();
+
       for(S32 i = 0; i < EventTypes; i++)
          for(S32 j = 0; j < pendingUnsubscriptions[i].size(); j++)     // Unsubscribing first means less searching!
             removeFromSubscribedList(pendingUnsubscriptions[i][j], (EventType) i);
@@ -244,7 +291,7 @@ void EventManager::update()
 }
 
 
-// onNexusOpened, onNexusClosed
+// onNexusOpened, onNexusClosed, onGameOver
 void EventManager::fireEvent(EventType eventType)
 {
    if(suppressEvents(eventType))   
@@ -254,8 +301,7 @@ void EventManager::fireEvent(EventType eventType)
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
-      fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
+   fireToSubscribers(L, eventType);
 }
 
 
@@ -265,18 +311,19 @@ void EventManager::fireEvent(EventType eventType, U32 deltaT)
    if(suppressEvents(eventType))   
       return;
 
-   if(eventType == TickEvent)
-      mStepCount--;   
-
    lua_State *L = LuaScriptRunner::getL();
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
+   if(eventType == TickEvent)
    {
-      lua_pushinteger(L, deltaT);   // -- deltaT
-      fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
+      mStepCount--;   
+      fireTickToSubscribers(L, deltaT);
+      return;
    }
+
+   lua_pushinteger(L, deltaT);   // -- deltaT
+   fireToSubscribers(L, eventType);
 }
 
 
@@ -290,11 +337,8 @@ void EventManager::fireEvent(EventType eventType, CoreItem *core)
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
-   {
-      core->push(L);                // -- core
-      fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
-   }
+   core->push(L);                // -- core
+   fireToSubscribers(L, eventType);
 }
 
 
@@ -308,11 +352,8 @@ void EventManager::fireEvent(EventType eventType, Ship *ship)
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
-   {
-      ship->push(L);                // -- ship
-      fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
-   }
+   ship->push(L);                // -- ship
+   fireToSubscribers(L, eventType);
 }
 
 
@@ -326,22 +367,19 @@ void EventManager::fireEvent(EventType eventType, Ship *ship, BfObject *damaging
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
-   {
-      ship->push(L);                // -- ship
+   ship->push(L);                // -- ship
 
-      if(damagingObject)
-         damagingObject->push(L);   // -- ship, damagingObject
-      else
-         lua_pushnil(L);
+   if(damagingObject)
+      damagingObject->push(L);   // -- ship, damagingObject
+   else
+      lua_pushnil(L);
 
-      if(shooter)
-         shooter->push(L);          // -- ship, damagingObject, shooter
-      else
-         lua_pushnil(L);
+   if(shooter)
+      shooter->push(L);          // -- ship, damagingObject, shooter
+   else
+      lua_pushnil(L);
 
-      fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
-   }
+   fireToSubscribers(L, eventType);
 }
 
 
@@ -352,26 +390,24 @@ void EventManager::fireEvent(LuaScriptRunner *sender, EventType eventType, const
    if(suppressEvents(eventType))   
       return;
 
+   // Don't alert sender about own message!
+   if(!hasInterestedSubscribers(eventType, sender))
+      return;
+
    lua_State *L = LuaScriptRunner::getL();
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
-   {
-      if(sender == subscriptions[eventType][i].subscriber)    // Don't alert sender about own message!
-         continue;
+   lua_pushstring(L, message);   // -- message
 
-      lua_pushstring(L, message);   // -- message
-
-      if(playerInfo)
-         playerInfo->push(L);       // -- message, playerInfo
-      else
-         lua_pushnil(L);            
+   if(playerInfo)
+      playerInfo->push(L);       // -- message, playerInfo
+   else
+      lua_pushnil(L);            
 
-      lua_pushboolean(L, global);   // -- message, player, isGlobal
+   lua_pushboolean(L, global);   // -- message, player, isGlobal
 
-      fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
-   }
+   fireToSubscribers(L, eventType, sender);
 }
 
 
@@ -381,18 +417,16 @@ void EventManager::fireEvent(LuaScriptRunner *player, EventType eventType, LuaPl
    if(suppressEvents(eventType))   
       return;
 
+   // Don't trouble player with own joinage or leavage!
+   if(!hasInterestedSubscribers(eventType, player))
+      return;
+
    lua_State *L = LuaScriptRunner::getL();
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
-   {
-      if(player == subscriptions[eventType][i].subscriber)    // Don't trouble player with own joinage or leavage!
-         continue;
-
-      playerInfo->push(L);          // -- playerInfo
-      fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
-   }
+   playerInfo->push(L);          // -- playerInfo
+   fireToSubscribers(L, eventType, player);
 }
 
 
@@ -402,29 +436,21 @@ void EventManager::fireEvent(EventType eventType, Ship *ship, Zone *zone)
    if(suppressEvents(eventType))   
       return;
 
+   // Most zone event subscribers only care about one or two zones, so this usually gets us out of here
+   if(!hasInterestedSubscribers(eventType, NULL, zone->getUserAssignedId()))
+      return;
+
    lua_State *L = LuaScriptRunner::getL();
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
-   {
-      try   
-      {
-         // Passing ship, zone, zoneType, zoneId
-         ship->push(L);                                     // -- ship
-         zone->push(L);                                     // -- ship, zone   
-         lua_pushinteger(L, zone->getObjectTypeNumber());   // -- ship, zone, zone->objTypeNumber
-         lua_pushinteger(L, zone->getUserAssignedId());     // -- ship, zone, zone->objTypeNumber, zone->id
+   // Passing ship, zone, zoneType, zoneId
+   ship->push(L);                                     // -- ship
+   zone->push(L);                                     // -- ship, zone   
+   lua_pushinteger(L, zone->getObjectTypeNumber());   // -- ship, zone, zone->objTypeNumber
+   lua_pushinteger(L, zone->getUserAssignedId());     // -- ship, zone, zone->objTypeNumber, zone->id
 
-         fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
-      }
-      catch(LuaException &e)
-      {
-         handleEventFiringError(L, subscriptions[eventType][i], eventType, e.what());
-         clearStack(L);
-         return;
-      }
-   }
+   fireToSubscribers(L, eventType, NULL, zone->getUserAssignedId());
 }
 
 
@@ -434,63 +460,181 @@ void EventManager::fireEvent(EventType eventType, MoveObject *object, Zone *zone
    if(suppressEvents(eventType))   
       return;
 
+   if(!hasInterestedSubscribers(eventType, NULL, zone->getUserAssignedId()))
+      return;
+
    lua_State *L = LuaScriptRunner::getL();
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
+   // Passing object, zone, zoneType, zoneId
+   object->push(L);                                   // -- object
+   zone->push(L);                                     // -- object, zone   
+   lua_pushinteger(L, zone->getObjectTypeNumber());   // -- object, zone, zone->objTypeNumber
+   lua_pushinteger(L, zone->getUserAssignedId());     // -- object, zone, zone->objTypeNumber, zone->id
+
+   fireToSubscribers(L, eventType, NULL, zone->getUserAssignedId());
+}
+
+
+// onScoreChanged
+void EventManager::fireEvent(EventType eventType, S32 score, S32 team, LuaPlayerInfo *playerInfo)
+{
+   if(suppressEvents(eventType))
+         return;
+
+   lua_State *L = LuaScriptRunner::getL();
+
+   TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
+
+   lua_pushinteger(L, score);   // -- score
+   lua_pushinteger(L, team);    // -- score, team
+
+   if(playerInfo)
+      playerInfo->push(L);      // -- score, team, playerInfo
+   else
+      lua_pushnil(L);
+
+   fireToSubscribers(L, eventType);
+}
+
+
+// Would anyone other than sender hear about this event?  Pass the zone's id for zone events, so we can check the filters.
+bool EventManager::hasInterestedSubscribers(EventType eventType, const LuaScriptRunner *sender, S32 zoneId)
+{
+   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
+      if(isInterested(subscriptions[eventType][i], sender, zoneId))
+         return true;
+
+   return false;
+}
+
+
+bool EventManager::isInterested(const Subscription &subscription, const LuaScriptRunner *sender, S32 zoneId)
+{
+   if(subscription.subscriber == sender)
+      return false;
+
+   if(subscription.zoneFilter != NoZoneFilter && subscription.zoneFilter != zoneId)
+      return false;
+
+   return true;
+}
+
+
+// Everything on the stack is taken to be the event's arguments.  They're pushed only once, by the caller, and each
+// interested subscriber gets a copy, rather than us pushing every object all over again for every subscriber.
+void EventManager::fireToSubscribers(lua_State *L, EventType eventType, const LuaScriptRunner *sender, S32 zoneId)
+{
+   S32 args = lua_gettop(L);
+
    for(S32 i = 0; i < subscriptions[eventType].size(); i++)
    {
-      try   
+      const Subscription &subscription = subscriptions[eventType][i];
+
+      if(!isInterested(subscription, sender, zoneId))
+         continue;
+
+      for(S32 j = 1; j <= args; j++)
+         lua_pushvalue(L, j);       // -- <<args>>, <<copy of args>>
+
+      // Anything but onTick may fire in the middle of a frame, after ships have moved, spawned or died since the bots
+      // last looked around, or from inside another handler that just moved them
+      if(subscription.context == RobotContext)
       {
-         // Passing object, zone, zoneType, zoneId
-         object->push(L);                                   // -- object
-         zone->push(L);                                     // -- object, zone   
-         lua_pushinteger(L, zone->getObjectTypeNumber());   // -- object, zone, zone->objTypeNumber
-         lua_pushinteger(L, zone->getUserAssignedId());     // -- object, zone, zone->objTypeNumber, zone->id
+         Robot *robot = static_cast<Robot *>(subscription.subscriber);
+         if(robot->getGame())
+            static_cast<ServerGame *>(robot->getGame())->getBotPerception()->invalidate();
+      }
 
-         fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
+      try   
+      {
+         fire(L, subscription.subscriber, eventDefs[eventType].function, subscription.context, args);
       }
       catch(LuaException &e)
       {
-         handleEventFiringError(L, subscriptions[eventType][i], eventType, e.what());
-         clearStack(L);
+         handleEventFiringError(L, subscription, eventType, e.what());     // Clears the stack
          return;
       }
    }
+
+   clearStack(L);
 }
 
 
-// onScoreChanged
-void EventManager::fireEvent(EventType eventType, S32 score, S32 team, LuaPlayerInfo *playerInfo)
+// Like fireToSubscribers(), but bots share a time budget.  We start with the bot after the last one we got to on the
+// previous tick, and once the budget is used up, the remaining bots are skipped until next tick, when they will
+// receive all the time that passed in the meantime.  At least one bot runs each tick, so no bot waits forever.
+// Levelgens are few and often drive the game itself, so they always run.
+void EventManager::fireTickToSubscribers(lua_State *L, U32 deltaT)
 {
-   if(suppressEvents(eventType))
-         return;
+   Vector<Subscription> &subscribers = subscriptions[TickEvent];
+   S32 count = subscribers.size();
 
-   lua_State *L = LuaScriptRunner::getL();
+   if(mNextTickSubscriber >= count)
+      mNextTickSubscriber = 0;
 
-   TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
+   S32 first = mNextTickSubscriber;
+   S32 firstSkipped = -1;
+   bool budgetExhausted = false;
+   S64 startTime = Platform::getHighPrecisionTimerValue();
 
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
+   for(S32 i = 0; i < count; i++)
    {
-      lua_pushinteger(L, score);   // -- score
-      lua_pushinteger(L, team);    // -- score, team
+      S32 index = (first + i) % count;
+      const Subscription &subscription = subscribers[index];
 
-      if(playerInfo)
-         playerInfo->push(L);      // -- score, team, playerInfo
-      else
-         lua_pushnil(L);
+      U32 elapsed = deltaT;
+
+      if(subscription.context == RobotContext)
+      {
+         Robot *robot = static_cast<Robot *>(subscription.subscriber);
 
-      fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
+         if(budgetExhausted)
+         {
+            robot->deferThink(deltaT);
+
+            if(firstSkipped == -1)
+               firstSkipped = index;
+            continue;
+         }
+
+         // Bots skipped last time around kept their old move; clear it now, as we did for everyone else
+         if(robot->isThinkDeferred())
+            robot->clearMove();
+
+         elapsed = robot->startThink(deltaT);
+      }
+
+      lua_pushinteger(L, elapsed);  // -- deltaT
+
+      try   
+      {
+         fire(L, subscription.subscriber, eventDefs[TickEvent].function, subscription.context, 1);
+      }
+      catch(LuaException &e)
+      {
+         handleEventFiringError(L, subscription, TickEvent, e.what());     // Clears the stack
+         return;
+      }
+
+      if(mTickBudget > 0 && Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - startTime) > mTickBudget)
+         budgetExhausted = true;
    }
+
+   if(firstSkipped != -1)
+      mNextTickSubscriber = firstSkipped;
+
+   clearStack(L);
 }
 
 
 // Actually fire the event, called by one of the fireEvent() methods above
 // Returns true if there was an error, false if everything ran ok
-bool EventManager::fire(lua_State *L, LuaScriptRunner *scriptRunner, const char *function, ScriptContext context)
+bool EventManager::fire(lua_State *L, LuaScriptRunner *scriptRunner, const char *function, ScriptContext context, S32 args)
 {
    setScriptContext(L, context);
-   return scriptRunner->runCmd(function, 0);
+   return scriptRunner->runCmd(function, 0, args);
 }
 
 
@@ -539,6 +683,13 @@ bool EventManager::isPaused()
 }
 
 
+// Caps the time all bots together may spend in onTick during a single tick; 0 for no limit
+void EventManager::setTickBudget(U32 microseconds)
+{
+   mTickBudget = microseconds / 1000.0;
+}
+
+
 // Each firing of TickEvent is considered a step
 void EventManager::addSteps(S32 steps)
 {
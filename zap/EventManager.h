@@ -81,11 +81,18 @@ private:
    void removeFromPendingUnsubscribeList(LuaScriptRunner *subscriber, EventType eventType);
 
    void handleEventFiringError(lua_State *L, const Subscription &subscriber, EventType eventType, const char *errorMsg);
-   bool fire(lua_State *L, LuaScriptRunner *scriptRunner, const char *function, ScriptContext context);
+   bool fire(lua_State *L, LuaScriptRunner *scriptRunner, const char *function, ScriptContext context, S32 args);
+
+   static bool isInterested(const Subscription &subscription, const LuaScriptRunner *sender, S32 zoneId);
+   bool hasInterestedSubscribers(EventType eventType, const LuaScriptRunner *sender, S32 zoneId = NoZoneFilter);
+   void fireToSubscribers(lua_State *L, EventType eventType, const LuaScriptRunner *sender = NULL, S32 zoneId = NoZoneFilter);
+   void fireTickToSubscribers(lua_State *L, U32 deltaT);
       
    bool mIsPaused;
    S32 mStepCount;           // If running for a certain number of steps, this will be > 0, while mIsPaused will be true
+   S32 mNextTickSubscriber;  // Where the next TickEvent starts, so bots that ran out of budget get to go first
    static bool mConstructed;
+   static F64 mTickBudget;   // Max time bots may spend handling a single TickEvent, in ms
 
 public:
    EventManager();                       // C++ constructor
@@ -102,7 +109,10 @@ public:
    //static Vector<pendingUnsubscriptions *> pendingUnsubscriptions[EventTypes];
    static bool anyPending;
 
-   void subscribe  (LuaScriptRunner *subscriber, EventType eventType, ScriptContext context, bool failSilently = false);
+   static const S32 NoZoneFilter = S32_MIN;
+
+   void subscribe  (LuaScriptRunner *subscriber, EventType eventType, ScriptContext context, bool failSilently = false,
+                    S32 zoneFilter = NoZoneFilter);
    void unsubscribe(LuaScriptRunner *subscriber, EventType eventType);
 
     // Used when bot dies, and we know there won't be subscription conflicts
@@ -126,6 +136,8 @@ public:
    void togglePauseStatus();
    bool isPaused();
    void addSteps(S32 steps);        // Each robot will cause the step counter to decrement
+
+   static void setTickBudget(U32 microseconds);
 };
 
 
@@ -306,11 +306,10 @@ void FontManager::popFontContext()
 }
 
 
-void FontManager::drawStrokeCharacter(const SFG_StrokeFont *font, S32 character)
+// Appends character's strips to lines, as separate line segments, starting offset units to the right; then moves
+// offset past the character.  Collecting a whole string this way lets us draw it all at once.
+void FontManager::addStrokeCharacter(const SFG_StrokeFont *font, S32 character, F32 &offset, Vector<F32> &lines)
 {
-   /*
-    * Draw a stroke character
-    */
    const SFG_StrokeChar *schar;
    const SFG_StrokeStrip *strip;
    S32 i, j;
@@ -331,17 +330,16 @@ void FontManager::drawStrokeCharacter(const SFG_StrokeFont *font, S32 character)
 
    for(i = 0; i < schar->Number; i++, strip++)
    {
-      // I didn't find any strip->Number larger than 34, so I chose a buffer of 64
-      // This may change if we go crazy with i18n some day...
-      static F32 characterVertexArray[128];
-      for(j = 0; j < strip->Number; j++)
+      for(j = 0; j + 1 < strip->Number; j++)
       {
-        characterVertexArray[2*j]     = strip->Vertices[j].X;
-        characterVertexArray[(2*j)+1] = strip->Vertices[j].Y;
+         lines.push_back(strip->Vertices[j].X + offset);
+         lines.push_back(strip->Vertices[j].Y);
+         lines.push_back(strip->Vertices[j + 1].X + offset);
+         lines.push_back(strip->Vertices[j + 1].Y);
       }
-      renderVertexArray(characterVertexArray, strip->Number, GL_LINE_STRIP);
    }
-   glTranslatef( schar->Right, 0.0, 0.0 );
+
+   offset += schar->Right;
 }
 
 
@@ -433,8 +431,16 @@ void FontManager::renderString(F32 size, const char *string)
 
       F32 scaleFactor = size / 120.0f;  // Where does this magic number come from?
       glScalef(scaleFactor, -scaleFactor, 1);
+
+      // One draw call for the whole string, rather than one for every stroke of every character
+      static Vector<F32> lines;
+      lines.clear();
+
+      F32 offset = 0;
       for(S32 i = 0; string[i]; i++)
-         FontManager::drawStrokeCharacter(font->getStrokeFont(), string[i]);
+         FontManager::addStrokeCharacter(font->getStrokeFont(), string[i], offset, lines);
+
+      renderVertexArray(lines.address(), lines.size() / 2, GL_LINES);
 
       glLineWidth(gDefaultLineWidth);
    }
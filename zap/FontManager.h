@@ -7,6 +7,7 @@
 #define _FONT_MANAGER_H_
 
 #include "tnlTypes.h"
+#include "tnlVector.h"
 
 #include "FontContextEnum.h"
 #include "freeglut_stroke.h"     // Our stroke font handler -- include here to resolve namespace grief
@@ -50,7 +51,7 @@ public:
    static sth_stash *getStash();
 
    static void drawTTFString(BfFont *font, const char *string, F32 size);
-   static void drawStrokeCharacter(const SFG_StrokeFont *font, S32 character);
+   static void addStrokeCharacter(const SFG_StrokeFont *font, S32 character, F32 &offset, Vector<F32> &lines);
 
    static S32 getStringLength(const char* string);
 
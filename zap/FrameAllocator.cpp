@@ -0,0 +1,141 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "FrameAllocator.h"
+
+#include "tnlDataChunker.h"
+#include "tnlVector.h"
+
+#include <stdlib.h>
+#include <new>
+
+namespace Zap
+{
+
+static const S32 PageSize = 64 * 1024;
+
+static FrameAllocator::Stats frameStats;
+static FrameAllocator::Stats lastFrameStats;
+static U32 peakBytes = 0;
+
+static Vector<void *> largeBlocks;     // Too big for a page; freed at the next reset
+
+
+// Created on first use, so nothing depends on static initialization order
+static DataChunker &getChunker()
+{
+   static DataChunker chunker(PageSize);
+   return chunker;
+}
+
+
+FrameAllocator::Stats::Stats()
+{
+   allocCount = 0;
+   allocBytes = 0;
+   largeCount = 0;
+   heapCount  = 0;
+}
+
+
+void *FrameAllocator::alloc(size_t size)
+{
+   // DataChunker only promises 4-byte alignment; keep everything on 8 so doubles and 64-bit pointers are happy
+   size = (size + 7) & ~size_t(7);
+
+   frameStats.allocCount++;
+   frameStats.allocBytes += U32(size);
+
+   if(size > size_t(PageSize))
+   {
+      void *block = malloc(size);
+      if(!block)
+         throw std::bad_alloc();
+
+      frameStats.largeCount++;
+      largeBlocks.push_back(block);
+      return block;
+   }
+
+   return getChunker().alloc(S32(size));
+}
+
+
+void FrameAllocator::reset()
+{
+   getChunker().reset();
+
+   for(S32 i = 0; i < largeBlocks.size(); i++)
+      free(largeBlocks[i]);
+   largeBlocks.clear();
+
+   peakBytes = getMax(peakBytes, frameStats.allocBytes);
+
+   lastFrameStats = frameStats;
+   frameStats = Stats();
+}
+
+
+const FrameAllocator::Stats &FrameAllocator::getFrameStats()
+{
+   return frameStats;
+}
+
+
+const FrameAllocator::Stats &FrameAllocator::getLastFrameStats()
+{
+   return lastFrameStats;
+}
+
+
+U32 FrameAllocator::getPeakBytes()
+{
+   return peakBytes;
+}
+
+
+void FrameAllocator::countHeapAlloc()
+{
+   frameStats.heapCount++;
+}
+
+
+};
+
+
+// Build with BF_COUNT_ALLOCATIONS defined to count every heap allocation the game makes, tick by tick.  Not for
+// release builds: it's global, and not thread-safe.
+#ifdef BF_COUNT_ALLOCATIONS
+
+void *operator new(size_t size)
+{
+   Zap::FrameAllocator::countHeapAlloc();
+
+   void *p = malloc(size ? size : 1);
+   if(!p)
+      throw std::bad_alloc();
+
+   return p;
+}
+
+
+void *operator new[](size_t size)
+{
+   return operator new(size);
+}
+
+
+void operator delete(void *p) throw()
+{
+   free(p);
+}
+
+
+void operator delete[](void *p) throw()
+{
+   free(p);
+}
+
+#endif
@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _FRAME_ALLOCATOR_H_
+#define _FRAME_ALLOCATOR_H_
+
+#include "tnlTypes.h"
+
+#include <cstddef>
+
+using namespace TNL;
+
+namespace Zap
+{
+
+// Scratch memory for things that live no longer than one server tick.  Allocation is a pointer bump into pages that
+// are kept from one tick to the next, and nothing is ever freed individually -- ServerGame::idle() calls reset() at
+// the start of each tick, and everything handed out before that is gone.  So don't keep anything from here past the
+// end of the tick, and don't use it from anywhere but the game thread.
+//
+// For STL containers, use FrameStlAllocator below.
+class FrameAllocator
+{
+public:
+   struct Stats {
+      U32 allocCount;      // Allocations served from the arena
+      U32 allocBytes;
+      U32 largeCount;      // Allocations too big for a page, which went to the heap instead
+      U32 heapCount;       // Everything that went through global operator new; only counted with BF_COUNT_ALLOCATIONS
+
+      Stats();
+   };
+
+   static void *alloc(size_t size);
+   static void reset();
+
+   static const Stats &getFrameStats();         // Current tick so far
+   static const Stats &getLastFrameStats();     // The tick before the last reset()
+   static U32 getPeakBytes();                   // Most bytes used in any one tick
+
+   static void countHeapAlloc();                // Instrumentation hook for operator new
+};
+
+
+// Lets STL containers take their memory from the FrameAllocator; deallocate does nothing.  A container using this
+// must be emptied or destroyed before the end of the tick, e.g.:
+//
+//    std::map<Key, Value, std::less<Key>, FrameStlAllocator<std::pair<const Key, Value> > > map;
+template<class T>
+class FrameStlAllocator
+{
+public:
+   typedef T value_type;
+
+   FrameStlAllocator() { /* Do nothing */ }
+   template<class U> FrameStlAllocator(const FrameStlAllocator<U> &) { /* Do nothing */ }
+
+   T *allocate(size_t n)         { return static_cast<T *>(FrameAllocator::alloc(n * sizeof(T))); }
+   void deallocate(T *, size_t)  { /* Do nothing */ }
+
+   template<class U> bool operator==(const FrameStlAllocator<U> &) const { return true;  }
+   template<class U> bool operator!=(const FrameStlAllocator<U> &) const { return false; }
+};
+
+
+};
+
+#endif
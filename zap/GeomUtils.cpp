@@ -1226,7 +1226,7 @@ void splitSelfIntersectingPoly(const Vector<Point> input, Vector<Vector<Point> >
 
 /**
  */
-void splitSelfIntersectingPolys(const Vector<Vector<Point> > input, Vector<Vector<Point> > &result)
+void splitSelfIntersectingPolys(const Vector<Vector<Point> > &input, Vector<Vector<Point> > &result)
 {
    for(S32 i = 0; i < input.size(); i++)
    {
@@ -1402,7 +1402,7 @@ void offsetPolygon(const Vector<Point> *inputPoly, Vector<Point> &outputPoly, co
 
 
 // Convert a list of floats into a list of points, removing all collinear points
-Vector<Point> floatsToPoints(const Vector<F32> floats)
+Vector<Point> floatsToPoints(const Vector<F32> &floats)
 {
    Vector<Point> points;
    points.reserve(floats.size() / 2);
@@ -115,14 +115,14 @@ void offsetPolygon(const Vector<Point> *inputPoly, Vector<Point> &outputPoly, co
 void offsetPolygons(Vector<const Vector<Point> *> &inputPolys, Vector<Vector<Point> > &outputPolys, const F32 offset);
 
 // Convert a list of floats into a list of points, removing all collinear points
-Vector<Point> floatsToPoints(const Vector<F32> floats);
+Vector<Point> floatsToPoints(const Vector<F32> &floats);
 
 // Use Clipper to merge inputPolygons, placing the result in solution
 bool mergePolys(const Vector<const Vector<Point> *> &inputPolygons, Vector<Vector<Point> > &outputPolygons);
 bool mergePolysToPolyTree(const Vector<Vector<Point> > &inputPolygons, PolyTree &solution);
 bool containsHoles(const PolyTree &tree);
 
-void splitSelfIntersectingPolys(const Vector<Vector<Point> > input, Vector<Vector<Point> > &result);
+void splitSelfIntersectingPolys(const Vector<Vector<Point> > &input, Vector<Vector<Point> > &result);
 bool clipPolygons(ClipType operation, const Vector<Vector<Point> > &subject, const Vector<Vector<Point> > &clip, Vector<Vector<Point> > &result, bool merge);
 bool clipPolygonsAsTree(ClipType operation, const Vector<Vector<Point> > &subject, const Vector<Vector<Point> > &clip, PolyTree &solution);
 bool triangulate(const Vector<Vector<Point> > &input, Vector<Vector<Point> > &result);
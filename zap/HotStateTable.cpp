@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "HotStateTable.h"
+
+#include "gridDB.h"
+
+namespace Zap
+{
+
+// Constructor
+HotStateTable::HotStateTable()
+{
+   // Do nothing
+}
+
+
+// Destructor
+HotStateTable::~HotStateTable()
+{
+   // Do nothing
+}
+
+
+// New slots start zeroed; the object fills in the rest
+S32 HotStateTable::acquireSlot(DatabaseObject *object)
+{
+   S32 slot;
+
+   if(mFreeSlots.size() > 0)
+   {
+      slot = mFreeSlots.last();
+      mFreeSlots.pop_back();
+   }
+   else
+   {
+      slot = mObject.size();
+
+      mObject.push_back(NULL);
+      mPosX.push_back(0);
+      mPosY.push_back(0);
+      mVelX.push_back(0);
+      mVelY.push_back(0);
+      mAngle.push_back(0);
+      mRadius.push_back(0);
+      mTeam.push_back(0);
+      mType.push_back(0);
+      mFlags.push_back(0);
+   }
+
+   mObject[slot] = object;
+   setPos(slot, Point(0, 0));
+   setVel(slot, Point(0, 0));
+   mAngle[slot] = 0;
+   mRadius[slot] = 0;
+   mTeam[slot] = 0;
+   mType[slot] = object->getObjectTypeNumber();
+   mFlags[slot] = 0;
+
+   return slot;
+}
+
+
+void HotStateTable::releaseSlot(S32 slot)
+{
+   TNLAssert(mObject[slot], "Releasing a free slot!");
+
+   mObject[slot] = NULL;
+   mFreeSlots.push_back(slot);
+}
+
+
+void HotStateTable::clear()
+{
+   mObject.clear();
+   mPosX.clear();
+   mPosY.clear();
+   mVelX.clear();
+   mVelY.clear();
+   mAngle.clear();
+   mRadius.clear();
+   mTeam.clear();
+   mType.clear();
+   mFlags.clear();
+
+   mFreeSlots.clear();
+}
+
+
+S32 HotStateTable::getSlotCount() const
+{
+   return mObject.size();
+}
+
+
+S32 HotStateTable::getLiveCount() const
+{
+   return mObject.size() - mFreeSlots.size();
+}
+
+
+};
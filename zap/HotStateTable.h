@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _HOT_STATE_TABLE_H_
+#define _HOT_STATE_TABLE_H_
+
+#include "Point.h"
+
+#include "tnlTypes.h"
+#include "tnlVector.h"
+
+using namespace TNL;
+
+namespace Zap
+{
+
+class DatabaseObject;
+
+// The handful of things our tightest loops want to know about moving objects -- where they are, how fast they're
+// going, whose side they're on -- kept side by side in flat arrays instead of scattered across the objects.  Reading
+// an object's position from here is an array lookup; asking the object means chasing its pointer into a big
+// BfObject and making a virtual call.
+//
+// Each MoveObject gets a slot when it goes into a GridDatabase, and keeps it until it comes out; slots are reused,
+// but never move while their object is in the database.  Objects write their own entries whenever their actual
+// (not render) state changes, so the table is always current.
+//
+// Positions are the object's own: a mounted item's entry holds where it was when it was picked up, not where its
+// mount is, so check MountedFlag and ask the object (or its mount) if that matters.
+class HotStateTable
+{
+public:
+   enum Flags {
+      MountedFlag = BIT(0),      // MountableItem riding on a ship
+   };
+
+private:
+   Vector<DatabaseObject *> mObject;      // NULL for free slots
+   Vector<F32> mPosX, mPosY;
+   Vector<F32> mVelX, mVelY;
+   Vector<F32> mAngle;
+   Vector<F32> mRadius;
+   Vector<S32> mTeam;
+   Vector<U8> mType;
+   Vector<U8> mFlags;
+
+   Vector<S32> mFreeSlots;
+
+public:
+   HotStateTable();              // Constructor
+   virtual ~HotStateTable();     // Destructor
+
+   S32 acquireSlot(DatabaseObject *object);
+   void releaseSlot(S32 slot);
+   void clear();
+
+   S32 getSlotCount() const;     // Including free ones
+   S32 getLiveCount() const;
+
+   // Non-virtual, inline, and no pointer chasing; that's the point
+   DatabaseObject *getObject(S32 slot) const    { return mObject[slot];                      }
+   Point getPos(S32 slot) const                 { return Point(mPosX[slot], mPosY[slot]);     }
+   Point getVel(S32 slot) const                 { return Point(mVelX[slot], mVelY[slot]);     }
+   F32 getAngle(S32 slot) const                 { return mAngle[slot];                       }
+   F32 getRadius(S32 slot) const                { return mRadius[slot];                      }
+   S32 getTeam(S32 slot) const                  { return mTeam[slot];                        }
+   U8 getType(S32 slot) const                   { return mType[slot];                        }
+   bool hasFlag(S32 slot, U8 flag) const        { return (mFlags[slot] & flag) != 0;         }
+
+   void setPos(S32 slot, const Point &pos)      { mPosX[slot] = pos.x;  mPosY[slot] = pos.y;  }
+   void setVel(S32 slot, const Point &vel)      { mVelX[slot] = vel.x;  mVelY[slot] = vel.y;  }
+   void setAngle(S32 slot, F32 angle)           { mAngle[slot] = angle;                      }
+   void setRadius(S32 slot, F32 radius)         { mRadius[slot] = radius;                    }
+   void setTeam(S32 slot, S32 team)             { mTeam[slot] = team;                        }
+   void setFlag(S32 slot, U8 flag, bool set)    { mFlags[slot] = set ? (mFlags[slot] | flag) : (mFlags[slot] & ~flag); }
+};
+
+
+};
+
+#endif
@@ -13,6 +13,8 @@
 
 #include "stringUtils.h"      // For itos
 
+#include <unordered_map>
+
 
 namespace Zap
 {
@@ -35,46 +37,101 @@ void checkArgCount(lua_State *L, S32 argsWanted, const char *methodName)
 }
 
 
+// Profiles we've already looked up, keyed on the address of the table (or module name) they came from and the
+// address of the function name.  Callers always pass string literals and static tables, so those addresses never
+// change, and after the first call we can find the profile with a pointer hash rather than a pile of strcmps.
+struct ProfileKey
+{
+   const void *table;
+   const char *functionName;
+
+   bool operator==(const ProfileKey &other) const { return table == other.table && functionName == other.functionName; }
+};
+
+struct ProfileKeyHash
+{
+   size_t operator()(const ProfileKey &key) const
+   {
+      return size_t(key.table) * 31 ^ size_t(key.functionName);
+   }
+};
+
+typedef unordered_map<ProfileKey, const LuaFunctionArgList *, ProfileKeyHash> ResolvedProfileMap;
+
+static ResolvedProfileMap resolvedProfiles;
+
+
+static const LuaFunctionArgList *findResolvedProfile(const void *table, const char *functionName)
+{
+   ProfileKey key = { table, functionName };
+   ResolvedProfileMap::const_iterator it = resolvedProfiles.find(key);
+
+   return it == resolvedProfiles.end() ? NULL : it->second;
+}
+
+
+static void addResolvedProfile(const void *table, const char *functionName, const LuaFunctionArgList *functionArgList)
+{
+   ProfileKey key = { table, functionName };
+   resolvedProfiles[key] = functionArgList;
+}
+
+
 // === Centralized Parameter Checking ===
 // Returns index of matching parameter profile; throws error if it can't find one.  If you get a valid profile index back,
 // you can blindly convert the stack items with the confidence you'll get what you want; no further type checking is required.
 // In writing this function, I tried to be extra clear, perhaps at the expense of slight redundancy.
 S32 checkArgList(lua_State *L, const LuaFunctionProfile *functionInfos, const char *className, const char *functionName)
 {
-   const LuaFunctionProfile *functionInfo = NULL;
+   const LuaFunctionArgList *functionArgList = findResolvedProfile(functionInfos, functionName);
 
-   // First, find the correct profile for this function
-   for(S32 i = 0; functionInfos[i].functionName != NULL; i++)
-      if(strcmp(functionInfos[i].functionName, functionName) == 0)
-      {
-         functionInfo = &functionInfos[i];
-         break;
-      }
+   // First time through, find the correct profile for this function
+   if(!functionArgList)
+   {
+      for(S32 i = 0; functionInfos[i].functionName != NULL; i++)
+         if(strcmp(functionInfos[i].functionName, functionName) == 0)
+         {
+            functionArgList = &functionInfos[i].functionArgList;
+            addResolvedProfile(functionInfos, functionName, functionArgList);
+            break;
+         }
 
-   if(!functionInfo)
-      return -1;
+      if(!functionArgList)
+         return -1;
+   }
 
-   return checkArgList(L, functionInfo->functionArgList, className, functionName);
+   return checkArgList(L, *functionArgList, className, functionName);
 }
 
 
 S32 checkArgList(lua_State *L, const char *moduleName, const char *functionName)
 {
-   ProfileMap profileMap = LuaModuleRegistrarBase::getModuleProfiles();
+   const LuaFunctionArgList *functionArgList = findResolvedProfile(moduleName, functionName);
 
-   ProfileMap::iterator iter = profileMap.find(string(moduleName));
-   if(iter != profileMap.end())
+   if(!functionArgList)
    {
-      vector<LuaStaticFunctionProfile> &profiles = (*iter).second;
-      for(U32 i = 0; i < profiles.size(); i++)
+      // Module profiles are registered before main() and never change after, so pointers into them stay good
+      ProfileMap &profileMap = LuaModuleRegistrarBase::getModuleProfiles();
+
+      ProfileMap::iterator iter = profileMap.find(string(moduleName));
+      if(iter != profileMap.end())
       {
-         if(!strcmp(profiles[i].functionName, functionName))
+         vector<LuaStaticFunctionProfile> &profiles = (*iter).second;
+         for(U32 i = 0; i < profiles.size(); i++)
          {
-            return checkArgList(L, profiles[i].functionArgList, moduleName, functionName);
+            if(!strcmp(profiles[i].functionName, functionName))
+            {
+               functionArgList = &profiles[i].functionArgList;
+               addResolvedProfile(moduleName, functionName, functionArgList);
+               break;
+            }
          }
       }
    }
 
+   if(functionArgList)
+      return checkArgList(L, *functionArgList, moduleName, functionName);
+
    // No matching profile found
    TNLAssert(false, "Function profile not found");
    return -1;
@@ -391,24 +448,52 @@ bool luaIsPoint(lua_State *L, S32 index)
 // object is on the stack at the appropriate index
 Point luaToPoint(lua_State *L, S32 index)
 {
-   // A 'point' should be on the stack
-   lua_getfield(L, index, "x");  // ... point, ..., x
-   F32 x = (F32)lua_tonumber(L, -1);
-   lua_pop(L, 1);
+   if(index < 0)
+      index = index + lua_gettop(L) + 1;
 
-   lua_getfield(L, index, "y");  // ... point, ..., y
-   F32 y = (F32)lua_tonumber(L, -1);
-   lua_pop(L, 1);
+   // A 'point' should be on the stack; its fields are never inherited, so rawget is fine
+   lua_pushliteral(L, "x");      // ... point, ..., "x"
+   lua_rawget(L, index);         // ... point, ..., x
+   lua_pushliteral(L, "y");      // ... point, ..., x, "y"
+   lua_rawget(L, index);         // ... point, ..., x, y
 
-   return Point(x, y);
+   Point point((F32)lua_tonumber(L, -2), (F32)lua_tonumber(L, -1));
+   lua_pop(L, 2);
+
+   return point;
+}
+
+
+// Same as luaIsPoint() followed by luaToPoint(), but only looks the fields up once
+static bool luaReadPoint(lua_State *L, S32 index, Point &point)
+{
+   if(!lua_istable(L, index))
+      return false;
+
+   if(index < 0)
+      index = index + lua_gettop(L) + 1;
+
+   lua_pushliteral(L, "x");      // ... table, ..., "x"
+   lua_rawget(L, index);         // ... table, ..., x
+   lua_pushliteral(L, "y");      // ... table, ..., x, "y"
+   lua_rawget(L, index);         // ... table, ..., x, y
+
+   bool isPoint = lua_isnumber(L, -2) && lua_isnumber(L, -1);
+   if(isPoint)
+      point.set((F32)lua_tonumber(L, -2), (F32)lua_tonumber(L, -1));
+
+   lua_pop(L, 2);
+
+   return isPoint;
 }
 
 
 // Pop a point object off stack, or grab two numbers and create a point from them
 Point getPointOrXY(lua_State *L, S32 index)
 {
-   if(luaIsPoint(L, index))
-      return luaToPoint(L, index);
+   Point point;
+   if(luaReadPoint(L, index, point))
+      return point;
 
    else
    {
@@ -425,12 +510,16 @@ Vector<Point> getPointsOrXYs(lua_State *L, S32 index)
    Vector<Point> points;
    S32 stackDepth = lua_gettop(L);
 
-   if(luaIsPoint(L, index))          // List of points
+   Point point;
+
+   if(luaReadPoint(L, index, point))          // List of points
    {
-      S32 offset = 0;
-      while(index + offset <= stackDepth && luaIsPoint(L, index + offset))
+      points.push_back(point);
+
+      S32 offset = 1;
+      while(index + offset <= stackDepth && luaReadPoint(L, index + offset, point))
       {
-         points.push_back(luaToPoint(L, index + offset));
+         points.push_back(point);
          offset++;
       }
    }
@@ -711,18 +800,63 @@ S32 luaTableCopy(lua_State *L)
 }
 
 
+// Reference into the registry for the metatable luavec.lua gives its points; LUA_NOREF until luavec.lua is loaded
+static S32 pointMetatableRef = LUA_NOREF;
+
+
+// Grab the metatable luavec.lua's points use, so luaPushPoint() can build points itself instead of calling
+// point.new.  Must be run after luavec.lua, and before sandboxing takes getmetatable away.
+void luaRegisterPointMetatable(lua_State *L)
+{
+   pointMetatableRef = LUA_NOREF;      // Any old reference went away with the old lua_State
+
+   lua_getglobal(L, "point");          // point
+   if(lua_istable(L, -1))
+   {
+      lua_getfield(L, -1, "zero");     // point, point.zero
+      if(lua_istable(L, -1) && lua_getmetatable(L, -1))     // point, point.zero, mt
+         pointMetatableRef = luaL_ref(L, LUA_REGISTRYINDEX);  // point, point.zero
+
+      lua_pop(L, 1);                   // point
+   }
+
+   lua_pop(L, 1);                      // -- <<empty stack>>
+
+   if(pointMetatableRef == LUA_NOREF)
+      logprintf(LogConsumer::LogError, "Could not find point metatable; points will be made with point.new");
+}
+
+
+// Points are plain tables, {x=x, y=y}, with luavec.lua's metatable attached, so we can put them together
+// right here without having to call into the interpreter.  Scripts can't tell the difference.
 void luaPushPoint(lua_State *L, F32 x, F32 y)
 {
-   // The luavec.lua script should already be loaded and have the 'point'
-   // methods set up
-   lua_getglobal(L, "point");    // point
-   lua_getfield(L, -1, "new");   // point, new
-   lua_pushnumber(L, x);         // point, new, x
-   lua_pushnumber(L, y);         // point, new, x, y
+   if(pointMetatableRef == LUA_NOREF)
+   {
+      // The luavec.lua script should already be loaded and have the 'point'
+      // methods set up
+      lua_getglobal(L, "point");    // point
+      lua_getfield(L, -1, "new");   // point, new
+      lua_pushnumber(L, x);         // point, new, x
+      lua_pushnumber(L, y);         // point, new, x, y
+
+      // Run
+      lua_call(L, 2, 1);            // point, pt
+      lua_remove(L, -2);            // pt
+      return;
+   }
 
-   // Run
-   lua_call(L, 2, 1);            // point, pt
-   lua_remove(L, -2);            // pt
+   // rawset rather than setfield; the table has no metatable yet, and it saves a string lookup per field
+   lua_createtable(L, 0, 2);                                // pt
+   lua_pushliteral(L, "x");                                 // pt, "x"
+   lua_pushnumber(L, x);                                    // pt, "x", x
+   lua_rawset(L, -3);                                       // pt
+   lua_pushliteral(L, "y");                                 // pt, "y"
+   lua_pushnumber(L, y);                                    // pt, "y", y
+   lua_rawset(L, -3);                                       // pt
+
+   lua_rawgeti(L, LUA_REGISTRYINDEX, pointMetatableRef);    // pt, mt
+   lua_setmetatable(L, -2);                                 // pt
 }
 
 
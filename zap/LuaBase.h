@@ -182,6 +182,7 @@ const char *getString(lua_State *L, S32 index, const char *defaultVal);
 
 S32 luaTableCopy(lua_State *L);
 
+void luaRegisterPointMetatable(lua_State *L);
 void luaPushPoint(lua_State *L, F32 x, F32 y);
 void luaPushPoint(lua_State *L, const Point &pt);
 
@@ -195,6 +196,7 @@ void setScriptContext(lua_State *L, ScriptContext context);
 
 /////
 // Documenting and help
+// The profile lookups are cached on the addresses of moduleName/functionInfos and functionName, so pass string literals
 S32 checkArgList(lua_State *L, const LuaFunctionProfile *functionInfos,   const char *className, const char *functionName);
 S32 checkArgList(lua_State *L, const LuaFunctionArgList &functionArgList, const char *className, const char *functionName);
 S32 checkArgList(lua_State *L, const char *moduleName, const char *functionName);
@@ -18,6 +18,7 @@ extern "C" {
 #include <lua.h>
 #include <lualib.h>
 #include <lauxlib.h>
+#include <luajit.h>
 }
 
 #endif   // _LUA_INC_H_
@@ -26,6 +26,7 @@
 
 #include "tnlLog.h"            // For logprintf
 #include "tnlRandom.h"
+#include "tnlByteBuffer.h"     // For hashing script contents
 
 #include <iostream>            // For enum code
 #include <sstream>             // For enum code
@@ -42,6 +43,11 @@ namespace Zap
 lua_State *LuaScriptRunner::L = NULL;
 string LuaScriptRunner::mScriptingDir;
 
+S32 LuaScriptRunner::mScriptMemoryLimit = 0;
+S32 LuaScriptRunner::mBaseHeapBytes = 0;
+S32 LuaScriptRunner::mCallDepth = 0;
+LuaScriptStats LuaScriptRunner::mStats;
+
 deque<string> LuaScriptRunner::mCachedScripts;
 
 void LuaScriptRunner::clearScriptCache()
@@ -69,6 +75,8 @@ LuaScriptRunner::LuaScriptRunner()
 
    mScriptId = "script" + itos(mNextScriptId++);
    mScriptType = ScriptTypeInvalid;
+   mMemoryUsed = 0;
+   mNextCollection = 0;
 
    LUAW_CONSTRUCTOR_INITIALIZATIONS;
 }
@@ -188,27 +196,6 @@ void LuaScriptRunner::pushStackTracer()
 }
 
 
-// Use this method to load an external script directly into the currently running script's
-// environment.  This loaded script will be cleared when the parent script terminates
-bool LuaScriptRunner::loadCompileRunEnvironmentScript(const string &scriptName) {
-   // The timer is loaded in each script
-   loadCompileScript(joindir(mScriptingDir, scriptName).c_str());
-   setEnvironment();
-
-   S32 err = lua_pcall(L, 0, 0, 0);
-
-   if(err != 0)
-   {
-      logError("Failed to load script %s: %s", scriptName.c_str(), lua_tostring(L, -1));
-
-      clearStack(L);
-      return false;
-   }
-
-   return true;
-}
-
-
 // Loads script from file into a Lua chunk, then runs it.  This has the effect of loading all our functions into the local environment,
 // defining any globals, and executing any "loose" code not defined in a function.  If we're going to get any compile errors, they'll
 // show up here.
@@ -217,8 +204,6 @@ bool LuaScriptRunner::loadScript(bool cacheScript)
    if(mScriptName == "")
       return true;
 
-   static const S32 MAX_CACHE_SIZE = 16;
-
    // On a dedicated server, we'll always cache our scripts; on a regular server, we'll cache script except when the user is testing
    // from the editor.  In that case, we'll want to see script changes take place immediately, and we're willing to pay a small
    // performance penalty on level load to get that.
@@ -229,39 +214,10 @@ bool LuaScriptRunner::loadScript(bool cacheScript)
    {
       pushStackTracer();            // -- _stackTracer
 
-      if(!cacheScript)
+      if(cacheScript)
+         loadCompileCacheScript(mScriptName);
+      else
          loadCompileScript(mScriptName.c_str());
-      else  
-      {
-         bool found = false;
-
-         // Check if script is in our cache
-         S32 cacheSize = (S32)mCachedScripts.size();
-
-         for(S32 i = 0; i < cacheSize; i++)
-            if(mCachedScripts[i] == mScriptName)
-            {
-               found = true;
-               break;
-            }
-
-         if(!found)     // Script is not (yet) cached
-         {
-            if(cacheSize > MAX_CACHE_SIZE)
-            {
-               // Remove oldest script from the cache
-               deleteScript(mCachedScripts.front().c_str());
-               mCachedScripts.pop_front();
-            }
-
-            // Load new script into cache using full name as registry key
-            loadCompileSaveScript(mScriptName.c_str(), mScriptName.c_str());
-            mCachedScripts.push_back(mScriptName);
-         }
-
-         lua_getfield(L, LUA_REGISTRYINDEX, mScriptName.c_str());    // Load script from cache
-      }
-
 
       // If we are here, script loaded and compiled; everything should be dandy.
       TNLAssert((lua_gettop(L) == 2 && lua_isfunction(L, 1) && lua_isfunction(L, 2)) 
@@ -272,7 +228,13 @@ bool LuaScriptRunner::loadScript(bool cacheScript)
       // The script has been compiled, and the result is sitting on the stack.  The next step is to run it; this executes all the 
       // "loose" code and loads the functions into the current environment.  It does not directly execute any of the functions.
       // Any errors are handed off to the stack tracer we pushed onto the stack earlier.
-      if(lua_pcall(L, 0, 0, -2))      // Passing 0 args, expecting none back
+      S32 heapBefore = getHeapBytes();
+
+      mCallDepth++;
+      S32 error = lua_pcall(L, 0, 0, -2);    // Passing 0 args, expecting none back
+      mCallDepth--;
+
+      if(error)
       {
           // We can't load the script as requested.  Sorry!
          string msg = "Error starting script:\n" + string(lua_tostring(L, -1));
@@ -281,7 +243,9 @@ bool LuaScriptRunner::loadScript(bool cacheScript)
       }
 
       clearStack(L);    // Remove the _stackTracer from the stack
-      return true;
+
+      // Tables built by loose code at the top of the script count against its limit too
+      return chargeMemoryUsed(heapBefore);
    }
    catch(LuaException &e)
    {
@@ -298,7 +262,17 @@ bool LuaScriptRunner::runString(const string &code)
 {
    luaL_loadstring(L, code.c_str());
    setEnvironment();
-   return !lua_pcall(L, 0, 0, 0);
+
+   S32 heapBefore = getHeapBytes();
+
+   mCallDepth++;
+   S32 error = lua_pcall(L, 0, 0, 0);
+   mCallDepth--;
+
+   if(error)
+      return false;
+
+   return chargeMemoryUsed(heapBefore);
 }
 
 
@@ -339,7 +313,14 @@ bool LuaScriptRunner::runMain(const Vector<string> &args)
 // Returns true if there was an error, false if everything ran ok
 bool LuaScriptRunner::runCmd(const char *function, S32 returnValues)
 {
-   S32 args = lua_gettop(L);  // Number of args on stack     // -- <<args>>
+   return runCmd(function, returnValues, lua_gettop(L));    // Everything on the stack is an arg
+}
+
+
+// Run function with the top args items on the stack as its arguments; anything below them is left alone
+bool LuaScriptRunner::runCmd(const char *function, S32 returnValues, S32 args)
+{
+   S32 base = lua_gettop(L) - args + 1;                      // -- <<other stuff>>, <<args>>
 
    pushStackTracer();                                        // -- <<args>>, _stackTracer
 
@@ -349,18 +330,28 @@ bool LuaScriptRunner::runCmd(const char *function, S32 returnValues)
    // Reorder the stack a little
    if(args > 0)
    {
-      lua_insert(L, 1);                                      // -- function, <<args>>, _stackTracer
-      lua_insert(L, 1);                                      // -- _stackTracer, function, <<args>>
+      lua_insert(L, base);                                   // -- function, <<args>>, _stackTracer
+      lua_insert(L, base);                                   // -- _stackTracer, function, <<args>>
    }
 
-   S32 error = lua_pcall(L, args, returnValues, -2 - args);  // -- _stackTracer, <<return values>>
+   S32 heapBefore = getHeapBytes();
+
+   mCallDepth++;
+   S32 error = lua_pcall(L, args, returnValues, base);       // -- _stackTracer, <<return values>>
+   mCallDepth--;
 
    if(!error)
    {
-      lua_remove(L, 1);    // Remove _stackTracer            // -- <<return values>>
+      lua_remove(L, base);    // Remove _stackTracer         // -- <<return values>>
 
       // Do not clear stack -- caller probably wants <<return values>>
-      return false;
+      if(chargeMemoryUsed(heapBefore))
+         return false;
+
+      // Script is hogging memory; chargeMemoryUsed() has already said so
+      killScript();
+      lua_settop(L, base - 1);
+      return true;
    }
 
    // There was an error... handle it!
@@ -376,7 +367,188 @@ bool LuaScriptRunner::runCmd(const char *function, S32 returnValues)
    logprintf(LogConsumer::LogError, "Terminating script");
 
    killScript();
-   clearStack(L);
+   lua_settop(L, base - 1);      // Clear out everything we put on the stack
+
+   return true;
+}
+
+
+// Size of the shared Lua heap, in bytes
+S32 LuaScriptRunner::getHeapBytes()
+{
+   return lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+}
+
+
+// We all share one Lua heap, and LuaJIT won't let us install our own allocator on 64-bit builds, so we can't see
+// who allocates what.  Instead we charge each script with how much the heap grew while it was running.  That
+// includes garbage, and garbage other scripts left behind may get collected on our watch, so it is only a rough
+// guide.  Before we hold it against anyone, we collect everything and check it against what is actually live: no
+// script can be holding more than all the live data scripts have added, so a script that makes plenty of garbage
+// but keeps little of it is never terminated.
+//
+// Calls a script makes back into Lua while it is running (e.g. via an event handler) are charged to the outermost
+// call only, so the same growth isn't counted twice.
+//
+// A script whose live data sits just under the limit would go over again with its very next bit of garbage, and
+// full collections are far too slow to do on every call.  So when a collection leaves a script close to the limit,
+// we let it make another eighth of the limit's worth of garbage before collecting again; it may briefly look to be
+// over the limit by that much, but only what's still live when we collect can get it terminated.
+//
+// Returns false, after logging the problem, if the script is over the limit even after a full collection.
+bool LuaScriptRunner::chargeMemoryUsed(S32 heapBefore)
+{
+   if(mCallDepth > 0)
+      return true;
+
+   S32 heapAfter = getHeapBytes();
+
+   mMemoryUsed = getMax(mMemoryUsed + heapAfter - heapBefore, 0);
+   mStats.peakHeapBytes = getMax(mStats.peakHeapBytes, heapAfter);
+
+   if(mScriptMemoryLimit == 0 || mMemoryUsed <= getMax(mScriptMemoryLimit, mNextCollection))
+      return true;
+
+   // Much of that may just be garbage... see how much is really still in use
+   lua_gc(L, LUA_GCCOLLECT, 0);
+   mStats.fullCollections++;
+   mMemoryUsed = getMin(mMemoryUsed, getMax(getHeapBytes() - mBaseHeapBytes, 0));
+
+   if(mMemoryUsed <= mScriptMemoryLimit)
+   {
+      S32 margin = mScriptMemoryLimit / 8;
+      mNextCollection = (mMemoryUsed > S32_MAX - margin) ? S32_MAX : mMemoryUsed + margin;
+      return true;
+   }
+
+   mStats.scriptsKilled++;
+
+   logprintf(LogConsumer::LogError, "%s Script is using too much memory (%d KB, limit is %d KB)\nTerminating script",
+             getErrorMessagePrefix(), mMemoryUsed / 1024, mScriptMemoryLimit / 1024);
+
+   return false;
+}
+
+
+S32 LuaScriptRunner::getMemoryUsed() const
+{
+   return mMemoryUsed;
+}
+
+
+// Limits of 2GB or more are as good as no limit at all, as the Lua heap can't grow that big anyway
+void LuaScriptRunner::setScriptMemoryLimit(S64 bytes)
+{
+   if(bytes <= 0)
+      mScriptMemoryLimit = 0;
+   else if(bytes > S32_MAX)
+      mScriptMemoryLimit = S32_MAX;
+   else
+      mScriptMemoryLimit = S32(bytes);
+}
+
+
+S32 LuaScriptRunner::getScriptMemoryLimit()
+{
+   return mScriptMemoryLimit;
+}
+
+
+LuaScriptStats LuaScriptRunner::getStats()
+{
+   LuaScriptStats stats = mStats;
+   stats.heapBytes = L ? getHeapBytes() : 0;
+   stats.peakHeapBytes = getMax(stats.peakHeapBytes, stats.heapBytes);
+   stats.proxiesAllocated = luaW_getProxyPool().allocated;
+   stats.liveProxies = luaW_getProxyPool().live;
+
+   return stats;
+}
+
+
+void LuaScriptRunner::logStats()
+{
+   if(!L)
+      return;
+
+   LuaScriptStats stats = getStats();
+
+   logprintf(LogConsumer::ServerFilter, "Lua heap %d KB (peak %d KB), %d full collections, %d scripts killed for memory use, JIT traces: %d compiled, %d aborted, %d flushes",
+             stats.heapBytes / 1024, stats.peakHeapBytes / 1024, stats.fullCollections, stats.scriptsKilled, 
+             stats.tracesCompleted, stats.tracesAborted, stats.traceFlushes);
+   logprintf(LogConsumer::ServerFilter, "Lua proxies: %d created, %d live", stats.proxiesAllocated, stats.liveProxies);
+}
+
+
+// Handler for jit.attach(); gets the event name followed by details of the trace, which we ignore
+S32 LuaScriptRunner::luaTraceEvent(lua_State *L)
+{
+   const char *what = lua_tostring(L, 1);
+
+   if(!what)
+      return 0;
+
+   if(strcmp(what, "stop") == 0)
+      mStats.tracesCompleted++;
+   else if(strcmp(what, "abort") == 0)
+      mStats.tracesAborted++;
+   else if(strcmp(what, "flush") == 0)
+      mStats.traceFlushes++;
+
+   return 0;
+}
+
+
+// Must be done before sandboxing, which scripts can't get around
+void LuaScriptRunner::attachTraceListener(lua_State *L)
+{
+   lua_getglobal(L, "jit");                     // -- jit
+
+   if(lua_istable(L, -1))
+   {
+      lua_getfield(L, -1, "attach");            // -- jit, jit.attach
+      lua_pushcfunction(L, luaTraceEvent);      // -- jit, jit.attach, luaTraceEvent
+      lua_pushliteral(L, "trace");              // -- jit, jit.attach, luaTraceEvent, "trace"
+
+      if(lua_pcall(L, 2, 0, 0))                 // -- jit
+      {
+         logprintf(LogConsumer::LogWarning, "Could not attach JIT trace listener: %s", lua_tostring(L, -1));
+         lua_pop(L, 1);
+      }
+   }
+
+   lua_pop(L, 1);                               // -- <<empty stack>>
+}
+
+
+// Turn the JIT compiler on or off, and pass options through to jit.opt.start(), e.g. "hotloop=56 maxtrace=2000".
+// Options can be separated by spaces or commas.  Returns false if the options were not accepted.
+bool LuaScriptRunner::setJitOptions(bool enabled, const string &options)
+{
+   TNLAssert(L, "L not yet instantiated!");
+
+   luaJIT_setmode(L, 0, LUAJIT_MODE_ENGINE | (enabled ? LUAJIT_MODE_ON : LUAJIT_MODE_OFF));
+
+   Vector<string> words = parseString(replaceString(options, ",", " "));
+
+   if(words.size() == 0)
+      return true;
+
+   lua_getglobal(L, "jit");                     // -- jit
+   lua_getfield(L, -1, "opt");                  // -- jit, jit.opt
+   lua_getfield(L, -1, "start");                // -- jit, jit.opt, jit.opt.start
+   lua_remove(L, -2);                           // -- jit, jit.opt.start
+   lua_remove(L, -2);                           // -- jit.opt.start
+
+   for(S32 i = 0; i < words.size(); i++)
+      lua_pushstring(L, words[i].c_str());      // -- jit.opt.start, <<words>>
+
+   if(lua_pcall(L, words.size(), 0, 0))
+   {
+      logprintf(LogConsumer::ConfigurationError, "Invalid Lua JIT options \"%s\": %s", options.c_str(), lua_tostring(L, -1));
+      lua_pop(L, 1);
+      return false;
+   }
 
    return true;
 }
@@ -388,6 +560,7 @@ bool LuaScriptRunner::startLua(const string &scriptingDir)
    TNLAssert(!L, "L should not have been created yet!");
 
    mScriptingDir = scriptingDir;
+   mStats = LuaScriptStats();
 
    // Prepare the Lua global environment
    L = lua_open();               // Create a new Lua interpreter; will be shutdown in the destructor
@@ -412,6 +585,10 @@ bool LuaScriptRunner::startLua(const string &scriptingDir)
       return false;
    }
 
+   // Whatever is live now isn't any script's doing
+   lua_gc(L, LUA_GCCOLLECT, 0);
+   mBaseHeapBytes = getHeapBytes();
+
    return true;
 }
 
@@ -446,12 +623,15 @@ bool LuaScriptRunner::configureNewLuaInstance(lua_State *L)
 
       // Load our vector library
       loadCompileRunHelper("luavec.lua");
+      luaRegisterPointMetatable(L);       // So we can make points without going through point.new
 
       // Load our helper functions and store copies of the compiled code in the registry where we can use them for starting new scripts
       loadCompileSaveHelper("robot_helper_functions.lua",    ROBOT_HELPER_FUNCTIONS_KEY);
       loadCompileSaveHelper("levelgen_helper_functions.lua", LEVELGEN_HELPER_FUNCTIONS_KEY);
       loadCompileSaveHelper("timer.lua",                     SCRIPT_TIMER_KEY);
 
+      attachTraceListener(L);
+
       // Perform sandboxing now
       // Only code executed before this point can access dangerous functions
       loadCompileRunHelper("sandbox.lua");
@@ -482,6 +662,55 @@ void LuaScriptRunner::loadCompileRunHelper(const string &scriptName)
 }
 
 
+// Put the compiled chunk for the specified script file on the stack, compiling it only if we haven't seen this version of the
+// file before.  Chunks are keyed on the file's contents as well as its name, so an edited script is always picked up, and a
+// script that hasn't changed is only compiled once no matter how many bots run it or how many levels use it.
+// All callers of this script have catch blocks, so we can throw errors if something goes wrong.
+void LuaScriptRunner::loadCompileCacheScript(const string &filename)
+{
+   static const S32 MAX_CACHE_SIZE = 16;
+
+   if(!fileExists(filename))
+      throw LuaException("Error compiling script " + filename + "\ncannot open " + filename);
+
+   string source = readFile(filename);
+
+   ByteBuffer sourceBuffer((U8 *)source.c_str(), (U32)source.size());
+   RefPtr<ByteBuffer> digest = sourceBuffer.computeMD5Hash()->encodeBase16();
+
+   string registryKey = "chunk:" + string((const char *)digest->getBuffer(), digest->getBufferSize()) + ":" + filename;
+
+   // Check if script is in our cache; most recently used scripts are kept at the back
+   for(deque<string>::iterator it = mCachedScripts.begin(); it != mCachedScripts.end(); it++)
+      if(*it == registryKey)
+      {
+         mCachedScripts.erase(it);
+         mCachedScripts.push_back(registryKey);
+
+         lua_getfield(L, LUA_REGISTRYINDEX, registryKey.c_str());     // -- function
+         return;
+      }
+
+   // Like luaL_loadfile(), ignore the first line if it starts with a #, but keep the line numbers right
+   if(source.size() > 0 && source[0] == '#')
+      source = "--" + source;
+
+   if(luaL_loadbuffer(L, source.c_str(), source.size(), ("@" + filename).c_str()) != 0)
+      throw LuaException("Error compiling script " + filename + "\n" + string(lua_tostring(L, -1)));
+
+   if((S32)mCachedScripts.size() >= MAX_CACHE_SIZE)
+   {
+      // Remove least recently used script from the cache
+      deleteScript(mCachedScripts.front().c_str());
+      mCachedScripts.pop_front();
+   }
+
+   lua_pushvalue(L, -1);                                          // -- function, function
+   lua_setfield(L, LUA_REGISTRYINDEX, registryKey.c_str());       // -- function
+   mCachedScripts.push_back(registryKey);
+}
+
+
 // Load script from specified file, compile it, and store it in the registry.
 // All callers of this script have catch blocks, so we can throw errors if something goes wrong.
 void LuaScriptRunner::loadCompileSaveScript(const char *filename, const char *registryKey)
@@ -672,13 +901,12 @@ S32 LuaScriptRunner::findObjectById(lua_State *L, const Vector<DatabaseObject *>
 
 S32 LuaScriptRunner::doSubscribe(lua_State *L, ScriptContext context)   
 { 
-   lua_Integer eventType = getInt(L, -1);
+   lua_Integer eventType = getInt(L, 1);
+   S32 zoneFilter = lua_gettop(L) >= 2 ? (S32)getInt(L, 2) : EventManager::NoZoneFilter;
 
-   if(!mSubscriptions[eventType])
-   {
-      EventManager::get()->subscribe(this, (EventManager::EventType)eventType, context);
-      mSubscriptions[eventType] = true;
-   }
+   // Subscribing again is how a script changes its zone filter, so pass it on even if we're already subscribed
+   EventManager::get()->subscribe(this, (EventManager::EventType)eventType, context, false, zoneFilter);
+   mSubscriptions[eventType] = true;
 
    clearStack(L);
 
@@ -978,10 +1206,12 @@ void LuaScriptRunner::setGlobalObjectArrays(lua_State *L)
       METHOD(CLASS, findObjectById,        ARRAYDEF({{ INT, END }}), 1 )    \
       METHOD(CLASS, findAllObjects,        ARRAYDEF({{ TABLE, INTS, END }, { TABLE, END }, { INTS, END }, { END }}), 4 ) \
       METHOD(CLASS, findAllObjectsInArea,  ARRAYDEF({{ TABLE, PT, PT, INTS, END }, { PT, PT, INTS, END }}), 2 ) \
+      METHOD(CLASS, findAllObjectData,     ARRAYDEF({{ TABLE, INTS, END }, { TABLE, END }}), 2 ) \
+      METHOD(CLASS, findAllObjectDataInArea, ARRAYDEF({{ TABLE, PT, PT, INTS, END }}), 1 ) \
       METHOD(CLASS, addItem,               ARRAYDEF({{ BFOBJ, END }}), 1 )  \
       METHOD(CLASS, getGameInfo,           ARRAYDEF({{ END }}), 1 )         \
       METHOD(CLASS, getPlayerCount,        ARRAYDEF({{ END }}), 1 )         \
-      METHOD(CLASS, subscribe,             ARRAYDEF({{ EVENT, END }}), 1 )  \
+      METHOD(CLASS, subscribe,             ARRAYDEF({{ EVENT, END }, { EVENT, INT, END }}), 2 ) \
       METHOD(CLASS, unsubscribe,           ARRAYDEF({{ EVENT, END }}), 1 )  \
 
 
@@ -990,7 +1220,7 @@ GENERATE_LUA_METHODS_TABLE(LuaScriptRunner, LUA_METHODS);
 
 void LuaScriptRunner::registerLooseFunctions(lua_State *L)
 {
-   ProfileMap moduleProfiles = LuaModuleRegistrarBase::getModuleProfiles();
+   ProfileMap &moduleProfiles = LuaModuleRegistrarBase::getModuleProfiles();
 
    ProfileMap::iterator it;
    for(it = moduleProfiles.begin(); it != moduleProfiles.end(); it++)
@@ -1261,6 +1491,165 @@ S32 LuaScriptRunner::lua_findAllObjectsInArea(lua_State *L)
 }
 
 
+// Pops any ObjTypes off the top of the stack.  BotNavMeshZones live in their own database, so they aren't added to types;
+// we just let the caller know they were asked for.
+void LuaScriptRunner::popObjTypes(lua_State *L, Vector<U8> &types, bool &hasBotZoneType)
+{
+   hasBotZoneType = false;
+
+   while(lua_gettop(L) > 0 && lua_isnumber(L, -1))
+   {
+      U8 typenum = (U8)lua_tointeger(L, -1);
+
+      if(typenum != BotNavMeshZoneTypeNumber)
+         types.push_back(typenum);
+      else
+         hasBotZoneType = true;
+
+      lua_pop(L, 1);
+   }
+}
+
+
+// Number of values written per object by fillObjectDataTable()
+static const S32 ObjectDataFieldCount = 8;
+
+// Writes a flat record for each object into the table at stack position 1: id, objType, team, x, y, vx, vy, health.
+// All plain numbers, so once the table has grown big enough, refilling it creates no garbage at all.  Entries past the
+// end of this batch are left alone; scripts should use the count we return rather than #table.
+S32 LuaScriptRunner::fillObjectDataTable(lua_State *L, const Vector<DatabaseObject *> &objects)
+{
+   TNLAssert((lua_gettop(L) == 1 && lua_istable(L, 1)) || dumpStack(L), "Should only have table!");
+
+   S32 index = 0;
+
+   for(S32 i = 0; i < objects.size(); i++)
+   {
+      BfObject *obj = static_cast<BfObject *>(objects[i]);
+      Point pos = obj->getPos();
+      Point vel = obj->getVel();
+
+      lua_pushinteger(L, obj->getUserAssignedId());       lua_rawseti(L, 1, ++index);
+      lua_pushinteger(L, obj->getObjectTypeNumber());     lua_rawseti(L, 1, ++index);
+      lua_pushinteger(L, obj->getTeam() + 1);             lua_rawseti(L, 1, ++index);    // + 1 to match getTeamIndex()
+      lua_pushnumber(L, pos.x);                           lua_rawseti(L, 1, ++index);
+      lua_pushnumber(L, pos.y);                           lua_rawseti(L, 1, ++index);
+      lua_pushnumber(L, vel.x);                           lua_rawseti(L, 1, ++index);
+      lua_pushnumber(L, vel.y);                           lua_rawseti(L, 1, ++index);
+      lua_pushnumber(L, obj->getHealth());                lua_rawseti(L, 1, ++index);
+   }
+
+   TNLAssert(index == objects.size() * ObjectDataFieldCount, "Record size is out of sync!");
+
+   lua_pop(L, 1);
+
+   return returnInt(L, objects.size());
+}
+
+
+/**
+ * @luafunc int LuaScriptRunner::findAllObjectData(table data, ObjType objType, ...)
+ *
+ * @brief Like findAllObjects, but writes a compact record for each object into
+ * a table you provide, rather than making a new table of objects.
+ *
+ * @descr Each object takes up 8 consecutive entries in `data`: id, objType,
+ * team index, x, y, x velocity, y velocity, and health.  Only numbers are
+ * written, so if you hang on to `data` and pass it in each time, scanning the
+ * level generates no garbage for the Lua collector to clean up.
+ *
+ * `data` is not cleared first; anything past the last record from this call is
+ * left over from earlier calls, so loop over the returned count, not `#data`.
+ *
+ * @param data Table to fill.
+ * @param [objType] ObjTypes specifying what types of objects to find.
+ *
+ * @return The number of objects found.
+ *
+ * @code
+ * local data = { }
+ *
+ * function onTick()
+ *   local count = bf:findAllObjectData(data, ObjType.Ship, ObjType.Robot)
+ *   for i = 0, count - 1 do
+ *     local base = i * 8
+ *     local x, y = data[base + 4], data[base + 5]
+ *     -- ...
+ *   end
+ * end
+ * @endcode
+ */
+S32 LuaScriptRunner::lua_findAllObjectData(lua_State *L)
+{
+   checkArgList(L, functionArgs, luaClassName, "findAllObjectData");
+
+   TNLAssert(mLuaGridDatabase != NULL, "Grid Database must not be NULL!");
+
+   static Vector<U8> types;
+   bool hasBotZoneType;
+
+   types.clear();
+   fillVector.clear();
+
+   popObjTypes(L, types, hasBotZoneType);
+
+   if(hasBotZoneType)
+      mLuaGame->getBotZoneDatabase()->findObjects(BotNavMeshZoneTypeNumber, fillVector);
+
+   if(types.size() > 0)
+      mLuaGridDatabase->findObjects(types, fillVector);
+   else if(!hasBotZoneType)
+      return fillObjectDataTable(L, *mLuaGridDatabase->findObjects_fast());
+
+   return fillObjectDataTable(L, fillVector);
+}
+
+
+/**
+ * @luafunc int LuaScriptRunner::findAllObjectDataInArea(table data, point point1, point point2, ObjType objType, ...)
+ *
+ * @brief Like findAllObjectsInArea, but fills `data` with compact object
+ * records.
+ *
+ * @note See LuaScriptRunner::findAllObjectData for the record layout.
+ *
+ * @param data Table to fill.
+ * @param point1 One corner of a search rectangle.
+ * @param point2 Another corner of a search rectangle diagonally opposite to the
+ * first.
+ * @param objType The \ref ObjTypeEnum to look for. Multiple can be specified.
+ *
+ * @return The number of objects found.
+ */
+S32 LuaScriptRunner::lua_findAllObjectDataInArea(lua_State *L)
+{
+   checkArgList(L, functionArgs, luaClassName, "findAllObjectDataInArea");
+
+   TNLAssert(mLuaGridDatabase != NULL, "Grid Database must not be NULL!");
+
+   static Vector<U8> types;
+   bool hasBotZoneType;
+
+   types.clear();
+   fillVector.clear();
+
+   popObjTypes(L, types, hasBotZoneType);
+
+   Point p1 = getPointOrXY(L, -1);
+   Point p2 = getPointOrXY(L, -2);
+   lua_pop(L, 2);
+
+   Rect searchArea = Rect(p1, p2);
+
+   if(hasBotZoneType)
+      mLuaGame->getBotZoneDatabase()->findObjects(BotNavMeshZoneTypeNumber, fillVector, searchArea);
+
+   mLuaGridDatabase->findObjects(types, fillVector, searchArea);
+
+   return fillObjectDataTable(L, fillVector);
+}
+
+
 /**
  * @luafunc LuaScriptRunner::addItem(BfObject obj)
  *
@@ -1341,12 +1730,19 @@ S32 LuaScriptRunner::lua_getPlayerCount(lua_State *L)
 
 
 /**
- * @luafunc LuaScriptRunner::subscribe(Event event)
+ * @luafunc LuaScriptRunner::subscribe(Event event, int zoneId)
  *
  * @brief Manually subscribe to notifications when the specified \ref EventEnum
  * occurs.
  *
+ * @descr For the zone events (ShipEnteredZone, ShipLeftZone, ObjectEnteredZone
+ * and ObjectLeftZone) you can pass a zone id, and you'll only hear about that
+ * zone.  That's much cheaper than filtering in your handler, since the handler
+ * isn't even called for the other zones.  Subscribe again to change the zone,
+ * or without an id to hear about every zone.
+ *
  * @param event The \ref EventEnum to subscribe to.
+ * @param zoneId (Optional) Only fire zone events for the zone with this id.
  *
  * @see The \ref EventEnum page for a list of events and their callback
  * signatures.
@@ -43,6 +43,22 @@ class MenuItem;
 #define LEVELGEN_HELPER_FUNCTIONS_KEY "levelgen_helper_functions"
 #define SCRIPT_TIMER_KEY "script_timer"
 
+
+// Running totals for the shared Lua instance, for tuning the memory limit and JIT options
+struct LuaScriptStats
+{
+   S32 heapBytes;          // Current size of the Lua heap
+   S32 peakHeapBytes;
+   U32 fullCollections;    // Full collections done to check scripts against the memory limit
+   U32 scriptsKilled;      // Scripts killed for going over the memory limit
+   U32 tracesCompleted;    // JIT traces successfully compiled
+   U32 tracesAborted;
+   U32 traceFlushes;       // Times the trace cache was thrown away
+   U32 proxiesAllocated;   // Lua proxies for game objects created since startup
+   S32 liveProxies;
+};
+
+
 class LuaScriptRunner
 {
 
@@ -51,6 +67,17 @@ private:
 
    static string mScriptingDir;
 
+   static S32 mScriptMemoryLimit;   // Bytes of Lua heap any one script may hold on to; 0 means no limit
+   static S32 mBaseHeapBytes;       // Live heap before any scripts were loaded
+   static S32 mCallDepth;           // Lua calls we're inside of; only the outermost one gets charged for memory
+   static LuaScriptStats mStats;
+
+   static S32 getHeapBytes();
+   static S32 luaTraceEvent(lua_State *L);   // Counts JIT trace events, registered with jit.attach()
+   static void attachTraceListener(lua_State *L);
+
+   bool chargeMemoryUsed(S32 heapBefore);
+
    void setLuaArgs(const Vector<string> &args);
    static void setModulePath();
 
@@ -58,6 +85,7 @@ private:
    static void loadCompileRunHelper(const string &scriptName);
    static void loadCompileSaveScript(const char *filename, const char *registryKey);
    static void loadCompileScript(const char *filename);
+   static void loadCompileCacheScript(const string &filename);
 
    void pushStackTracer();      // Put error handler function onto the stack
 
@@ -88,6 +116,9 @@ protected:
 
    bool mSubscriptions[EventManager::EventTypes];  // Keep track of which events we're subscribed to for rapid unsubscription upon death or destruction
 
+   S32 mMemoryUsed;              // Approximate bytes of Lua heap held by this script
+   S32 mNextCollection;          // mMemoryUsed at which we next collect to check on it, if over the limit; 0 for the limit itself
+
    // Sub-classes that override this should still call this with Parent::prepareEnvironment()
    virtual bool prepareEnvironment();
 
@@ -95,14 +126,15 @@ protected:
    static void registerClasses();
    void setEnvironment();                 // Sets the environment for the function on the top of the stack to that associated with name
 
-   bool loadCompileRunEnvironmentScript(const string &scriptName);
-
    static void deleteScript(const char *name);  // Remove saved script from the Lua registry
 
    static void registerLooseFunctions(lua_State *L);   // Register some functions not associated with a particular class
 
    static S32 findObjectById(lua_State *L, const Vector<DatabaseObject *> *objects);
 
+   static void popObjTypes(lua_State *L, Vector<U8> &types, bool &hasBotZoneType);
+   static S32 fillObjectDataTable(lua_State *L, const Vector<DatabaseObject *> &objects);
+
 
 // Sets a var in the script's environment to give access to the caller's "this" obj, with the var name "name".
 // Basically sets the "bot", "levelgen", and "plugin" vars.
@@ -139,6 +171,14 @@ public:
 
    static bool configureNewLuaInstance(lua_State *L); // Prepare a new Lua environment for use
 
+   static bool setJitOptions(bool enabled, const string &options);
+   static void setScriptMemoryLimit(S64 bytes);
+   static S32 getScriptMemoryLimit();
+   static LuaScriptStats getStats();
+   static void logStats();
+
+   S32 getMemoryUsed() const;
+
    bool runString(const string &code);
    bool runMain();                                    // Run a script's main() function
    bool runMain(const Vector<string> &args);          // Run a script's main() function, putting args into Lua's arg table
@@ -147,6 +187,7 @@ public:
    bool runScript(bool cacheScript);   // Load the script, execute the chunk to get it in memory, then run its main() function
 
    bool runCmd(const char *function, S32 returnValues);
+   bool runCmd(const char *function, S32 returnValues, S32 args);
 
    const char *getScriptId();
    static bool loadFunction(lua_State *L, const char *scriptId, const char *functionName);
@@ -186,6 +227,8 @@ public:
 
    S32 lua_findAllObjects(lua_State *L);
    S32 lua_findAllObjectsInArea(lua_State *L);
+   S32 lua_findAllObjectData(lua_State *L);
+   S32 lua_findAllObjectDataInArea(lua_State *L);
    S32 lua_findObjectById(lua_State *L);
 
    S32 lua_addItem(lua_State *L);
@@ -53,6 +53,8 @@ extern "C"
 #include "LuaBase.h"   
 #include "LuaException.h"   
 
+#include "tnlDataChunker.h"
+
 #include <string>
 #include <vector>
 #include <map>
@@ -399,15 +401,24 @@ void luaW_push(lua_State* L, T* obj)
          // Here: retrieves and pushes cache_table[id]
          lua_gettable(L, -2);                            // -- cache_table, userdata
 
-         TNLAssert(lua_isuserdata(L, -1) ||
-               dumpStack(L, "Expect table, userdata") || dumpTable(L, -2, "Cached Userdatas"),
-               "Expected userdata!");
-         TNLAssert(proxy == luaW_toProxy<T>(L, -1), "Cached object is not the one we expect!");
+         // The cache only holds weak references, so the userdata may have been collected, with its __gc yet to run.
+         // Cut the old proxy loose -- it will be deleted without touching obj -- and make a new one.
+         if(lua_isnil(L, -1))
+         {
+            proxy->setDefunct(true);
+            proxy = NULL;
+         }
+         else
+            TNLAssert(proxy == luaW_toProxy<T>(L, -1), "Cached object is not the one we expect!");
 
          // Clean up the stack
-         lua_remove(L, -2);                              // -- userdata
+         if(proxy)
+            lua_remove(L, -2);                           // -- userdata
+         else
+            lua_pop(L, 2);                               // --
       }
-      else
+
+      if(!proxy)
       {
          // Create a new proxy
          proxy = new LuaProxy<T>(obj);
@@ -438,8 +449,9 @@ void luaW_push(lua_State* L, T* obj)
          lua_pop(L, 1); // ... obj
          TNLAssert(lua_isuserdata(L, -1) || dumpStack(L, "Expect userdata"), "Expected userdata!");
 
+         // No luaW_hold() here -- luaW_gc() deletes proxies whether they're held or not, and nothing ever releases the
+         // hold, so it would just leave an entry in the holds table for every object a script has ever seen
          luaW_setUsingProxy(L, obj, true);
-         luaW_hold<T>(L, obj);     // Tell luaW to collect the proxy when it's done with it
       }
    }  // useLuaProxy
 
@@ -841,14 +853,14 @@ void luaW_setfuncs(lua_State* L, const char* classname, const luaL_Reg* table,
 
     lua_getfield(L, -1, LUAW_CACHE_KEY); // ... LuaWrapper LuaWrapper.cache
     lua_newtable(L); // ... LuaWrapper LuaWrapper.cache {}
-    luaW_wrapperfield<T>(L, LUAW_CACHE_METATABLE_KEY); // ... LuaWrapper LuaWrapper.cache {} cmt
+    lua_getfield(L, -3, LUAW_CACHE_METATABLE_KEY); // ... LuaWrapper LuaWrapper.cache {} cmt
     lua_setmetatable(L, -2); // ... LuaWrapper LuaWrapper.cache {}
     lua_setfield(L, -2, LuaWrapper<T>::classname); // ... LuaWrapper LuaWrapper.cache
     lua_pop(L, 1); // ... LuaWrapper
 
     lua_getfield(L, -1, LUAW_USING_PROXY_KEY); // ... LuaWrapper LuaWrapper.usingproxy
     lua_newtable(L); // ... LuaWrapper LuaWrapper.usingproxy {}
-    luaW_wrapperfield<T>(L, LUAW_USING_PROXY_METATABLE_KEY); // ... LuaWrapper LuaWrapper.usingproxy {} upmt
+    lua_getfield(L, -3, LUAW_USING_PROXY_METATABLE_KEY); // ... LuaWrapper LuaWrapper.usingproxy {} upmt
     lua_setmetatable(L, -2); // ... LuaWrapper LuaWrapper.usingproxy {}
     lua_setfield(L, -2, LuaWrapper<T>::classname); // ... LuaWrapper LuaWrapper.usingproxy
 
@@ -1155,6 +1167,32 @@ public:
 
 
 
+// Every proxy has the same layout, whatever it points at, so they can all come out of one pool.  Bots looking at
+// projectiles and other short-lived objects create and collect proxies at a great rate, and this spares the heap.
+struct LuaProxyStorage
+{
+   void *data[2];
+};
+
+
+struct LuaProxyPool
+{
+   ClassChunker<LuaProxyStorage> chunker;
+   U32 allocated;          // Proxies created since startup
+   S32 live;               // Proxies that haven't been collected yet
+
+   LuaProxyPool() { allocated = 0; live = 0; }
+};
+
+
+// Never deleted, so proxies collected while Lua shuts down at exit still have somewhere to go
+inline LuaProxyPool &luaW_getProxyPool()
+{
+   static LuaProxyPool *pool = new LuaProxyPool();
+   return *pool;
+}
+
+
 template <class T>
 class LuaProxy
 {
@@ -1163,6 +1201,27 @@ private:
     T *mProxiedObject;
 
 public:
+   static void *operator new(size_t size)
+   {
+      TNLAssert(size <= sizeof(LuaProxyStorage), "LuaProxy has grown, LuaProxyStorage needs to as well!");
+
+      LuaProxyPool &pool = luaW_getProxyPool();
+      pool.allocated++;
+      pool.live++;
+
+      return pool.chunker.alloc();
+   }
+
+   static void operator delete(void *ptr)
+   {
+      if(!ptr)
+         return;
+
+      LuaProxyPool &pool = luaW_getProxyPool();
+      pool.live--;
+      pool.chunker.free(static_cast<LuaProxyStorage *>(ptr));
+   }
+
     // Default constructor
     LuaProxy() { TNLAssert(false, "Not used"); }
 
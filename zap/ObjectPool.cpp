@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "ObjectPool.h"
+
+#include "tnlAssert.h"
+
+#include <new>
+
+namespace Zap
+{
+
+static const S32 ElementsPerPage = 32;
+
+
+// Keep every slot on an 8-byte boundary; DataChunker only promises 4
+static size_t roundUp(size_t size)
+{
+   return (size + 7) & ~size_t(7);
+}
+
+
+static Vector<ObjectPool *> &getPoolList()
+{
+   static Vector<ObjectPool *> pools;
+   return pools;
+}
+
+
+// Constructor
+ObjectPool::ObjectPool(const char *name, size_t elementSize) :
+      mChunker(getMax(S32(roundUp(elementSize) * ElementsPerPage), S32(DataChunker::ChunkSize)))
+{
+   mName = name;
+   mElementSize = roundUp(getMax(U32(elementSize), U32(sizeof(void *))));
+   mFreeListHead = NULL;
+
+   mLiveCount = 0;
+   mPeakCount = 0;
+   mAllocCount = 0;
+   mHeapCount = 0;
+
+   getPoolList().push_back(this);
+}
+
+
+// Destructor
+ObjectPool::~ObjectPool()
+{
+   S32 index = getPoolList().getIndex(this);
+   if(index != -1)
+      getPoolList().erase(index);
+}
+
+
+void *ObjectPool::alloc(size_t size)
+{
+   // A subclass without a pool of its own inherits our operator new; it's too big for our slots
+   if(roundUp(size) != mElementSize)
+   {
+      mHeapCount++;
+      return ::operator new(size);
+   }
+
+   mLiveCount++;
+   mAllocCount++;
+   mPeakCount = getMax(mPeakCount, mLiveCount);
+
+   if(!mFreeListHead)
+      return mChunker.alloc(S32(mElementSize));
+
+   void *ptr = mFreeListHead;
+   mFreeListHead = *static_cast<void **>(ptr);
+   return ptr;
+}
+
+
+void ObjectPool::free(void *ptr, size_t size)
+{
+   if(!ptr)
+      return;
+
+   if(roundUp(size) != mElementSize)
+   {
+      ::operator delete(ptr);
+      return;
+   }
+
+   TNLAssert(mLiveCount > 0, "Freeing more than we handed out!");
+   mLiveCount--;
+
+   *static_cast<void **>(ptr) = mFreeListHead;
+   mFreeListHead = ptr;
+}
+
+
+const char *ObjectPool::getName() const
+{
+   return mName;
+}
+
+
+U32 ObjectPool::getLiveCount() const
+{
+   return mLiveCount;
+}
+
+
+U32 ObjectPool::getPeakCount() const
+{
+   return mPeakCount;
+}
+
+
+U32 ObjectPool::getAllocCount() const
+{
+   return mAllocCount;
+}
+
+
+U32 ObjectPool::getHeapCount() const
+{
+   return mHeapCount;
+}
+
+
+const Vector<ObjectPool *> &ObjectPool::getPools()
+{
+   return getPoolList();
+}
+
+
+};
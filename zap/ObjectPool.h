@@ -0,0 +1,77 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _OBJECT_POOL_H_
+#define _OBJECT_POOL_H_
+
+#include "tnlTypes.h"
+#include "tnlDataChunker.h"      // Needs tnlTypes.h first
+#include "tnlVector.h"
+
+#include <cstddef>
+
+using namespace TNL;
+
+namespace Zap
+{
+
+// Raw memory for objects that all have the same size and come and go by the hundred -- projectiles, mines, flags
+// and the like.  Works like TNL's ClassChunker: memory comes out of big DataChunker pages, and freed slots go on a
+// free list for the next alloc().  Unlike ClassChunker, we don't construct anything, so this can sit behind a class's
+// operator new.  Use the BF_DECLARE_POOLED_ALLOC/BF_IMPLEMENT_POOLED_ALLOC macros below rather than using it directly.
+//
+// Pages are never returned to the system; a pool is as big as the most objects of its kind that were ever alive at
+// once.  Not thread-safe; objects must be created and destroyed on the game thread.
+class ObjectPool
+{
+private:
+   const char *mName;
+   size_t mElementSize;
+   DataChunker mChunker;
+   void *mFreeListHead;
+
+   U32 mLiveCount;
+   U32 mPeakCount;      // Also how many slots we've carved from our pages, since none are ever given back
+   U32 mAllocCount;     // Ever
+   U32 mHeapCount;      // Ever; allocations we couldn't serve, because they were for a subclass
+
+public:
+   ObjectPool(const char *name, size_t elementSize);   // Constructor
+   virtual ~ObjectPool();                              // Destructor
+
+   void *alloc(size_t size);
+   void free(void *ptr, size_t size);
+
+   const char *getName() const;
+   U32 getLiveCount() const;
+   U32 getPeakCount() const;
+   U32 getAllocCount() const;
+   U32 getHeapCount() const;
+
+   static const Vector<ObjectPool *> &getPools();     // For diagnostics
+};
+
+
+// Put BF_DECLARE_POOLED_ALLOC in the class declaration, and BF_IMPLEMENT_POOLED_ALLOC next to TNL_IMPLEMENT_NETOBJECT.
+// Every new of the class then comes from its pool, including ghosts created by TNL on the client.  Subclasses that
+// don't declare their own pool still work; they go to the heap.
+#define BF_DECLARE_POOLED_ALLOC \
+   static void *operator new(size_t size); \
+   static void operator delete(void *ptr, size_t size)
+
+// The pool is created on first use and never destroyed, so objects can safely outlive static destruction at exit
+#define BF_IMPLEMENT_POOLED_ALLOC(className) \
+   static Zap::ObjectPool &get##className##Pool() \
+   { \
+      static Zap::ObjectPool *pool = new Zap::ObjectPool(#className, sizeof(className)); \
+      return *pool; \
+   } \
+   void *className::operator new(size_t size) { return get##className##Pool().alloc(size); } \
+   void className::operator delete(void *ptr, size_t size) { get##className##Pool().free(ptr, size); }
+
+
+};
+
+#endif
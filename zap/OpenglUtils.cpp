@@ -38,6 +38,7 @@
 
 #include "Color.h"
 #include "Point.h"
+#include "tnlAssert.h"
 #include "tnlVector.h"
 #include "stringUtils.h"
 
@@ -157,4 +158,36 @@ void renderLine(const Vector<Point> *points)
    renderPointVector(points, GL_LINE_STRIP);
 }
 
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+extern F32 gDefaultLineWidth;
+
+// Constructor
+GLRenderBackend::GLRenderBackend()
+{
+   TNLAssert(RenderCommandBuffer::Lines == GL_LINES && RenderCommandBuffer::Triangles == GL_TRIANGLES &&
+             RenderCommandBuffer::Points == GL_POINTS, "RenderCommandBuffer geometry types don't match GL's!");
+}
+
+
+// Destructor
+GLRenderBackend::~GLRenderBackend()
+{
+   // Do nothing
+}
+
+
+void GLRenderBackend::drawBatch(U32 geomType, F32 lineWidth, const F32 vertices[], const F32 colors[], S32 vertexCount)
+{
+   if(lineWidth != 0)
+      glLineWidth(lineWidth);
+
+   renderColorVertexArray(vertices, colors, vertexCount, geomType);
+
+   if(lineWidth != 0)
+      glLineWidth(gDefaultLineWidth);
+}
+
 }
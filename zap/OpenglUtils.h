@@ -12,6 +12,7 @@
 
 #include "tnlTypes.h"
 #include "FontContextEnum.h"
+#include "RenderCommandBuffer.h"
 
 #if defined(TNL_OS_MOBILE) || defined(BF_USE_GLES)
 #  include "SDL_opengles.h"
@@ -51,6 +52,18 @@ extern void glScale(F32 scaleFactor);
 extern void glTranslate(const Point &pos);
 extern void setDefaultBlendFunction();
 
+
+// Draws a RenderCommandBuffer's batches with OpenGL
+class GLRenderBackend : public RenderBackend
+{
+public:
+   GLRenderBackend();            // Constructor
+   virtual ~GLRenderBackend();   // Destructor
+
+   void drawBatch(U32 geomType, F32 lineWidth, const F32 vertices[], const F32 colors[], S32 vertexCount);
+};
+
+
 template<class T, class U, class V>
       static void glColor(T in_r, U in_g, V in_b) { glColor4f(static_cast<F32>(in_r), static_cast<F32>(in_g), static_cast<F32>(in_b), 1.0f); }
 
@@ -0,0 +1,446 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "RenderCommandBuffer.h"
+
+#include "Color.h"
+#include "Point.h"
+
+#include "tnlAssert.h"
+
+#include <math.h>
+
+namespace Zap
+{
+
+// Destructor
+RenderBackend::~RenderBackend()
+{
+   // Do nothing
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+// Constructor
+CountingRenderBackend::CountingRenderBackend()
+{
+   reset();
+}
+
+
+// Destructor
+CountingRenderBackend::~CountingRenderBackend()
+{
+   // Do nothing
+}
+
+
+void CountingRenderBackend::drawBatch(U32 geomType, F32 lineWidth, const F32 vertices[], const F32 colors[], S32 vertexCount)
+{
+   mDrawCalls++;
+   mVertices += vertexCount;
+}
+
+
+void CountingRenderBackend::reset()
+{
+   mDrawCalls = 0;
+   mVertices = 0;
+}
+
+
+S32 CountingRenderBackend::getDrawCallCount() const
+{
+   return mDrawCalls;
+}
+
+
+S32 CountingRenderBackend::getVertexCount() const
+{
+   return mVertices;
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+static RenderCommandBuffer *activeBuffer = NULL;
+
+
+// Constructor
+RenderCommandBuffer::RenderCommandBuffer()
+{
+   mTransform.a = 1;
+   mTransform.b = 0;
+   mTransform.c = 0;
+   mTransform.d = 1;
+   mTransform.tx = 0;
+   mTransform.ty = 0;
+
+   mLayer = 0;
+   setColor(1, 1, 1, 1);
+   mLineWidth = 0;
+}
+
+
+// Destructor
+RenderCommandBuffer::~RenderCommandBuffer()
+{
+   if(activeBuffer == this)
+      activeBuffer = NULL;
+}
+
+
+void RenderCommandBuffer::setLayer(S32 layer)
+{
+   mLayer = layer;
+}
+
+
+void RenderCommandBuffer::setColor(const Color &color, F32 alpha)
+{
+   setColor(color.r, color.g, color.b, alpha);
+}
+
+
+void RenderCommandBuffer::setColor(F32 r, F32 g, F32 b, F32 alpha)
+{
+   mColor[0] = r;
+   mColor[1] = g;
+   mColor[2] = b;
+   mColor[3] = alpha;
+}
+
+
+void RenderCommandBuffer::setLineWidth(F32 width)
+{
+   mLineWidth = width;
+}
+
+
+const F32 *RenderCommandBuffer::getColor() const
+{
+   return mColor;
+}
+
+
+void RenderCommandBuffer::pushTransform()
+{
+   mTransformStack.push_back(mTransform);
+}
+
+
+void RenderCommandBuffer::popTransform()
+{
+   TNLAssert(mTransformStack.size() > 0, "Unbalanced popTransform()!");
+
+   mTransform = mTransformStack.last();
+   mTransformStack.pop_back();
+}
+
+
+void RenderCommandBuffer::translate(F32 x, F32 y)
+{
+   mTransform.tx += mTransform.a * x + mTransform.c * y;
+   mTransform.ty += mTransform.b * x + mTransform.d * y;
+}
+
+
+void RenderCommandBuffer::translate(const Point &offset)
+{
+   translate(offset.x, offset.y);
+}
+
+
+// Same direction as glRotatef, but in radians
+void RenderCommandBuffer::rotate(F32 radians)
+{
+   F32 cosTheta = cosf(radians);
+   F32 sinTheta = sinf(radians);
+
+   Transform &t = mTransform;
+   F32 a = t.a * cosTheta + t.c * sinTheta;
+   F32 b = t.b * cosTheta + t.d * sinTheta;
+
+   t.c = t.c * cosTheta - t.a * sinTheta;
+   t.d = t.d * cosTheta - t.b * sinTheta;
+   t.a = a;
+   t.b = b;
+}
+
+
+void RenderCommandBuffer::scale(F32 x, F32 y)
+{
+   mTransform.a *= x;
+   mTransform.b *= x;
+   mTransform.c *= y;
+   mTransform.d *= y;
+}
+
+
+// Primitives that can share a draw call are appended to the same command, so the sort in flush() has less to do
+RenderCommandBuffer::Command &RenderCommandBuffer::getCommand(U32 geomType)
+{
+   if(mCommands.size() > 0)
+   {
+      Command &last = mCommands.last();
+      if(last.layer == mLayer && last.geomType == geomType && last.lineWidth == mLineWidth)
+         return last;
+   }
+
+   Command command;
+   command.layer = mLayer;
+   command.geomType = geomType;
+   command.lineWidth = mLineWidth;
+   command.firstVertex = mVertices.size() / 2;
+   command.vertexCount = 0;
+   command.order = mCommands.size();
+
+   mCommands.push_back(command);
+
+   return mCommands.last();
+}
+
+
+void RenderCommandBuffer::addVertex(F32 x, F32 y)
+{
+   mVertices.push_back(mTransform.a * x + mTransform.c * y + mTransform.tx);
+   mVertices.push_back(mTransform.b * x + mTransform.d * y + mTransform.ty);
+
+   for(S32 i = 0; i < 4; i++)
+      mColors.push_back(mColor[i]);
+}
+
+
+// Breaks everything down into independent points, lines or triangles, which can all be drawn together
+template<class T>
+void RenderCommandBuffer::addArray(const T verts[], S32 vertCount, U32 geomType)
+{
+   U32 listType;
+   if(geomType == Points)
+      listType = Points;
+   else if(geomType == Lines || geomType == LineLoop || geomType == LineStrip)
+      listType = Lines;
+   else
+      listType = Triangles;
+
+   Command &command = getCommand(listType);
+   S32 startSize = mVertices.size();
+
+#define VERTEX(i) addVertex(F32(verts[2 * (i)]), F32(verts[2 * (i) + 1]))
+
+   switch(geomType)
+   {
+      case Points:
+         for(S32 i = 0; i < vertCount; i++)
+            VERTEX(i);
+         break;
+
+      case Lines:
+         for(S32 i = 0; i + 1 < vertCount; i += 2)
+         {
+            VERTEX(i);
+            VERTEX(i + 1);
+         }
+         break;
+
+      case LineStrip:
+      case LineLoop:
+         for(S32 i = 0; i + 1 < vertCount; i++)
+         {
+            VERTEX(i);
+            VERTEX(i + 1);
+         }
+
+         if(geomType == LineLoop && vertCount > 2)
+         {
+            VERTEX(vertCount - 1);
+            VERTEX(0);
+         }
+         break;
+
+      case Triangles:
+         for(S32 i = 0; i + 2 < vertCount; i += 3)
+         {
+            VERTEX(i);
+            VERTEX(i + 1);
+            VERTEX(i + 2);
+         }
+         break;
+
+      case TriangleStrip:
+         for(S32 i = 0; i + 2 < vertCount; i++)
+         {
+            // Every other triangle is wound the other way; swap them back so they all face the same way
+            if(i % 2 == 0)
+            {
+               VERTEX(i);
+               VERTEX(i + 1);
+            }
+            else
+            {
+               VERTEX(i + 1);
+               VERTEX(i);
+            }
+            VERTEX(i + 2);
+         }
+         break;
+
+      case TriangleFan:
+         for(S32 i = 1; i + 1 < vertCount; i++)
+         {
+            VERTEX(0);
+            VERTEX(i);
+            VERTEX(i + 1);
+         }
+         break;
+
+      default:
+         TNLAssert(false, "Unknown geometry type!");
+         break;
+   }
+
+#undef VERTEX
+
+   command.vertexCount += (mVertices.size() - startSize) / 2;
+}
+
+
+void RenderCommandBuffer::addVertices(const S16 verts[], S32 vertCount, U32 geomType)
+{
+   addArray(verts, vertCount, geomType);
+}
+
+
+void RenderCommandBuffer::addVertices(const F32 verts[], S32 vertCount, U32 geomType)
+{
+   addArray(verts, vertCount, geomType);
+}
+
+
+void RenderCommandBuffer::addPoints(const Vector<Point> &points, U32 geomType)
+{
+   if(points.size() > 0)
+      addArray(&points[0].x, points.size(), geomType);
+}
+
+
+static S32 getGeomTypeRank(U32 geomType)
+{
+   if(geomType == RenderCommandBuffer::Triangles)
+      return 0;
+   if(geomType == RenderCommandBuffer::Lines)
+      return 1;
+   return 2;
+}
+
+
+bool RenderCommandBuffer::commandSort(const Command &a, const Command &b)
+{
+   if(a.layer != b.layer)
+      return a.layer < b.layer;
+
+   S32 rankA = getGeomTypeRank(a.geomType);
+   S32 rankB = getGeomTypeRank(b.geomType);
+   if(rankA != rankB)
+      return rankA < rankB;
+
+   if(a.lineWidth != b.lineWidth)
+      return a.lineWidth < b.lineWidth;
+
+   return a.order < b.order;
+}
+
+
+void RenderCommandBuffer::flush(RenderBackend &backend)
+{
+   mCommands.sort(commandSort);
+
+   S32 i = 0;
+   while(i < mCommands.size())
+   {
+      const Command &first = mCommands[i];
+
+      // Find the run of commands that can be drawn together
+      S32 end = i + 1;
+      while(end < mCommands.size() && mCommands[end].layer == first.layer &&
+            mCommands[end].geomType == first.geomType && mCommands[end].lineWidth == first.lineWidth)
+         end++;
+
+      if(end == i + 1)     // Just the one; draw it where it is
+      {
+         if(first.vertexCount > 0)
+            backend.drawBatch(first.geomType, first.lineWidth, &mVertices[first.firstVertex * 2],
+                              &mColors[first.firstVertex * 4], first.vertexCount);
+      }
+      else
+      {
+         mBatchVertices.clear();
+         mBatchColors.clear();
+
+         for(S32 j = i; j < end; j++)
+         {
+            const Command &command = mCommands[j];
+
+            for(S32 k = command.firstVertex * 2; k < (command.firstVertex + command.vertexCount) * 2; k++)
+               mBatchVertices.push_back(mVertices[k]);
+
+            for(S32 k = command.firstVertex * 4; k < (command.firstVertex + command.vertexCount) * 4; k++)
+               mBatchColors.push_back(mColors[k]);
+         }
+
+         if(mBatchVertices.size() > 0)
+            backend.drawBatch(first.geomType, first.lineWidth, mBatchVertices.address(), mBatchColors.address(),
+                              mBatchVertices.size() / 2);
+      }
+
+      i = end;
+   }
+
+   clear();
+}
+
+
+void RenderCommandBuffer::clear()
+{
+   mCommands.clear();
+   mVertices.clear();
+   mColors.clear();
+}
+
+
+bool RenderCommandBuffer::isEmpty() const
+{
+   return mCommands.size() == 0;
+}
+
+
+S32 RenderCommandBuffer::getCommandCount() const
+{
+   return mCommands.size();
+}
+
+
+S32 RenderCommandBuffer::getVertexCount() const
+{
+   return mVertices.size() / 2;
+}
+
+
+RenderCommandBuffer *RenderCommandBuffer::getActive()
+{
+   return activeBuffer;
+}
+
+
+void RenderCommandBuffer::setActive(RenderCommandBuffer *buffer)
+{
+   activeBuffer = buffer;
+}
+
+
+};
@@ -0,0 +1,147 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _RENDER_COMMAND_BUFFER_H_
+#define _RENDER_COMMAND_BUFFER_H_
+
+#include "tnlTypes.h"
+#include "tnlVector.h"
+
+using namespace TNL;
+
+namespace Zap
+{
+
+class Color;
+class Point;
+
+// Whatever actually draws the batches a RenderCommandBuffer produces.  Vertices are x,y pairs, colors are r,g,b,a
+// per vertex, and geomType is always GL_POINTS, GL_LINES or GL_TRIANGLES.  A lineWidth of 0 means the default.
+class RenderBackend
+{
+public:
+   virtual ~RenderBackend();     // Destructor
+
+   virtual void drawBatch(U32 geomType, F32 lineWidth, const F32 vertices[], const F32 colors[], S32 vertexCount) = 0;
+};
+
+
+// Draws nothing, just keeps score; lets us see how well things batch without a GPU
+class CountingRenderBackend : public RenderBackend
+{
+private:
+   S32 mDrawCalls;
+   S32 mVertices;
+
+public:
+   CountingRenderBackend();            // Constructor
+   virtual ~CountingRenderBackend();   // Destructor
+
+   void drawBatch(U32 geomType, F32 lineWidth, const F32 vertices[], const F32 colors[], S32 vertexCount);
+
+   void reset();
+   S32 getDrawCallCount() const;
+   S32 getVertexCount() const;
+};
+
+
+// Collects primitives instead of drawing them, then draws them in as few batches as it can.  Strips, loops and fans
+// are broken into plain lines and triangles, and every vertex carries its own color, so primitives that differ only
+// in color or position can go out in a single draw call.  flush() sorts by layer, then primitive type (fills below
+// lines below points), then line width, keeping the order things were added in otherwise.
+//
+// The buffer keeps its own color, line width and transform, which work like their GL counterparts; vertices are
+// transformed as they are added.  The GL state in effect when flush() is called applies to everything on top of that.
+class RenderCommandBuffer
+{
+public:
+   // The geometry types we accept; values are from the GL spec, so we don't need GL headers here
+   enum GeomType {
+      Points        = 0x0000,
+      Lines         = 0x0001,
+      LineLoop      = 0x0002,
+      LineStrip     = 0x0003,
+      Triangles     = 0x0004,
+      TriangleStrip = 0x0005,
+      TriangleFan   = 0x0006,
+   };
+
+private:
+   struct Transform
+   {
+      F32 a, b, c, d;      // x' = a*x + c*y + tx, y' = b*x + d*y + ty
+      F32 tx, ty;
+   };
+
+   struct Command
+   {
+      S32 layer;
+      U32 geomType;        // Points, Lines or Triangles
+      F32 lineWidth;
+      S32 firstVertex;
+      S32 vertexCount;
+      S32 order;           // Tiebreaker, so sorting keeps things in the order they were added
+   };
+
+   Vector<Command> mCommands;
+   Vector<F32> mVertices;
+   Vector<F32> mColors;
+
+   // Scratch space for merging runs of commands in flush()
+   Vector<F32> mBatchVertices;
+   Vector<F32> mBatchColors;
+
+   Transform mTransform;
+   Vector<Transform> mTransformStack;
+
+   S32 mLayer;
+   F32 mColor[4];
+   F32 mLineWidth;
+
+   Command &getCommand(U32 geomType);
+   void addVertex(F32 x, F32 y);
+
+   template<class T> void addArray(const T verts[], S32 vertCount, U32 geomType);
+
+   static bool commandSort(const Command &a, const Command &b);
+
+public:
+   RenderCommandBuffer();              // Constructor
+   virtual ~RenderCommandBuffer();     // Destructor
+
+   void setLayer(S32 layer);
+   void setColor(const Color &color, F32 alpha = 1);
+   void setColor(F32 r, F32 g, F32 b, F32 alpha = 1);
+   void setLineWidth(F32 width);       // 0 for the default
+
+   const F32 *getColor() const;        // r, g, b, a
+
+   void pushTransform();
+   void popTransform();
+   void translate(F32 x, F32 y);
+   void translate(const Point &offset);
+   void rotate(F32 radians);
+   void scale(F32 x, F32 y);
+
+   void addVertices(const S16 verts[], S32 vertCount, U32 geomType);
+   void addVertices(const F32 verts[], S32 vertCount, U32 geomType);
+   void addPoints(const Vector<Point> &points, U32 geomType);
+
+   void flush(RenderBackend &backend); // Draw everything, and empty the buffer
+   void clear();                       // Empty the buffer without drawing anything
+
+   bool isEmpty() const;
+   S32 getCommandCount() const;        // Commands that would be flushed, before merging
+   S32 getVertexCount() const;
+
+   // The buffer the game view is collecting objects' primitives in, if any
+   static RenderCommandBuffer *getActive();
+   static void setActive(RenderCommandBuffer *buffer);
+};
+
+
+};
+
+#endif
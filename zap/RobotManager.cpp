@@ -392,7 +392,8 @@ void RobotManager::deleteAllBots()
 void RobotManager::clearMoves()
 {
    for(S32 i = 0; i < mRobots.size(); i++)
-      mRobots[i]->clearMove();
+      if(!mRobots[i]->isThinkDeferred())     // Bots waiting for their turn keep doing what they were doing
+         mRobots[i]->clearMove();
 }
 
 
@@ -6,6 +6,7 @@
 #include "ServerGame.h"
 
 #include "GameManager.h"
+#include "FrameAllocator.h"
 #include "gameType.h"
 #include "gameNetInterface.h"
 #include "masterConnection.h"
@@ -40,7 +41,8 @@ static bool instantiated;           // Just a little something to keep us from c
 // Constructor -- be sure to see Game constructor too!  Lots going on there!
 ServerGame::ServerGame(const Address &address, GameSettingsPtr settings, LevelSourcePtr levelSource, bool testMode, bool dedicated, bool hostOnServer) : 
       Game(address, settings),
-      mRobotManager(this, settings)
+      mRobotManager(this, settings),
+      mBotPerception(this)
 {
    TNLAssert(!instantiated, "Only one ServerGame at a time, please!  If this trips while testing, "
       "it is probably because a test failed before another instance could be deleted.  Try disabling "
@@ -97,6 +99,7 @@ ServerGame::ServerGame(const Address &address, GameSettingsPtr settings, LevelSo
 
    mNetInterface->setAllowsConnections(true);
    mMasterUpdateTimer.reset(UpdateServerStatusTime);
+   mFloodReportTimer.reset(FloodReportInterval);
 
    mSuspendor = NULL;
 
@@ -579,6 +582,7 @@ void ServerGame::cycleLevel(S32 nextLevel)
    mGameRecorderServer = NULL;
 
    cleanUp();
+   LuaScriptRunner::logStats();     // Keep an eye on script memory and JIT behavior from level to level
    mLevelSwitchTimer.clear();
    mScopeAlwaysList.clear();
 
@@ -1282,6 +1286,12 @@ Robot *ServerGame::findBot(const char *id)
 }
 
 
+BotPerception *ServerGame::getBotPerception()
+{
+   return &mBotPerception;
+}
+
+
 void ServerGame::removeBot(Robot *robot)
 {
    mRobotManager.removeBot(robot);
@@ -1426,12 +1436,18 @@ void ServerGame::idle(U32 timeDelta)
    mNetInterface->checkIncomingPackets();
    checkConnectionToMaster(timeDelta);                   // Connect to master server if not connected
 
-   mSettings->getBanList()->updateKickList(timeDelta);   // Unban players who's bans have expired
+   mSettings->getBanList()->updateKickList(timeDelta);   // Unban players whose kicks or bans have expired
 
    // Periodically update our status on the master, so they know what we're doing...
    if(mMasterUpdateTimer.update(timeDelta))
       updateStatusOnMaster();
 
+   if(mFloodReportTimer.update(timeDelta))
+   {
+      reportConnectFloods();
+      mFloodReportTimer.reset();
+   }
+
    // If we have a data transfer going on, process it
    if(!dataSender.isDone())
       dataSender.sendNextLine();
@@ -1451,6 +1467,8 @@ void ServerGame::idle(U32 timeDelta)
 
 
    mCurrentTime += timeDelta;
+   mBotPerception.invalidate();     // Things have moved since the bots last looked
+   FrameAllocator::reset();         // Nothing from last tick's frame arena survives past here
 
    for(S32 i = 0; i < getClientCount(); i++)
    {
@@ -1492,6 +1510,9 @@ void ServerGame::idle(U32 timeDelta)
       // Fire TickEvent, in case anyone is listening
       EventManager::get()->fireEvent(EventManager::TickEvent, botControlTickElapsed + timeDelta);
 
+      // Levelgens may have moved things around, and ships are about to move anyway
+      mBotPerception.invalidate();
+
       botControlTickTimer.reset();
    }
    
@@ -1518,6 +1539,7 @@ void ServerGame::idle(U32 timeDelta)
       mGameType->idle(BfObject::ServerIdleMainLoop, timeDelta);
 
    processDeleteList(timeDelta);
+   mBotPerception.invalidate();
 
    // Load a new level if the time is out on the current one
    if(mLevelSwitchTimer.update(timeDelta))
@@ -1591,6 +1613,23 @@ void ServerGame::processSimulatedStutter(U32 timeDelta)
 }
 
 
+// Only says something if there's something to say, so a quiet server stays quiet
+void ServerGame::reportConnectFloods()
+{
+   const ConnectFloodStats &stats = mNetInterface->getConnectFloodStats();
+
+   if(stats.getTotalDropped() == 0)
+      return;
+
+   logprintf(LogConsumer::ServerFilter, "Connection flood protection dropped %d challenge requests, %d connect requests, "
+                                        "%d invalid cookies, and %d bad puzzle solutions in the last minute",
+                                        stats.challengeRequestsDropped, stats.connectRequestsDropped,
+                                        stats.invalidCookies, stats.puzzleRejects);
+
+   mNetInterface->resetConnectFloodStats();
+}
+
+
 void ServerGame::processVoting(U32 timeDelta)
 {
    if(mVoteTimer != 0)
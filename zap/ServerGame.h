@@ -13,6 +13,7 @@
 #include "LevelSource.h"         // For LevelSourcePtr def
 #include "LevelSpecifierEnum.h"
 #include "RobotManager.h"
+#include "BotPerception.h"
 
 #include "Intervals.h"
 
@@ -43,9 +44,13 @@ private:
       UpdateServerStatusTime = TWENTY_SECONDS,    // How often we update our status on the master server (ms)
       UpdateServerWhenHostGoesEmpty = FOUR_SECONDS, // How many seconds when host on server when server goes empty or not empty
       CheckServerStatusTime = FIVE_SECONDS,       // If it did not send updates, recheck after ms
-      BotControlTickInterval = 33,                // Interval for how often should we let bots fire the onTick event (ms)
+      FloodReportInterval = ONE_MINUTE,           // How often we log dropped connection attempts, if there were any
    };
 
+public:
+   static const U32 BotControlTickInterval = 33;   // Interval for how often should we let bots fire the onTick event (ms)
+
+private:
    bool mTestMode;                        // True if being tested from editor
 
    GridDatabase mDatabaseForBotZones;     // Database especially for BotZones to avoid gumming up the regular database with too many objects
@@ -55,6 +60,7 @@ private:
    U32 mCurrentLevelIndex;                // Index of level currently being played
    Timer mLevelSwitchTimer;               // Track how long after game has ended before we actually switch levels
    Timer mMasterUpdateTimer;              // Periodically let the master know how we're doing
+   Timer mFloodReportTimer;               // Periodically report connection attempts dropped by flood protection
 
    bool mShuttingDown;
    string mShutdownReason;                // Message to local user about why we're shutting down, optional
@@ -86,6 +92,7 @@ private:
    U32 mAccumulatedSleepTime;
 
    RobotManager mRobotManager;
+   BotPerception mBotPerception;          // What the bots know about the world this frame
 
    Vector<LuaLevelGenerator *> mLevelGens;
    Vector<LuaLevelGenerator *> mLevelGenDeleteList;
@@ -96,6 +103,7 @@ private:
    void updateStatusOnMaster();           // Give master a status report for this server
    void processVoting(U32 timeDelta);     // Manage any ongoing votes
    void processSimulatedStutter(U32 timeDelta);
+   void reportConnectFloods();            // Log handshake packets dropped by the NetInterface since the last report
 
    string getLevelFileNameFromIndex(S32 indx);
 
@@ -201,6 +209,7 @@ public:
    //void deleteBotFromTeam(S32 teamIndex);
    void deleteAllBots();
    Robot *findBot(const char *id);
+   BotPerception *getBotPerception();
    void moreBots();
    void fewerBots();
    void kickSingleBotFromLargestTeamWithBots();
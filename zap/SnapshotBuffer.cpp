@@ -0,0 +1,148 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "SnapshotBuffer.h"
+
+#include "tnlAssert.h"
+
+namespace Zap
+{
+
+const S32 SnapshotBuffer::MaxSnapshots;
+const S32 SnapshotBuffer::MaxExtrapolationTime;
+
+
+// Constructor
+SnapshotBuffer::SnapshotBuffer()
+{
+   clear();
+}
+
+
+// Destructor
+SnapshotBuffer::~SnapshotBuffer()
+{
+   // Do nothing
+}
+
+
+// Index 0 is the oldest snapshot we have
+const SnapshotBuffer::Snapshot &SnapshotBuffer::getSnapshot(S32 index) const
+{
+   TNLAssert(index >= 0 && index < mCount, "Snapshot index out of range!");
+   return mSnapshots[(mFirst + index) % MaxSnapshots];
+}
+
+
+// Once we're full, the oldest snapshot makes way for the new one
+void SnapshotBuffer::add(U32 time, const Point &pos, const Point &vel, F32 angle)
+{
+   // Two updates arriving together; the later one wins
+   if(mCount > 0 && getSnapshot(mCount - 1).time == time)
+      mCount--;
+
+   if(mCount == MaxSnapshots)
+   {
+      mFirst = (mFirst + 1) % MaxSnapshots;
+      mCount--;
+   }
+
+   Snapshot &snapshot = mSnapshots[(mFirst + mCount) % MaxSnapshots];
+   snapshot.time = time;
+   snapshot.pos = pos;
+   snapshot.vel = vel;
+   snapshot.angle = angle;
+
+   mCount++;
+}
+
+
+void SnapshotBuffer::clear()
+{
+   mFirst = 0;
+   mCount = 0;
+}
+
+
+bool SnapshotBuffer::isEmpty() const
+{
+   return mCount == 0;
+}
+
+
+S32 SnapshotBuffer::getCount() const
+{
+   return mCount;
+}
+
+
+// Shortest way round from one angle to the other
+static F32 lerpAngle(F32 from, F32 to, F32 t)
+{
+   F32 delta = to - from;
+
+   while(delta > FloatPi)
+      delta -= Float2Pi;
+   while(delta < -FloatPi)
+      delta += Float2Pi;
+
+   return from + delta * t;
+}
+
+
+bool SnapshotBuffer::getState(U32 time, Point &pos, Point &vel, F32 &angle) const
+{
+   if(mCount == 0)
+      return false;
+
+   // Times are compared as differences so they still work when the clock wraps
+   const Snapshot &oldest = getSnapshot(0);
+   if(S32(time - oldest.time) <= 0)
+   {
+      pos = oldest.pos;
+      vel = oldest.vel;
+      angle = oldest.angle;
+      return true;
+   }
+
+   const Snapshot &newest = getSnapshot(mCount - 1);
+   if(S32(time - newest.time) >= 0)
+   {
+      // Ahead of anything we've heard about -- keep going the way we were, for a little while
+      F32 dt = getMin(S32(time - newest.time), MaxExtrapolationTime) * 0.001f;
+
+      pos = newest.pos + newest.vel * dt;
+      vel = newest.vel;
+      angle = newest.angle;
+      return true;
+   }
+
+   S32 i = mCount - 2;
+   while(S32(time - getSnapshot(i).time) < 0)
+      i--;
+
+   const Snapshot &from = getSnapshot(i);
+   const Snapshot &to = getSnapshot(i + 1);
+
+   // Cubic Hermite between the two states, so the curve is smooth and passes through each state at its velocity
+   F32 span = S32(to.time - from.time) * 0.001f;
+   F32 t = S32(time - from.time) * 0.001f / span;
+   F32 t2 = t * t;
+   F32 t3 = t2 * t;
+
+   F32 h00 =  2 * t3 - 3 * t2 + 1;
+   F32 h10 =      t3 - 2 * t2 + t;
+   F32 h01 = -2 * t3 + 3 * t2;
+   F32 h11 =      t3 -     t2;
+
+   pos = from.pos * h00 + from.vel * (h10 * span) + to.pos * h01 + to.vel * (h11 * span);
+   vel = from.vel * (1 - t) + to.vel * t;
+   angle = lerpAngle(from.angle, to.angle, t);
+
+   return true;
+}
+
+
+};
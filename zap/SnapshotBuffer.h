@@ -0,0 +1,59 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _SNAPSHOT_BUFFER_H_
+#define _SNAPSHOT_BUFFER_H_
+
+#include "Point.h"
+
+#include "tnlTypes.h"
+
+using namespace TNL;
+
+namespace Zap
+{
+
+// The last few states the server has sent us for an object, each stamped with when it arrived, so we can draw the object
+// a little in the past, moving smoothly from one state to the next, rather than chasing the latest one.  Gaps left by
+// slow or lost packets are bridged by interpolating between the states on either side.
+class SnapshotBuffer
+{
+public:
+   static const S32 MaxSnapshots = 8;
+   static const S32 MaxExtrapolationTime = 250;    // Ms we'll carry on past the latest state before we stop the object
+
+private:
+   struct Snapshot
+   {
+      U32 time;
+      Point pos;
+      Point vel;
+      F32 angle;
+   };
+
+   Snapshot mSnapshots[MaxSnapshots];    // Ring buffer, oldest first
+   S32 mFirst;
+   S32 mCount;
+
+   const Snapshot &getSnapshot(S32 index) const;
+
+public:
+   SnapshotBuffer();             // Constructor
+   virtual ~SnapshotBuffer();    // Destructor
+
+   void add(U32 time, const Point &pos, const Point &vel, F32 angle);
+   void clear();
+
+   bool isEmpty() const;
+   S32 getCount() const;
+
+   // Where the object was at time; returns false if we have nothing to go on
+   bool getState(U32 time, Point &pos, Point &vel, F32 &angle) const;
+};
+
+
+};
+
+#endif
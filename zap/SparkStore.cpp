@@ -0,0 +1,263 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "SparkStore.h"
+
+#include "Color.h"
+#include "Point.h"
+
+#include "tnlAssert.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define SPARKS_USE_SSE2
+#  include <emmintrin.h>
+#endif
+
+namespace Zap { namespace UI
+{
+
+const S32 SparkStore::MaxVertices;
+
+
+// Constructor
+SparkStore::SparkStore(SparkType type)
+{
+   setType(type);
+}
+
+
+// Destructor
+SparkStore::~SparkStore()
+{
+   // Do nothing
+}
+
+
+// Also clears the store, as the old sparks won't make sense any more
+void SparkStore::setType(SparkType type)
+{
+   mType = type;
+   mVertsPerSpark = (type == SparkTypeLine ? 2 : 1);
+   mFadeTime = (type == SparkTypeLine ? 250.0f : 1000.0f);
+   mLastOverwritten = 500;
+
+   clear();
+}
+
+
+SparkType SparkStore::getType() const
+{
+   return mType;
+}
+
+
+S32 SparkStore::claim(S32 sparkCount, S32 &claimed)
+{
+   S32 first = mSparkCount;
+
+   claimed = getCapacity() - mSparkCount;
+   if(claimed > sparkCount)
+      claimed = sparkCount;
+   if(claimed < 0)
+      claimed = 0;
+
+   mSparkCount += claimed;
+
+   return first;
+}
+
+
+// Out of room for new sparks.  We'll jump elsewhere in our array and overwrite some older spark.  Overwrite every nth
+// spark to avoid noticable artifacts by grabbing too many sparks from one place.
+S32 SparkStore::getOverwriteSlot()
+{
+   TNLAssert(mSparkCount > 0, "Nothing to overwrite!");
+
+   mLastOverwritten = (mLastOverwritten + 101) % mSparkCount;
+   return mLastOverwritten;
+}
+
+
+S32 SparkStore::getSlot()
+{
+   if(mSparkCount < getCapacity())
+      return mSparkCount++;
+
+   return getOverwriteSlot();
+}
+
+
+void SparkStore::setVertex(S32 vertex, const Point &pos, const Point &vel, const Color &color, S32 ttl)
+{
+   mPositions[vertex * 2]     = pos.x;
+   mPositions[vertex * 2 + 1] = pos.y;
+
+   mVelocities[vertex * 2]     = vel.x;
+   mVelocities[vertex * 2 + 1] = vel.y;
+
+   mColors[vertex * 4]     = color.r;
+   mColors[vertex * 4 + 1] = color.g;
+   mColors[vertex * 4 + 2] = color.b;
+   mColors[vertex * 4 + 3] = 1;
+
+   mTtls[vertex] = ttl;
+}
+
+
+void SparkStore::setSpark(S32 slot, const Point &pos, const Point &vel, const Color &color, S32 ttl)
+{
+   TNLAssert(slot >= 0 && slot < mSparkCount, "Spark slot out of range!");
+
+   S32 vertex = slot * mVertsPerSpark;
+
+   setVertex(vertex, pos, vel, color, ttl);
+
+   if(mType == SparkTypeLine)       // Line sparks have a tail, trailing behind the head
+   {
+      Point len = vel;
+      len.normalize(20);
+
+      // Give the trailing edge of this spark a fade effect
+      setVertex(vertex + 1, pos - len, vel, Color(color.r, color.g * 0.25f, color.b * 0.25f), ttl);
+   }
+}
+
+
+void SparkStore::copySpark(S32 from, S32 to)
+{
+   for(S32 i = 0; i < mVertsPerSpark; i++)
+   {
+      S32 src  = from * mVertsPerSpark + i;
+      S32 dest = to   * mVertsPerSpark + i;
+
+      mPositions[dest * 2]     = mPositions[src * 2];
+      mPositions[dest * 2 + 1] = mPositions[src * 2 + 1];
+
+      mVelocities[dest * 2]     = mVelocities[src * 2];
+      mVelocities[dest * 2 + 1] = mVelocities[src * 2 + 1];
+
+      for(S32 j = 0; j < 4; j++)
+         mColors[dest * 4 + j] = mColors[src * 4 + j];
+
+      mTtls[dest] = mTtls[src];
+   }
+}
+
+
+// Moves every spark, ages it, and works out how faded it is, then drops the ones that have died.  The first part is
+// done four floats at a time with SSE2 where we have it, with a plain loop finishing off whatever is left over.
+void SparkStore::idle(U32 timeDelta)
+{
+   const S32 vertexCount = getVertexCount();
+   const F32 dTsecs = timeDelta * 0.001f;
+   const F32 fadeScale = 1 / mFadeTime;
+
+   S32 i = 0;
+
+#ifdef SPARKS_USE_SSE2
+   const __m128 dT = _mm_set1_ps(dTsecs);
+
+   // Positions and velocities are both x, y, x, y... so two vertices per register
+   for(; i + 4 <= vertexCount * 2; i += 4)
+   {
+      __m128 pos = _mm_loadu_ps(mPositions + i);
+      __m128 vel = _mm_loadu_ps(mVelocities + i);
+      _mm_storeu_ps(mPositions + i, _mm_add_ps(pos, _mm_mul_ps(vel, dT)));
+   }
+#endif
+
+   for(; i < vertexCount * 2; i++)
+      mPositions[i] += mVelocities[i] * dTsecs;
+
+   i = 0;
+
+#ifdef SPARKS_USE_SSE2
+   const __m128i delta = _mm_set1_epi32(S32(timeDelta));
+   const __m128 fadeTime = _mm_set1_ps(mFadeTime);
+   const __m128 scale = _mm_set1_ps(fadeScale);
+
+   F32 alphas[4];
+
+   for(; i + 4 <= vertexCount; i += 4)
+   {
+      __m128i ttl = _mm_sub_epi32(_mm_loadu_si128((__m128i *)(mTtls + i)), delta);
+      _mm_storeu_si128((__m128i *)(mTtls + i), ttl);
+
+      // alpha = min(ttl, fadeTime) / fadeTime
+      _mm_storeu_ps(alphas, _mm_mul_ps(_mm_min_ps(_mm_cvtepi32_ps(ttl), fadeTime), scale));
+
+      // Colors are interleaved, so the alphas have to go in one at a time
+      mColors[i * 4 + 3]  = alphas[0];
+      mColors[i * 4 + 7]  = alphas[1];
+      mColors[i * 4 + 11] = alphas[2];
+      mColors[i * 4 + 15] = alphas[3];
+   }
+#endif
+
+   for(; i < vertexCount; i++)
+   {
+      mTtls[i] -= S32(timeDelta);
+      mColors[i * 4 + 3] = (mTtls[i] > mFadeTime ? mFadeTime : F32(mTtls[i])) * fadeScale;
+   }
+
+   // Spark is dead -- replace it with the last one.  Both ends of a line spark have the same ttl, so we only check the head.
+   for(S32 j = 0; j < mSparkCount; )
+   {
+      if(mTtls[j * mVertsPerSpark] < 0)
+      {
+         mSparkCount--;
+         copySpark(mSparkCount, j);
+      }
+      else
+         j++;
+   }
+}
+
+
+void SparkStore::clear()
+{
+   mSparkCount = 0;
+}
+
+
+S32 SparkStore::getSparkCount() const
+{
+   return mSparkCount;
+}
+
+
+S32 SparkStore::getVertexCount() const
+{
+   return mSparkCount * mVertsPerSpark;
+}
+
+
+// In sparks
+S32 SparkStore::getCapacity() const
+{
+   return MaxVertices / mVertsPerSpark;
+}
+
+
+const F32 *SparkStore::getPositions() const
+{
+   return mPositions;
+}
+
+
+const F32 *SparkStore::getColors() const
+{
+   return mColors;
+}
+
+
+S32 SparkStore::getTtl(S32 slot) const
+{
+   return mTtls[slot * mVertsPerSpark];
+}
+
+
+}  }     // Nested namespace
+
@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _SPARK_STORE_H_
+#define _SPARK_STORE_H_
+
+#include "SparkTypesEnum.h"
+
+#include "tnlTypes.h"
+
+using namespace TNL;
+
+namespace Zap
+{
+
+class Color;
+class Point;
+
+namespace UI
+{
+
+// Holds all the sparks of one type, a vertex at a time, as parallel arrays rather than an array of structs.  Positions
+// and colors are laid out just as OpenGL wants them, so they can be handed straight to glVertexPointer/glColorPointer,
+// and idle() can advance several sparks per instruction.
+//
+// Point sparks are one vertex each, line sparks are two (head and tail), stored next to each other.
+class SparkStore
+{
+public:
+   static const S32 MaxVertices = 8192;    // Per store; make this an even number
+
+private:
+   SparkType mType;
+   S32 mVertsPerSpark;
+   F32 mFadeTime;             // Sparks fade out over the last mFadeTime ms of their lives
+   S32 mSparkCount;
+   S32 mLastOverwritten;      // Keep track of which spark we last overwrote
+
+   F32 mPositions[MaxVertices * 2];    // x, y
+   F32 mVelocities[MaxVertices * 2];   // x, y
+   F32 mColors[MaxVertices * 4];       // r, g, b, alpha
+   S32 mTtls[MaxVertices];             // Milliseconds
+
+   void setVertex(S32 vertex, const Point &pos, const Point &vel, const Color &color, S32 ttl);
+   void copySpark(S32 from, S32 to);
+
+public:
+   explicit SparkStore(SparkType type = SparkTypePoint);    // Constructor
+   virtual ~SparkStore();                                   // Destructor
+
+   void setType(SparkType type);
+   SparkType getType() const;
+
+   // Makes room for up to sparkCount more sparks in one run at the end of the store, and returns the index of the first.
+   // claimed is set to how many there was room for; once we're full, the rest have to come from getOverwriteSlot().
+   S32 claim(S32 sparkCount, S32 &claimed);
+   S32 getOverwriteSlot();
+   S32 getSlot();             // Appends if there's room, overwrites if not
+
+   void setSpark(S32 slot, const Point &pos, const Point &vel, const Color &color, S32 ttl);
+
+   void idle(U32 timeDelta);
+   void clear();
+
+   S32 getSparkCount() const;
+   S32 getVertexCount() const;
+   S32 getCapacity() const;
+
+   const F32 *getPositions() const;
+   const F32 *getColors() const;
+   S32 getTtl(S32 slot) const;
+};
+
+
+}  }     // Nested namespace
+
+#endif
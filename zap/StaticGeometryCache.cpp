@@ -0,0 +1,165 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "StaticGeometryCache.h"
+
+#include <math.h>
+
+namespace Zap
+{
+
+// Constructor
+StaticGeometryCache::StaticGeometryCache(S32 cellSize)
+{
+   mCellSize = F32(cellSize);
+   mLineVertexCount = 0;
+   mTriangleVertexCount = 0;
+}
+
+
+// Destructor
+StaticGeometryCache::~StaticGeometryCache()
+{
+   // Do nothing
+}
+
+
+void StaticGeometryCache::clear()
+{
+   mCells.clear();
+   mCellIndex.clear();
+
+   mLineVertexCount = 0;
+   mTriangleVertexCount = 0;
+}
+
+
+// Finds (or creates) the cell that center falls in, and grows it to cover extent
+StaticGeometryCache::Cell &StaticGeometryCache::getCell(const Point &center, const Rect &extent)
+{
+   S32 x = S32(floor(center.x / mCellSize));
+   S32 y = S32(floor(center.y / mCellSize));
+
+   std::pair<S32, S32> key(x, y);
+   std::map<std::pair<S32, S32>, S32>::iterator it = mCellIndex.find(key);
+
+   if(it != mCellIndex.end())
+   {
+      Cell &cell = mCells[it->second];
+      cell.extent.unionRect(extent);
+      return cell;
+   }
+
+   mCellIndex[key] = mCells.size();
+
+   Cell cell;
+   cell.x = x;
+   cell.y = y;
+   cell.extent = extent;
+
+   mCells.push_back(cell);
+   return mCells.last();
+}
+
+
+void StaticGeometryCache::addLines(const Vector<Point> &segments)
+{
+   for(S32 i = 0; i + 1 < segments.size(); i += 2)
+   {
+      const Point &p1 = segments[i];
+      const Point &p2 = segments[i + 1];
+
+      Cell &cell = getCell((p1 + p2) * 0.5f, Rect(p1, p2));
+      cell.lines.push_back(p1);
+      cell.lines.push_back(p2);
+
+      mLineVertexCount += 2;
+   }
+}
+
+
+void StaticGeometryCache::addTriangles(const Vector<Point> &triangles)
+{
+   for(S32 i = 0; i + 2 < triangles.size(); i += 3)
+   {
+      const Point &p1 = triangles[i];
+      const Point &p2 = triangles[i + 1];
+      const Point &p3 = triangles[i + 2];
+
+      Rect extent(p1, p2);
+      extent.unionPoint(p3);
+
+      Cell &cell = getCell((p1 + p2 + p3) * (1.0f / 3), extent);
+      cell.triangles.push_back(p1);
+      cell.triangles.push_back(p2);
+      cell.triangles.push_back(p3);
+
+      mTriangleVertexCount += 3;
+   }
+}
+
+
+// Fans are kept together, in the cell their first point is in, so they come out looking just as they went in
+void StaticGeometryCache::addTriangleFan(const Vector<Point> &fan)
+{
+   if(fan.size() < 3)
+      return;
+
+   Cell &cell = getCell(fan[0], Rect(fan));
+
+   for(S32 i = 1; i + 1 < fan.size(); i++)
+   {
+      cell.triangles.push_back(fan[0]);
+      cell.triangles.push_back(fan[i]);
+      cell.triangles.push_back(fan[i + 1]);
+
+      mTriangleVertexCount += 3;
+   }
+}
+
+
+S32 StaticGeometryCache::getCellCount() const
+{
+   return mCells.size();
+}
+
+
+const StaticGeometryCache::Cell &StaticGeometryCache::getCell(S32 index) const
+{
+   return mCells[index];
+}
+
+
+void StaticGeometryCache::findVisibleCells(const Rect &rect, Vector<const Cell *> &cells) const
+{
+   cells.clear();
+
+   Rect visibleRect(rect);
+
+   for(S32 i = 0; i < mCells.size(); i++)
+      if(visibleRect.intersectsOrBorders(mCells[i].extent))
+         cells.push_back(&mCells[i]);
+}
+
+
+S32 StaticGeometryCache::getLineVertexCount() const
+{
+   return mLineVertexCount;
+}
+
+
+S32 StaticGeometryCache::getTriangleVertexCount() const
+{
+   return mTriangleVertexCount;
+}
+
+
+bool StaticGeometryCache::isEmpty() const
+{
+   return mCells.size() == 0;
+}
+
+
+};
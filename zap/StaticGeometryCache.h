@@ -0,0 +1,75 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _STATIC_GEOMETRY_CACHE_H_
+#define _STATIC_GEOMETRY_CACHE_H_
+
+#include "Point.h"
+#include "Rect.h"
+
+#include "tnlTypes.h"
+#include "tnlVector.h"
+
+#include <map>
+
+using namespace TNL;
+
+namespace Zap
+{
+
+// Render-ready copies of geometry that doesn't change from frame to frame -- wall edges and fills, mostly -- split
+// into square cells so we only need to draw the ones that are on screen.  Build it once when the geometry is created
+// (or edited), then each frame ask for the cells that overlap the view.
+//
+// Every primitive lives in exactly one cell, the one its center falls in.  Primitives can stick out past their cell's
+// nominal bounds, so each cell keeps the actual extent of what's in it, and that's what we cull against.
+class StaticGeometryCache
+{
+public:
+   static const S32 DefaultCellSize = 512;
+
+   struct Cell
+   {
+      S32 x, y;                  // Which cell, in cell units
+      Rect extent;               // Bounding box of everything in the cell
+      Vector<Point> lines;       // Pairs of points, ready for GL_LINES
+      Vector<Point> triangles;   // Triples of points, ready for GL_TRIANGLES
+   };
+
+private:
+   F32 mCellSize;
+   Vector<Cell> mCells;
+   std::map<std::pair<S32, S32>, S32> mCellIndex;     // Cell coordinates -> index into mCells
+
+   S32 mLineVertexCount;
+   S32 mTriangleVertexCount;
+
+   Cell &getCell(const Point &center, const Rect &extent);
+
+public:
+   explicit StaticGeometryCache(S32 cellSize = DefaultCellSize);     // Constructor
+   virtual ~StaticGeometryCache();                                   // Destructor
+
+   void clear();
+
+   void addLines(const Vector<Point> &segments);         // As for GL_LINES
+   void addTriangles(const Vector<Point> &triangles);    // As for GL_TRIANGLES
+   void addTriangleFan(const Vector<Point> &fan);        // As for GL_TRIANGLE_FAN
+
+   S32 getCellCount() const;
+   const Cell &getCell(S32 index) const;
+
+   // Fills cells with those whose contents overlap rect, in the order they were created
+   void findVisibleCells(const Rect &rect, Vector<const Cell *> &cells) const;
+
+   S32 getLineVertexCount() const;
+   S32 getTriangleVertexCount() const;
+   bool isEmpty() const;
+};
+
+
+};
+
+#endif
@@ -19,6 +19,8 @@
 
 #include "GameManager.h"
 #include "ServerGame.h"          
+#include "ObjectPool.h"
+#include "FrameAllocator.h"
 
 #include "Colors.h"
 #include "gameObjectRender.h"    // For drawCircle in badge rendering below
@@ -39,10 +41,11 @@ namespace Zap
 static const char *pageHeaders[] = {
    "PLAYING",
    "FOLDERS",
-   "HOSTING"
+   "HOSTING",
+   "MEMORY"
 };
 
-static const S32 NUM_PAGES = 3;
+static const S32 NUM_PAGES = 4;
 
 
 
@@ -799,6 +802,70 @@ void DiagnosticUserInterface::render()
       }
 #endif // TNL_DEBUG
    }
+   else if(mCurPage == 3)
+   {
+      S32 gap = 5;
+      S32 textsize = 16;
+
+      S32 ypos = vertMargin + 35;
+
+      // Pools are shared by everything in this process, so when hosting, these include the server's objects too
+      glColor(Colors::red);
+      drawCenteredString(ypos, textsize, "Object pools");
+      ypos += textsize + gap + gap;
+
+      const S32 cols[] = { horizMargin, 300, 420, 540, 660 };
+
+      glColor(Colors::yellow);
+      drawString(cols[0], ypos, textsize, "Class");
+      drawString(cols[1], ypos, textsize, "Live");
+      drawString(cols[2], ypos, textsize, "Peak");
+      drawString(cols[3], ypos, textsize, "Allocs");
+      drawString(cols[4], ypos, textsize, "Heap");
+      ypos += textsize + gap;
+
+      const Vector<ObjectPool *> &pools = ObjectPool::getPools();
+
+      glColor(Colors::white);
+      for(S32 i = 0; i < pools.size(); i++)
+      {
+         drawString (cols[0], ypos, textsize, pools[i]->getName());
+         drawStringf(cols[1], ypos, textsize, "%d", pools[i]->getLiveCount());
+         drawStringf(cols[2], ypos, textsize, "%d", pools[i]->getPeakCount());
+         drawStringf(cols[3], ypos, textsize, "%d", pools[i]->getAllocCount());
+         drawStringf(cols[4], ypos, textsize, "%d", pools[i]->getHeapCount());
+         ypos += textsize + gap;
+      }
+
+      if(pools.size() == 0)
+      {
+         drawString(horizMargin, ypos, textsize, "Nothing pooled has been created yet");
+         ypos += textsize + gap;
+      }
+
+      ypos += textsize + gap;
+
+      // Only the server resets the frame arena, so it has nothing to show unless we're hosting
+      const FrameAllocator::Stats &stats = FrameAllocator::getLastFrameStats();
+
+      glColor(Colors::red);
+      drawCenteredString(ypos, textsize, "Server frame arena (last tick)");
+      ypos += textsize + gap + gap;
+
+      glColor(Colors::white);
+      drawCenteredStringPair2Colf(ypos, textsize, true,  "Allocations:", "%d", stats.allocCount);
+      drawCenteredStringPair2Colf(ypos, textsize, false, "Bytes:", "%d", stats.allocBytes);
+      ypos += textsize + gap;
+
+      drawCenteredStringPair2Colf(ypos, textsize, true,  "Oversized:", "%d", stats.largeCount);
+      drawCenteredStringPair2Colf(ypos, textsize, false, "Peak Bytes:", "%d", FrameAllocator::getPeakBytes());
+      ypos += textsize + gap;
+
+#ifdef BF_COUNT_ALLOCATIONS
+      drawCenteredStringPair2Colf(ypos, textsize, true,  "Heap Allocations:", "%d", stats.heapCount);
+      ypos += textsize + gap;
+#endif
+   }
 }
 
 };
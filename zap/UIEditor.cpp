@@ -2157,7 +2157,7 @@ void EditorUserInterface::renderWallsAndPolywalls(GridDatabase *database, const
 
    const Color &outlineColor = mNormalizedScreenshotMode ? Colors::DefaultWallOutlineColor : *settings->getWallOutlineColor();
 
-   renderWalls(wsm->getWallSegmentDatabase(), *wsm->getWallEdgePoints(), *wsm->getSelectedWallEdgePoints(), outlineColor,
+   renderWalls(wsm->getWallSegmentDatabase(), wsm->getRenderCache(), getDisplayExtents(), *wsm->getSelectedWallEdgePoints(), outlineColor,
                fillColor, mCurrentScale, mDraggingObjects, drawSelected, offset, mPreviewMode, 
                getSnapToWallCorners(), getRenderingAlpha(isLevelGenDatabase));
 
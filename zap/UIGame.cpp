@@ -2687,6 +2687,7 @@ HelpItemManager *GameUserInterface::getHelpItemManager()
 static Point screenSize, visSize, visExt;
 static Vector<DatabaseObject *> rawRenderObjects;
 static Vector<BfObject *> renderObjects;
+static RenderCommandBuffer renderCommands;    // Collects simple items' primitives while we render a layer
 static Vector<BotNavMeshZone *> renderZones;
 
 
@@ -2791,15 +2792,25 @@ void GameUserInterface::renderGameNormal()
    // Render in three passes, to ensure some objects are drawn above others
    for(S32 i = -1; i < 2; i++)
    {
-      Barrier::renderEdges(i, *getGame()->getSettings()->getWallOutlineColor());    // Render wall edges
+      Barrier::renderEdges(i, extentRect, *getGame()->getSettings()->getWallOutlineColor());    // Render wall edges in view
 
       if(mDebugShowMeshZones)
          for(S32 j = 0; j < renderZones.size(); j++)
             renderZones[j]->renderLayer(i);
 
+      // Projectiles, mines, asteroids and the like go into renderCommands instead of drawing themselves, and
+      // are drawn here in a handful of batches, on top of whatever else is in this layer
+      RenderCommandBuffer::setActive(&renderCommands);
+      renderCommands.setLayer(i);
+
       for(S32 j = 0; j < renderObjects.size(); j++)
          renderObjects[j]->renderLayer(i);
 
+      RenderCommandBuffer::setActive(NULL);
+
+      GLRenderBackend backend;
+      renderCommands.flush(backend);
+
       mFxManager.render(i, getCommanderZoomFraction());
    }
 
@@ -0,0 +1,320 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "WallEdgeGrid.h"
+
+#include "gridDB.h"
+#include "GeomUtils.h"
+
+#include <math.h>
+
+namespace Zap
+{
+
+// Constructor
+WallEdgeGrid::WallEdgeGrid()
+{
+   clear();
+}
+
+
+// Destructor
+WallEdgeGrid::~WallEdgeGrid()
+{
+   // Do nothing
+}
+
+
+void WallEdgeGrid::clear()
+{
+   mCellSize = CellSize;
+   mOrigin.set(0, 0);
+   mCols = 0;
+   mRows = 0;
+
+   mCellStart.clear();
+   mX.clear();
+   mY.clear();
+   mDx.clear();
+   mDy.clear();
+}
+
+
+// Lay out the edges of every wall's collision poly in our grid
+void WallEdgeGrid::build(const Vector<DatabaseObject *> &walls)
+{
+   clear();
+
+   // Gather edges the same way polygonIntersectsSegmentDetailed() walks them: last vertex to first, then around
+   Vector<Point> edges;    // A-B, C-D format
+
+   for(S32 i = 0; i < walls.size(); i++)
+   {
+      if(!walls[i]->isCollisionEnabled())
+         continue;
+
+      const Vector<Point> *poly = walls[i]->getCollisionPoly();
+      if(!poly || poly->size() == 0)
+         continue;
+
+      Point prev = poly->last();
+      for(S32 j = 0; j < poly->size(); j++)
+      {
+         edges.push_back(prev);
+         edges.push_back(poly->get(j));
+         prev = poly->get(j);
+      }
+   }
+
+   if(edges.size() == 0)
+      return;
+
+   Point min = edges[0], max = edges[0];
+   for(S32 i = 1; i < edges.size(); i++)
+   {
+      min.set(getMin(min.x, edges[i].x), getMin(min.y, edges[i].y));
+      max.set(getMax(max.x, edges[i].x), getMax(max.y, edges[i].y));
+   }
+
+   // Huge levels get bigger cells rather than a huge grid
+   mOrigin = min;
+   mCellSize = CellSize;
+
+   while(true)
+   {
+      mCols = S32((max.x - min.x) / mCellSize) + 1;
+      mRows = S32((max.y - min.y) / mCellSize) + 1;
+
+      if(mCols <= MaxCellsPerSide && mRows <= MaxCellsPerSide)
+         break;
+
+      mCellSize *= 2;
+   }
+
+   // First pass: count edges per cell; second pass: drop them into place
+   Vector<S32> counts;
+   counts.resize(mCols * mRows);
+   for(S32 i = 0; i < counts.size(); i++)
+      counts[i] = 0;
+
+   S32 minCol, minRow, maxCol, maxRow;
+
+   for(S32 i = 0; i < edges.size(); i += 2)
+   {
+      Point emin(getMin(edges[i].x, edges[i+1].x), getMin(edges[i].y, edges[i+1].y));
+      Point emax(getMax(edges[i].x, edges[i+1].x), getMax(edges[i].y, edges[i+1].y));
+
+      findCells(emin, emax, minCol, minRow, maxCol, maxRow);
+
+      for(S32 row = minRow; row <= maxRow; row++)
+         for(S32 col = minCol; col <= maxCol; col++)
+            counts[row * mCols + col]++;
+   }
+
+   mCellStart.resize(counts.size() + 1);
+   mCellStart[0] = 0;
+   for(S32 i = 0; i < counts.size(); i++)
+      mCellStart[i + 1] = mCellStart[i] + counts[i];
+
+   S32 total = mCellStart.last();
+   mX.resize(total);
+   mY.resize(total);
+   mDx.resize(total);
+   mDy.resize(total);
+
+   for(S32 i = 0; i < counts.size(); i++)
+      counts[i] = mCellStart[i];     // Now the next free slot in each cell
+
+   for(S32 i = 0; i < edges.size(); i += 2)
+   {
+      Point emin(getMin(edges[i].x, edges[i+1].x), getMin(edges[i].y, edges[i+1].y));
+      Point emax(getMax(edges[i].x, edges[i+1].x), getMax(edges[i].y, edges[i+1].y));
+
+      findCells(emin, emax, minCol, minRow, maxCol, maxRow);
+
+      for(S32 row = minRow; row <= maxRow; row++)
+         for(S32 col = minCol; col <= maxCol; col++)
+         {
+            S32 slot = counts[row * mCols + col]++;
+
+            mX[slot]  = edges[i].x;
+            mY[slot]  = edges[i].y;
+            mDx[slot] = edges[i+1].x - edges[i].x;
+            mDy[slot] = edges[i+1].y - edges[i].y;
+         }
+   }
+}
+
+
+S32 WallEdgeGrid::getEdgeCount() const
+{
+   return mX.size();
+}
+
+
+// Find the range of cells overlapping the box min-max; returns false if it misses the grid entirely
+bool WallEdgeGrid::findCells(const Point &min, const Point &max, S32 &minCol, S32 &minRow, S32 &maxCol, S32 &maxRow) const
+{
+   minCol = S32(floor((min.x - mOrigin.x) / mCellSize));
+   minRow = S32(floor((min.y - mOrigin.y) / mCellSize));
+   maxCol = S32(floor((max.x - mOrigin.x) / mCellSize));
+   maxRow = S32(floor((max.y - mOrigin.y) / mCellSize));
+
+   if(maxCol < 0 || maxRow < 0 || minCol >= mCols || minRow >= mRows)
+      return false;
+
+   minCol = getMax(minCol, 0);
+   minRow = getMax(minRow, 0);
+   maxCol = getMin(maxCol, mCols - 1);
+   maxRow = getMin(maxRow, mRows - 1);
+
+   return true;
+}
+
+
+// Does segment start-end cross any edge in this cell?  Same math as polygonIntersectsSegmentDetailed(), but with no
+// branches in the loop.  Where denom is 0, s and t come out inf or NaN, which fail the range checks on their own.
+bool WallEdgeGrid::cellHits(S32 cell, const Point &start, const Point &end) const
+{
+   const F32 *x  = mX.address();
+   const F32 *y  = mY.address();
+   const F32 *dx = mDx.address();
+   const F32 *dy = mDy.address();
+
+   const F32 dpx = end.x - start.x;
+   const F32 dpy = end.y - start.y;
+
+   S32 hit = 0;
+
+   for(S32 i = mCellStart[cell]; i < mCellStart[cell + 1]; i++)
+   {
+      F32 denom = dpy * dx[i] - dpx * dy[i];
+      F32 ox = start.x - x[i];
+      F32 oy = y[i] - start.y;
+
+      F32 s = (ox * dy[i] + oy * dx[i]) / denom;
+      F32 t = (ox * dpy + oy * dpx) / denom;
+
+      hit |= (s >= 0) & (s <= 1) & (t >= 0) & (t <= 1);
+   }
+
+   return hit != 0;
+}
+
+
+bool WallEdgeGrid::segmentIsClear(const Point &start, const Point &end) const
+{
+   S32 minCol, minRow, maxCol, maxRow;
+
+   Point min(getMin(start.x, end.x), getMin(start.y, end.y));
+   Point max(getMax(start.x, end.x), getMax(start.y, end.y));
+
+   if(mCols == 0 || !findCells(min, max, minCol, minRow, maxCol, maxRow))
+      return true;
+
+   Point dp = end - start;
+
+   for(S32 row = minRow; row <= maxRow; row++)
+      for(S32 col = minCol; col <= maxCol; col++)
+      {
+         S32 cell = row * mCols + col;
+
+         if(mCellStart[cell] == mCellStart[cell + 1])
+            continue;
+
+         // Skip cells in the segment's bounding box that the line doesn't pass through -- that's when all four
+         // corners fall on the same side of it
+         if(minCol != maxCol && minRow != maxRow)
+         {
+            F32 left   = mOrigin.x + col * mCellSize - start.x;
+            F32 bottom = mOrigin.y + row * mCellSize - start.y;
+            F32 right  = left + mCellSize;
+            F32 top    = bottom + mCellSize;
+
+            F32 c1 = dp.x * bottom - dp.y * left;
+            F32 c2 = dp.x * bottom - dp.y * right;
+            F32 c3 = dp.x * top    - dp.y * left;
+            F32 c4 = dp.x * top    - dp.y * right;
+
+            if((c1 > 0 && c2 > 0 && c3 > 0 && c4 > 0) || (c1 < 0 && c2 < 0 && c3 < 0 && c4 < 0))
+               continue;
+         }
+
+         if(cellHits(cell, start, end))
+            return false;
+      }
+
+   return true;
+}
+
+
+// Test a batch of segments; results[i] is for the segment from segments[2 * i] to segments[2 * i + 1]
+void WallEdgeGrid::segmentsAreClear(const Vector<Point> &segments, Vector<bool> &results) const
+{
+   results.resize(segments.size() / 2);
+
+   for(S32 i = 0; i < results.size(); i++)
+      results[i] = segmentIsClear(segments[2 * i], segments[2 * i + 1]);
+}
+
+
+bool WallEdgeGrid::polygonIsClear(const Vector<Point> &poly) const
+{
+   if(mCols == 0 || poly.size() == 0)
+      return true;
+
+   static Vector<Point> sides;
+   static Vector<bool> sideIsClear;
+
+   sides.clear();
+
+   Point prev = poly.last();
+   for(S32 i = 0; i < poly.size(); i++)
+   {
+      sides.push_back(prev);
+      sides.push_back(poly[i]);
+      prev = poly[i];
+   }
+
+   segmentsAreClear(sides, sideIsClear);
+
+   for(S32 i = 0; i < sideIsClear.size(); i++)
+      if(!sideIsClear[i])
+         return false;
+
+   // Nothing crosses our outline, but a small wall could still be sitting entirely inside it
+   Point min = poly[0], max = poly[0];
+   for(S32 i = 1; i < poly.size(); i++)
+   {
+      min.set(getMin(min.x, poly[i].x), getMin(min.y, poly[i].y));
+      max.set(getMax(max.x, poly[i].x), getMax(max.y, poly[i].y));
+   }
+
+   S32 minCol, minRow, maxCol, maxRow;
+   if(!findCells(min, max, minCol, minRow, maxCol, maxRow))
+      return true;
+
+   for(S32 row = minRow; row <= maxRow; row++)
+      for(S32 col = minCol; col <= maxCol; col++)
+      {
+         S32 cell = row * mCols + col;
+
+         for(S32 i = mCellStart[cell]; i < mCellStart[cell + 1]; i++)
+         {
+            Point vertex(mX[i], mY[i]);
+
+            if(vertex.x < min.x || vertex.x > max.x || vertex.y < min.y || vertex.y > max.y)
+               continue;
+
+            if(polygonContainsPoint(poly.address(), poly.size(), vertex))
+               return false;
+         }
+      }
+
+   return true;
+}
+
+
+};
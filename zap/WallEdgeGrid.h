@@ -0,0 +1,66 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _WALL_EDGE_GRID_H_
+#define _WALL_EDGE_GRID_H_
+
+#include "Point.h"
+
+#include "tnlTypes.h"
+#include "tnlVector.h"
+
+using namespace TNL;
+
+namespace Zap
+{
+
+class DatabaseObject;
+
+// Wall edges, and nothing else, arranged for fast line-of-sight tests.  Walls don't move during a game, so we can
+// afford to lay their edges out flat: each grid cell holds a copy of every edge that touches it, stored as parallel
+// arrays so the inner loop is a straight run over contiguous floats with no virtual calls, which compilers will
+// happily vectorize.
+//
+// Answers are the same as GridDatabase::findObjectLOS() with isWallType would give, but without the collision time
+// or normal.
+class WallEdgeGrid
+{
+private:
+   static const S32 CellSize = 256;
+   static const S32 MaxCellsPerSide = 128;
+
+   F32 mCellSize;
+   Point mOrigin;
+   S32 mCols, mRows;
+
+   Vector<S32> mCellStart;    // Edges for cell i are at [mCellStart[i], mCellStart[i + 1])
+
+   // Edge i runs from (mX[i], mY[i]) to (mX[i] + mDx[i], mY[i] + mDy[i])
+   Vector<F32> mX, mY, mDx, mDy;
+
+   bool findCells(const Point &min, const Point &max, S32 &minCol, S32 &minRow, S32 &maxCol, S32 &maxRow) const;
+   bool cellHits(S32 cell, const Point &start, const Point &end) const;
+
+public:
+   WallEdgeGrid();            // Constructor
+   virtual ~WallEdgeGrid();   // Destructor
+
+   void clear();
+   void build(const Vector<DatabaseObject *> &walls);
+
+   S32 getEdgeCount() const;     // Including copies in multiple cells
+
+   bool segmentIsClear(const Point &start, const Point &end) const;
+   void segmentsAreClear(const Vector<Point> &segments, Vector<bool> &results) const;   // Segments in A-B, C-D format
+
+   // True if no wall edge crosses the polygon and no wall lies inside it.  Does not detect a polygon lying entirely
+   // inside a wall, which can't happen to anything that collides with walls.
+   bool polygonIsClear(const Vector<Point> &poly) const;
+};
+
+
+};
+
+#endif
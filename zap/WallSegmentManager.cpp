@@ -25,6 +25,8 @@ WallSegmentManager::WallSegmentManager()
    // These deleted in the destructor
    mWallSegmentDatabase = new GridDatabase(false);      
    mWallEdgeDatabase    = new GridDatabase(false);
+
+   mRenderCacheDirty = true;
 }
 
 
@@ -135,6 +137,7 @@ void WallSegmentManager::rebuildEdges()
    // Data flow in this method: wallSegments -> wallEdgePoints -> wallEdges
 
    mWallEdgePoints.clear();
+   mRenderCacheDirty = true;
 
    // Run clipper --> fills mWallEdgePoints from mWallSegments
    clipAllWallEdges(mWallSegmentDatabase->findObjects_fast(), mWallEdgePoints);    
@@ -154,6 +157,7 @@ void WallSegmentManager::rebuildEdges()
 void WallSegmentManager::buildAllWallSegmentEdgesAndPoints(GridDatabase *database)
 {
    mWallSegmentDatabase->removeEverythingFromDatabase();
+   mRenderCacheDirty = true;
 
    fillVector.clear();
    database->findObjects((TestFunc)isWallType, fillVector);
@@ -289,6 +293,7 @@ void WallSegmentManager::clear()
    mWallSegmentDatabase->removeEverythingFromDatabase();
 
    mWallEdgePoints.clear();
+   mRenderCacheDirty = true;
 }
 
 
@@ -301,6 +306,8 @@ void WallSegmentManager::clearSelected()
       WallSegment *wallSegment = static_cast<WallSegment *>(mWallSegmentDatabase->getObjectByIndex(i));
       wallSegment->setSelected(false);
    }
+
+   mRenderCacheDirty = true;
 }
 
 
@@ -316,6 +323,30 @@ const Vector<Point> *WallSegmentManager::getSelectedWallEdgePoints() const
 }
 
 
+// Editing walls rebuilds the cache at most once a frame, however many changes were made; otherwise it's left alone
+const StaticGeometryCache &WallSegmentManager::getRenderCache()
+{
+   if(mRenderCacheDirty)
+   {
+      mRenderCache.clear();
+      mRenderCache.addLines(mWallEdgePoints);
+
+      S32 count = mWallSegmentDatabase->getObjectCount();
+
+      for(S32 i = 0; i < count; i++)
+      {
+         WallSegment *wallSegment = static_cast<WallSegment *>(mWallSegmentDatabase->getObjectByIndex(i));
+         if(!wallSegment->isSelected())
+            mRenderCache.addTriangles(*wallSegment->getTriangulatedFillPoints());
+      }
+
+      mRenderCacheDirty = false;
+   }
+
+   return mRenderCache;
+}
+
+
 
 void WallSegmentManager::setSelected(S32 owner, bool selected)
 {
@@ -327,6 +358,8 @@ void WallSegmentManager::setSelected(S32 owner, bool selected)
       if(wallSegment->getOwner() == owner)
          wallSegment->setSelected(selected);
    }
+
+   mRenderCacheDirty = true;
 }
 
 
@@ -367,6 +400,8 @@ void WallSegmentManager::deleteSegments(S32 owner)
 
    for(S32 i = 0; i < toBeDeleted.size(); i++)
       mWallSegmentDatabase->removeFromDatabase(toBeDeleted[i], true);
+
+   mRenderCacheDirty = true;
 }
 
 
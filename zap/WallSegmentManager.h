@@ -7,6 +7,7 @@
 #define _WALL_SEGMENT_MANAGER_H_
 
 #include "Point.h"
+#include "StaticGeometryCache.h"
 
 #include "tnlVector.h"
 #include "tnlNetObject.h"
@@ -30,6 +31,9 @@ private:
 
    static bool mBatchUpdatingGeom;     
 
+   StaticGeometryCache mRenderCache;   // Edges of all walls, fills of unselected ones
+   bool mRenderCacheDirty;             // Walls or selection have changed since mRenderCache was built
+
    void rebuildEdges();
    void buildWallSegmentEdgesAndPoints(GridDatabase *gameDatabase, DatabaseObject *object, const Vector<DatabaseObject *> &engrObjects);
 
@@ -42,6 +46,7 @@ public:
 
    const Vector<Point> *getWallEdgePoints() const;
    const Vector<Point> *getSelectedWallEdgePoints() const;
+   const StaticGeometryCache &getRenderCache();    // Rebuilt here if anything has changed since last time
 
    static void beginBatchGeomUpdate();                                     // Suspend certain geometry operations so they can be batched when 
    static void endBatchGeomUpdate(GridDatabase *db, bool modifiedWalls);   // this method is called
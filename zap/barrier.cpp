@@ -26,6 +26,7 @@ namespace Zap
 using namespace LuaArgs;
 
 Vector<Point> Barrier::mRenderLineSegments;
+StaticGeometryCache Barrier::mRenderEdgeCache;
 
 
 
@@ -242,6 +243,7 @@ void Barrier::getBufferForBotZone(F32 bufferRadius, Vector<Point> &points) const
 void Barrier::clearRenderItems()
 {
    mRenderLineSegments.clear();
+   mRenderEdgeCache.clear();
 }
 
 
@@ -256,6 +258,10 @@ void Barrier::prepareRenderingGeometry(Game *game)    // static
    game->getGameObjDatabase()->findObjects((TestFunc)isWallType, barrierList);
 
    clipRenderLinesToPoly(barrierList, mRenderLineSegments);
+
+   // Walls don't change during a level, so this is good until the next one
+   mRenderEdgeCache.clear();
+   mRenderEdgeCache.addLines(mRenderLineSegments);
 }
 
 
@@ -308,6 +314,13 @@ void Barrier::renderEdges(S32 layerIndex, const Color &outlineColor)  // static
 }
 
 
+void Barrier::renderEdges(S32 layerIndex, const Rect &visibleRect, const Color &outlineColor)  // static
+{
+   if(layerIndex == 1)
+      renderWallEdges(mRenderEdgeCache, visibleRect, outlineColor);
+}
+
+
 S32 Barrier::getRenderSortValue()
 {
    return 0;
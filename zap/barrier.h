@@ -9,6 +9,7 @@
 #include "BfObject.h"
 #include "polygon.h"       // For PolygonObject def
 #include "LineItem.h"   
+#include "StaticGeometryCache.h"
 
 #include "Point.h"
 #include "tnlVector.h"
@@ -46,10 +47,12 @@ public:
    static const S32 DEFAULT_BARRIER_WIDTH = 50;    // The default width of the barrier in game units
 
    static Vector<Point> mRenderLineSegments;       // The clipped line segments representing this barrier
+   static StaticGeometryCache mRenderEdgeCache;    // Same segments, split up by location for culling
    Vector<Point> mBotZoneBufferLineSegments;       // The line segments representing a buffered barrier
 
    void renderLayer(S32 layerIndex);                                           // Renders barrier fill barrier-by-barrier
    static void renderEdges(S32 layerIndex, const Color &outlineColor);    // Renders all edges in one pass
+   static void renderEdges(S32 layerIndex, const Rect &visibleRect, const Color &outlineColor);   // Only those in view
 
    // Returns a sorting key for the object.  Barriers should be drawn first so as to appear behind other objects.
    S32 getRenderSortValue();
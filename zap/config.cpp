@@ -114,10 +114,17 @@ IniSettings::IniSettings()
    levelDir = "";
 
    connectionSpeed = 0;
+   interpolationDelay = 0;            // Draw other ships as soon as their updates arrive
 
    defaultRobotScript = "s_bot.bot";            
    globalLevelScript = "";
 
+   luaJitEnabled = true;
+   luaJitOptions = "";                // Use LuaJIT's defaults
+   luaScriptMemoryLimitKB = 65536;    // 64MB should be plenty for any reasonable script
+   botTickBudget = 5000;              // 5ms, leaving plenty of the frame for everything else
+   minClientPacketPeriod = 0;         // Use the connection's usual rate
+
    wallFillColor.set(0,0,.15);
    wallOutlineColor.set(Colors::blue);
    clientPortNumber = 0;
@@ -473,6 +480,7 @@ static void loadGeneralSettings(CIniFile *ini, IniSettings *iniSettings)
    iniSettings->version = ini->GetValueI(section, "Version", iniSettings->version);
 
    iniSettings->connectionSpeed = ini->GetValueI(section, "ConnectionSpeed", iniSettings->connectionSpeed);
+   iniSettings->interpolationDelay = getMax(getMin(ini->GetValueI(section, "InterpolationDelay", iniSettings->interpolationDelay), 1000), 0);
 
    S32 fps = ini->GetValueI(section, "MaxFPS", iniSettings->maxFPS);
    if(fps >= 1) 
@@ -698,6 +706,12 @@ static void loadHostConfiguration(CIniFile *ini, IniSettings *iniSettings)
    iniSettings->globalLevelScript  = ini->GetValue(section, "GlobalLevelScript", iniSettings->globalLevelScript);
 
    iniSettings->enableGameRecording = ini->GetValueYN(section, "GameRecording", iniSettings->enableGameRecording);
+
+   iniSettings->luaJitEnabled          = ini->GetValueYN(section, "LuaJitEnabled", iniSettings->luaJitEnabled);
+   iniSettings->luaJitOptions          = ini->GetValue  (section, "LuaJitOptions", iniSettings->luaJitOptions);
+   iniSettings->luaScriptMemoryLimitKB = getMax(ini->GetValueI(section, "LuaScriptMemoryLimit", iniSettings->luaScriptMemoryLimitKB), 0);
+   iniSettings->botTickBudget          = getMax(ini->GetValueI(section, "BotTickBudget", iniSettings->botTickBudget), 0);
+   iniSettings->minClientPacketPeriod  = getMax(getMin(ini->GetValueI(section, "MinClientPacketPeriod", iniSettings->minClientPacketPeriod), 1000), 0);
 }
 
 
@@ -1468,6 +1482,10 @@ void writeServerBanList(CIniFile *ini, BanList *banList)
       ini->sectionComment("ServerBanList", " ");
       ini->sectionComment("ServerBanList", " Note: Wildcards (" + wildcard +") may be used for IP address and nickname" );
       ini->sectionComment("ServerBanList", " ");
+      ini->sectionComment("ServerBanList", " Note: Address ranges may be given with trailing wildcards or in CIDR form:");
+      ini->sectionComment("ServerBanList", "   BanItem3=123.123." + wildcard + "." + wildcard + delim + wildcard + delim + "20110131T123000" + delim + "30");
+      ini->sectionComment("ServerBanList", "   BanItem4=123.123.0.0/16" + delim + wildcard + delim + "20110131T123000" + delim + "30");
+      ini->sectionComment("ServerBanList", " ");
       ini->sectionComment("ServerBanList", " Note: ISO time format is in the following format: YYYYMMDDTHH24MISS");
       ini->sectionComment("ServerBanList", "   YYYY = four digit year, (e.g. 2011)");
       ini->sectionComment("ServerBanList", "     MM = month (01 - 12), (e.g. 01)");
@@ -1673,6 +1691,7 @@ static void writeSettings(CIniFile *ini, IniSettings *iniSettings)
       ini->sectionComment(section, " LastName - Name user entered when game last run (may be overwritten if you enter a different name on startup screen)");
       ini->sectionComment(section, " LastPassword - Password user entered when game last run (may be overwritten if you enter a different pw on startup screen)");
       ini->sectionComment(section, " LastEditorName - Last edited file name");
+      ini->sectionComment(section, " InterpolationDelay - Milliseconds to draw other ships behind the server's updates, smoothing over slow or lost packets; 0 to turn off, up to 1000 (try 100)");
       ini->sectionComment(section, " MaxFPS - Maximum FPS the client will run at.  Higher values use more CPU, lower may increase lag (default = 100)");
       ini->sectionComment(section, " LineWidth - Width of a \"standard line\" in pixels (default 2); can set with /linewidth in game");
       ini->sectionComment(section, " Version - Version of game last time it was run.  Don't monkey with this value; nothing good can come of it!");
@@ -1707,6 +1726,7 @@ static void writeSettings(CIniFile *ini, IniSettings *iniSettings)
    ini->SetValueI (section, "MaxFPS", iniSettings->maxFPS);  
 
    ini->SetValueI (section, "ConnectionSpeed", iniSettings->connectionSpeed);  
+   ini->SetValueI (section, "InterpolationDelay", iniSettings->interpolationDelay);
    ini->SetValueI (section, "Version", BUILD_VERSION);
 
    ini->SetValueI (section, "QueryServerSortColumn",    iniSettings->queryServerSortColumn);
@@ -1800,6 +1820,14 @@ static void writeHost(CIniFile *ini, IniSettings *iniSettings)
       addComment(" VoteLength - number of seconds the voting will last, zero will disable voting.");
       addComment(" VoteRetryLength - When vote fail, the vote caller is unable to vote until after this number of seconds.");
       addComment(" Vote Strengths - Vote will pass when sum of all vote strengths is bigger then zero.");
+      addComment(" LuaJitEnabled - Compile frequently run script code to machine code.  Disable only if you suspect the JIT of misbehaving.");
+      addComment(" LuaJitOptions - Tuning options for the JIT compiler, as accepted by jit.opt.start(), e.g. hotloop=56 maxtrace=2000");
+      addComment("                 (leave blank to use the defaults)");
+      addComment(" LuaScriptMemoryLimit - Memory, in KB, that a single robot or levelgen can use before it is terminated; 0 for no limit (default = 65536)");
+      addComment(" BotTickBudget - Microseconds all robots together may spend thinking each tick.  Bots that don't get a turn go first");
+      addComment("                 on the next tick; 0 for no limit (default = 5000)");
+      addComment(" MinClientPacketPeriod - Fewest milliseconds between packets sent to each player.  Raise to save bandwidth; players can set");
+      addComment("                         InterpolationDelay to keep other ships moving smoothly.  0 for the usual rate, up to 1000 (default = 0)");
       addComment("----------------");
    }
 
@@ -1844,6 +1872,12 @@ static void writeHost(CIniFile *ini, IniSettings *iniSettings)
    ini->SetValue  (section, "GlobalLevelScript", iniSettings->globalLevelScript);
 
    ini->setValueYN(section, "GameRecording", iniSettings->enableGameRecording);
+
+   ini->setValueYN(section, "LuaJitEnabled", iniSettings->luaJitEnabled);
+   ini->SetValue  (section, "LuaJitOptions", iniSettings->luaJitOptions);
+   ini->SetValueI (section, "LuaScriptMemoryLimit", iniSettings->luaScriptMemoryLimitKB);
+   ini->SetValueI (section, "BotTickBudget", iniSettings->botTickBudget);
+   ini->SetValueI (section, "MinClientPacketPeriod", iniSettings->minClientPacketPeriod);
 #ifdef BF_WRITE_TO_MYSQL
    if(iniSettings->mySqlStatsDatabaseServer == "" && iniSettings->mySqlStatsDatabaseName == "" && iniSettings->mySqlStatsDatabaseUser == "" && iniSettings->mySqlStatsDatabasePassword == "")
       ini->SetValue  (section, "MySqlStatsDatabaseCredentials", "server, dbname, login, password");
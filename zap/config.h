@@ -227,6 +227,7 @@ public:
    bool enableGameRecording;
 
    S32 connectionSpeed;
+   U32 interpolationDelay;          // Ms to draw other ships behind the server's updates; 0 to draw them as they arrive
 
    bool randomLevels;
    bool skipUploads;
@@ -296,6 +297,12 @@ public:
    string defaultRobotScript;
    string globalLevelScript;
 
+   bool luaJitEnabled;
+   string luaJitOptions;            // Passed to jit.opt.start(), e.g. "hotloop=56 maxtrace=2000"
+   S32 luaScriptMemoryLimitKB;      // Max Lua heap any one robot or levelgen may hold on to; 0 for no limit
+   S32 botTickBudget;               // Microseconds all bots together may spend in onTick per tick; 0 for no limit
+   U32 minClientPacketPeriod;       // Fewest ms between packets we send each client; 0 for the connection's usual rate
+
    Vector<StringTableEntry> levelList;
 
    Vector<string> reservedNames;
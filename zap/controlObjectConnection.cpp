@@ -9,6 +9,8 @@
 
 #include "ship.h"
 
+#include "tnlPlatform.h"
+
 #include <math.h>
 
 namespace Zap
@@ -32,6 +34,12 @@ ControlObjectConnection::ControlObjectConnection()
    mIsBusy = false;
    mBusyTime = 0;
    mNeedReplayMoves = false;
+   mReplayMaySkip = false;
+
+   mReplayCount = 0;
+   mReplayedMoveCount = 0;
+   mSkippedReplayCount = 0;
+   mReplayTime = 0;
 }
 
 
@@ -257,7 +265,14 @@ void ControlObjectConnection::readPacket(BitStream *bstream)
                   controlObject.getPointer() == prevControlObject &&
                   controlObject->getObjectTypeNumber() == PlayerShipTypeNumber &&
                   pendingMoves.size() != 0)
-                     prepareReplay();
+               {
+                  bool replayPending = mNeedReplayMoves;
+
+                  static_cast<Ship *>(controlObject.getPointer())->getState(&mPredictedState);
+                  prepareReplay();
+
+                  mReplayMaySkip = !replayPending;    // If nothing else has asked for a replay, we might not need one
+               }
                controlObject->readControlState(bstream);
             }
             mServerPosition = controlObject->getPos();
@@ -271,30 +286,126 @@ void ControlObjectConnection::readPacket(BitStream *bstream)
 
 
    if(mNeedReplayMoves && controlObject.isValid())
+      replayPendingMoves();
+}
+
+
+// Anything that changes the ship's state out from under our prediction calls this first, so that replayPendingMoves()
+// can run our pending moves again from the corrected state
+void ControlObjectConnection::prepareReplay()
+{
+   mReplayMaySkip = false;    // Something other than the server's control state is being changed
+
+   if(!mNeedReplayMoves)
+   {
+      mNeedReplayMoves = true;
+      if(controlObject.isValid() && pendingMoves.size() != 0)
+         ((Ship*)controlObject.getPointer())->setState(&pendingMoves[0]);
+   }
+}
+
+
+// The server's state is for the point just before our first pending move.  If it matches what we predicted for that
+// point, replaying our moves from it would only get us back to where we already are.
+//
+// Skipping restores our whole predicted state, so every field of it has to match, not just the ones the server sends
+// us today.  Those it doesn't send still hold our prediction, and so always do.
+bool ControlObjectConnection::serverConfirmedPrediction()
+{
+   // Both sides round positions and velocities to the same grid after each move, so they match exactly when the
+   // prediction was right; the tolerance just keeps us from replaying over differences nobody could see.  Energy and
+   // timers are whole numbers, and must match exactly.
+   static const F32 Tolerance = 0.05f;
+
+   if(!mReplayMaySkip || pendingMoves.size() == 0 || controlObject->getObjectTypeNumber() != PlayerShipTypeNumber)
+      return false;
+
+   ControlObjectData serverState;
+   static_cast<Ship *>(controlObject.getPointer())->getState(&serverState);
+
+   const ControlObjectData &predicted = pendingMoves[0];
+
+   return (serverState.mPos - predicted.mPos).lenSquared() <= Tolerance * Tolerance &&
+          (serverState.mVel - predicted.mVel).lenSquared() <= Tolerance * Tolerance &&
+          (serverState.mImpulseVector - predicted.mImpulseVector).lenSquared() <= Tolerance * Tolerance &&
+          serverState.mEnergy               == predicted.mEnergy               &&
+          serverState.mFireTimer            == predicted.mFireTimer            &&
+          serverState.mFastRechargeTimer    == predicted.mFastRechargeTimer    &&
+          serverState.mSpyBugPlacementTimer == predicted.mSpyBugPlacementTimer &&
+          serverState.mPulseTimer           == predicted.mPulseTimer           &&
+          serverState.mCooldownNeeded       == predicted.mCooldownNeeded       &&
+          serverState.mFastRecharging       == predicted.mFastRecharging       &&
+          serverState.mBoostActive          == predicted.mBoostActive;
+}
+
+
+void ControlObjectConnection::replayPendingMoves()
+{
+   S64 startTime = Platform::getHighPrecisionTimerValue();
+
+   if(serverConfirmedPrediction())
    {
+      static_cast<Ship *>(controlObject.getPointer())->setState(&mPredictedState);
+      mSkippedReplayCount++;
+   }
+   else
+   {
+      Ship *ship = NULL;
+      if(controlObject->getObjectTypeNumber() == PlayerShipTypeNumber)
+         ship = static_cast<Ship *>(controlObject.getPointer());
+
       for(S32 i = 0; i < pendingMoves.size(); i++)
       {
-         if(controlObject.isValid() && controlObject->getObjectTypeNumber() == PlayerShipTypeNumber)
-            ((Ship*)controlObject.getPointer())->getState(&pendingMoves[i]);
+         if(ship)
+            ship->getState(&pendingMoves[i]);
          Move theMove = pendingMoves[i];
          theMove.prepare();
          controlObject->setCurrentMove(theMove);
          controlObject->idle(BfObject::ClientReplayingPendingMoves);
       }
-      controlObject->controlMoveReplayComplete();
-      mNeedReplayMoves = false;
+
+      mReplayCount++;
+      mReplayedMoveCount += pendingMoves.size();
    }
+
+   controlObject->controlMoveReplayComplete();
+   mNeedReplayMoves = false;
+   mReplayMaySkip = false;
+
+   mReplayTime += Platform::getHighPrecisionTimerValue() - startTime;
 }
-void ControlObjectConnection::prepareReplay()
+
+
+U32 ControlObjectConnection::getReplayCount() const
 {
-   if(!mNeedReplayMoves)
-   {
-      mNeedReplayMoves = true;
-      if(controlObject.isValid() && pendingMoves.size() != 0)
-         ((Ship*)controlObject.getPointer())->setState(&pendingMoves[0]);
-   }
+   return mReplayCount;
 }
 
+
+U32 ControlObjectConnection::getReplayedMoveCount() const
+{
+   return mReplayedMoveCount;
+}
+
+
+U32 ControlObjectConnection::getSkippedReplayCount() const
+{
+   return mSkippedReplayCount;
+}
+
+
+F64 ControlObjectConnection::getReplayMilliseconds() const
+{
+   return Platform::getHighPrecisionMilliseconds(mReplayTime);
+}
+
+
+S32 ControlObjectConnection::getPendingMoveCount() const
+{
+   return pendingMoves.size();
+}
+
+
 // A new move has arrived
 void ControlObjectConnection::onGotNewMove(const Move &move)
 {
@@ -65,7 +65,18 @@ private:
 
    U32 mBusyTime;          // How long have we been busy (see mIsBusy)
 
+   // Client-side prediction
+   ControlObjectData mPredictedState;     // Where we had our ship before the server corrected it
+   bool mReplayMaySkip;                   // Only the server's control state has changed since mPredictedState
+
+   U32 mReplayCount;             // Times we've replayed our pending moves
+   U32 mReplayedMoveCount;       // Moves run through in those replays
+   U32 mSkippedReplayCount;      // Times the server agreed with our prediction, so we didn't have to
+   S64 mReplayTime;              // Time spent replaying, in high precision timer ticks
+
    void onGotNewMove(const Move &move);
+   bool serverConfirmedPrediction();
+   void replayPendingMoves();
 
 protected:
    bool mIsBusy;
@@ -95,6 +106,12 @@ public:
 
 	void prepareReplay();
 
+   U32 getReplayCount() const;
+   U32 getReplayedMoveCount() const;
+   U32 getSkippedReplayCount() const;
+   F64 getReplayMilliseconds() const;
+   S32 getPendingMoveCount() const;
+
    void packetReceived(PacketNotify *notify);
    void addToTimeCredit(U32 timeAmount);
 
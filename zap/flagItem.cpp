@@ -19,6 +19,7 @@ namespace Zap
 using namespace LuaArgs;
 
 TNL_IMPLEMENT_NETOBJECT(FlagItem);
+BF_IMPLEMENT_POOLED_ALLOC(FlagItem);
 /**
  * @luafunc FlagItem::FlagItem()
  * @luafunc FlagItem::FlagItem(point)
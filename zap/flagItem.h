@@ -83,6 +83,7 @@ public:
 
 
    TNL_DECLARE_CLASS(FlagItem);
+   BF_DECLARE_POOLED_ALLOC;
 
    ///// Editor stuff
 
@@ -2083,7 +2083,7 @@ bool GameConnection::readConnectRequest(BitStream *stream, NetConnection::Termin
    {
       // Now that we have the name, check if the client is banned,
       // can't use isAuthenticated() until after waiting for m2sSetAuthenticated, using needToCheckAuthentication instead.
-      if(mServerGame->getSettings()->getBanList()->isBanned(getNetAddress().toString(), string(name), needToCheckAuthentication))
+      if(mServerGame->getSettings()->getBanList()->isBanned(getNetAddress(), string(name), needToCheckAuthentication))
       {
          reason = ReasonBanned;
          return false;
@@ -2251,7 +2251,8 @@ string GameConnection::getServerName()
 }
 
 
-void GameConnection::setConnectionSpeed(S32 speed)
+// A minSendPeriod longer than the speed calls for stretches out the time between our packets, trading smoothness for bandwidth
+void GameConnection::setConnectionSpeed(S32 speed, U32 minSendPeriod)
 {
    U32 minPacketSendPeriod;
    U32 minPacketRecvPeriod;
@@ -2293,6 +2294,9 @@ void GameConnection::setConnectionSpeed(S32 speed)
       maxRecvBandwidth = 65535;
    }
 
+   if(minSendPeriod > minPacketSendPeriod)
+      minPacketSendPeriod = minSendPeriod;
+
    //if(this->isLocalConnection())    // Local connections don't use network, maximum bandwidth
    //{
    //   minPacketSendPeriod = 15;
@@ -2360,7 +2364,8 @@ void GameConnection::onConnectionEstablished_client()
 
 void GameConnection::onConnectionEstablished_server()
 {
-   setConnectionSpeed(2);                 // High speed, most servers have sufficient bandwidth
+   // High speed, most servers have sufficient bandwidth, unless the host has asked us to go easy on it
+   setConnectionSpeed(2, mServerGame->getSettings()->getIniSettings()->minClientPacketPeriod);
    mServerGame->addClient(mClientInfo);   // This clientInfo was created by the server... it has no badge data yet
    setGhostFrom(true);
    setGhostTo(false);
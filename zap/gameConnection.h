@@ -333,7 +333,7 @@ public:
    void writeConnectAccept(BitStream *stream);
    bool readConnectAccept(BitStream *stream, NetConnection::TerminationReason &reason);
 
-   void setConnectionSpeed(S32 speed);
+   void setConnectionSpeed(S32 speed, U32 minSendPeriod = 0);
 
    void onConnectionEstablished();
    void onConnectionEstablished_client();
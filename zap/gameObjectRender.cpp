@@ -19,6 +19,7 @@
 #include "game.h"
 #include "VertexStylesEnum.h"
 #include "FontManager.h"
+#include "StaticGeometryCache.h"
 
 #include "Colors.h"
 
@@ -46,6 +47,80 @@ extern F32 gLineWidth1;
 extern F32 gLineWidth3;
 
 
+// Small, simple items draw through a RenderCommandBuffer.  In the game view there's an active one, collecting
+// primitives from all the objects so they can be drawn in a few big batches; anywhere else (the editor, the
+// instructions) we use our own, and draw as soon as the item is done.
+class ItemRenderBuffer
+{
+private:
+   RenderCommandBuffer *mBuffer;
+
+   static RenderCommandBuffer &getImmediateBuffer()
+   {
+      static RenderCommandBuffer buffer;
+      return buffer;
+   }
+
+public:
+   // Constructor
+   ItemRenderBuffer()
+   {
+      mBuffer = RenderCommandBuffer::getActive();
+
+      if(!mBuffer)
+         mBuffer = &getImmediateBuffer();
+   }
+
+   // Destructor
+   ~ItemRenderBuffer()
+   {
+      if(mBuffer == RenderCommandBuffer::getActive())
+         return;
+
+      GLRenderBackend backend;
+      mBuffer->flush(backend);
+
+      // Leave the last color we set current, as it would have been if we'd drawn directly
+      const F32 *color = mBuffer->getColor();
+      glColor4f(color[0], color[1], color[2], color[3]);
+   }
+
+   RenderCommandBuffer *operator->() { return mBuffer; }
+};
+
+
+// Same circle as drawCircle() draws
+static void bufferCircle(ItemRenderBuffer &buffer, const Point &pos, F32 radius)
+{
+   F32 vertexArray[2 * NUM_CIRCLE_SIDES];
+
+   for(S32 i = 0; i < NUM_CIRCLE_SIDES; i++)
+   {
+      F32 theta = i * CIRCLE_SIDE_THETA;
+      vertexArray[(2*i)]     = pos.x + cosf(theta) * radius;
+      vertexArray[(2*i) + 1] = pos.y + sinf(theta) * radius;
+   }
+
+   buffer->addVertices(vertexArray, NUM_CIRCLE_SIDES, GL_LINE_LOOP);
+}
+
+
+// Same circle as drawFilledCircle() draws
+static void bufferFilledCircle(ItemRenderBuffer &buffer, const Point &pos, F32 radius)
+{
+   F32 vertexArray[2 * NUM_CIRCLE_SIDES];
+
+   for(S32 i = 0; i < NUM_CIRCLE_SIDES; i++)
+   {
+      F32 theta = i * CIRCLE_SIDE_THETA;
+      vertexArray[(2*i)]     = pos.x + cosf(theta) * radius;
+      vertexArray[(2*i) + 1] = pos.y + sinf(theta) * radius;
+   }
+
+   buffer->addVertices(vertexArray, NUM_CIRCLE_SIDES, GL_TRIANGLE_FAN);
+}
+
+
 void drawHorizLine(S32 x1, S32 x2, S32 y)
 {
    drawHorizLine((F32)x1, (F32)x2, (F32)y);
@@ -1893,26 +1968,28 @@ void renderProjectile(const Point &pos, U32 type, U32 time)
 
    if(bultype == 1)    // Default stars
    { 
-      glColor(pi->projColors[0]);
-      glPushMatrix();
-         glTranslate(pos);
-         glScale(pi->scaleFactor);
+      ItemRenderBuffer buffer;
 
-         glPushMatrix();
-            glRotatef((time % 720) * 0.5f, 0, 0, 1);
+      buffer->setColor(pi->projColors[0]);
+      buffer->pushTransform();
+         buffer->translate(pos);
+         buffer->scale(pi->scaleFactor, pi->scaleFactor);
+
+         buffer->pushTransform();
+            buffer->rotate(degreesToRadians((time % 720) * 0.5f));
 
             static S16 projectilePoints1[] = { -2,2,  0,6,  2,2,  6,0,  2,-2,  0,-6,  -2,-2,  -6,0 };
-            renderVertexArray(projectilePoints1, ARRAYSIZE(projectilePoints1) / 2, GL_LINE_LOOP);
+            buffer->addVertices(projectilePoints1, ARRAYSIZE(projectilePoints1) / 2, GL_LINE_LOOP);
 
-         glPopMatrix();
+         buffer->popTransform();
 
-         glRotatef(180 - F32(time % 360), 0, 0, 1);
-         glColor(pi->projColors[1]);
+         buffer->rotate(degreesToRadians(180 - F32(time % 360)));
+         buffer->setColor(pi->projColors[1]);
 
          static S16 projectilePoints2[] = { -2,2,  0,8,  2,2,  8,0,  2,-2,  0,-8, -2,-2,  -8,0 };
-         renderVertexArray(projectilePoints2, ARRAYSIZE(projectilePoints2) / 2, GL_LINE_LOOP);
+         buffer->addVertices(projectilePoints2, ARRAYSIZE(projectilePoints2) / 2, GL_LINE_LOOP);
 
-      glPopMatrix();
+      buffer->popTransform();
 
    } else if (bultype == 2) { // Tiny squares rotating quickly, good machine gun
 
@@ -1965,36 +2042,38 @@ void renderProjectile(const Point &pos, U32 type, U32 time)
 
 void renderSeeker(const Point &pos, F32 angleRadians, F32 speed, U32 timeRemaining)
 {
-   glPushMatrix();
-      glTranslate(pos);
-      glRotatef(angleRadians * 360.f / FloatTau, 0, 0, 1.0);
+   ItemRenderBuffer buffer;
+
+   buffer->pushTransform();
+      buffer->translate(pos);
+      buffer->rotate(angleRadians);
 
       // The flames first!
       F32 speedRatio = speed / WeaponInfo::getWeaponInfo(WeaponSeeker).projVelocity + (S32(timeRemaining) % 200)/ 400.0f;  
-      glColor(Colors::yellow, 0.5f);
+      buffer->setColor(Colors::yellow, 0.5f);
       F32 innerFlame[] = {
             -8, -1,
             -8 - (4 * speedRatio), 0,
             -8, 1,
       };
-      renderVertexArray(innerFlame, 3, GL_LINE_STRIP);
-      glColor(Colors::orange50, 0.6f);
+      buffer->addVertices(innerFlame, 3, GL_LINE_STRIP);
+      buffer->setColor(Colors::orange50, 0.6f);
       F32 outerFlame[] = {
             -8, -3,
             -8 - (8 * speedRatio), 0,
             -8, 3,
       };
-      renderVertexArray(outerFlame, 3, GL_LINE_STRIP);
+      buffer->addVertices(outerFlame, 3, GL_LINE_STRIP);
 
       // The body of the seeker
-      glColor4f(1, 0, 0.35f, 1);  // A redder magenta
+      buffer->setColor(1, 0, 0.35f, 1);  // A redder magenta
       F32 vertices[] = {
             -8, -4,
             -8,  4,
              8,  0
       };
-      renderVertexArray(vertices, 3, GL_LINE_LOOP);
-   glPopMatrix();
+      buffer->addVertices(vertices, 3, GL_LINE_LOOP);
+   buffer->popTransform();
 }
 
 
@@ -2004,29 +2083,31 @@ void renderMine(const Point &pos, bool armed, bool visible)
    F32 mod;
    F32 vis;   
 
+   ItemRenderBuffer buffer;
+
    if(visible)    // Friendly mine
    {
-      glColor(Colors::gray50);
-      drawCircle(pos, Mine::SensorRadius);
+      buffer->setColor(Colors::gray50);
+      bufferCircle(buffer, pos, Mine::SensorRadius);
       mod = 0.8f;
       vis = 1.0f;
    }
    else           // Invisible enemy mine
    {
-      glLineWidth(gLineWidth1);
+      buffer->setLineWidth(gLineWidth1);
       mod = 0.80f;
       vis = 0.18f;
    }
 
-   glColor4f(mod, mod, mod, vis);
-   drawCircle(pos, 10);
+   buffer->setColor(mod, mod, mod, vis);
+   bufferCircle(buffer, pos, 10);
 
    if(armed)
    {
-      glColor4f(mod, 0, 0, vis);
-      drawCircle(pos, 6);
+      buffer->setColor(mod, 0, 0, vis);
+      bufferCircle(buffer, pos, 6);
    }
-   glLineWidth(gDefaultLineWidth);
+   buffer->setLineWidth(0);
 }
 
 #ifndef min
@@ -2038,8 +2119,10 @@ void renderMine(const Point &pos, bool armed, bool visible)
 // lifeLeft is a number between 0 and 1.  Burst explodes when lifeLeft == 0.
 void renderGrenade(const Point &pos, F32 lifeLeft)
 {
-   glColor(Colors::white);
-   drawCircle(pos, 10);
+   ItemRenderBuffer buffer;
+
+   buffer->setColor(Colors::white);
+   bufferCircle(buffer, pos, 10);
 
    bool innerVis = true;
 
@@ -2063,12 +2146,12 @@ void renderGrenade(const Point &pos, F32 lifeLeft)
    else if(lifeLeft > .05)
       innerVis = false;
 
-   glColor(1, min(1.25f - lifeLeft, 1), 0);
+   buffer->setColor(1, min(1.25f - lifeLeft, 1), 0);
 
    if(innerVis)
-      drawFilledCircle(pos, 6);
+      bufferFilledCircle(buffer, pos, 6);
    else
-      drawCircle(pos, 6);
+      bufferCircle(buffer, pos, 6);
 }
 
 void renderFilledPolygon(const Point &pos, S32 points, S32 radius, const Color &fillColor, const Color &outlineColor)
@@ -2251,6 +2334,33 @@ void renderWallEdges(const Vector<Point> &edges, const Point &offset, const Colo
 }
 
 
+// Only draws cells that overlap visibleRect; one draw call for each
+void renderWallEdges(const StaticGeometryCache &cache, const Rect &visibleRect, const Color &outlineColor, F32 alpha)
+{
+   static Vector<const StaticGeometryCache::Cell *> cells;
+   cache.findVisibleCells(visibleRect, cells);
+
+   glColor(outlineColor, alpha);
+
+   for(S32 i = 0; i < cells.size(); i++)
+      if(cells[i]->lines.size() > 0)
+         renderPointVector(&cells[i]->lines, GL_LINES);
+}
+
+
+void renderWallFill(const StaticGeometryCache &cache, const Rect &visibleRect, const Color &fillColor)
+{
+   static Vector<const StaticGeometryCache::Cell *> cells;
+   cache.findVisibleCells(visibleRect, cells);
+
+   glColor(fillColor);
+
+   for(S32 i = 0; i < cells.size(); i++)
+      if(cells[i]->triangles.size() > 0)
+         renderPointVector(&cells[i]->triangles, GL_TRIANGLES);
+}
+
+
 void renderSpeedZone(const Vector<Point> &points, U32 time)
 {
    glColor(Colors::red);
@@ -2279,27 +2389,26 @@ void renderTestItem(const Point &pos, S32 size, F32 alpha)
 
 void renderTestItem(const Vector<Point> &points, F32 alpha)
 {
-   glColor(Colors::yellow, alpha);
-   renderVertexArray((F32 *)&points[0], points.size(), GL_LINE_LOOP);
+   ItemRenderBuffer buffer;
+
+   buffer->setColor(Colors::yellow, alpha);
+   buffer->addPoints(points, GL_LINE_LOOP);
 }
 
 
 void renderAsteroid(const Point &pos, S32 design, F32 scaleFact, const Color *color, F32 alpha)
 {
-   glPushMatrix();
-   glTranslate(pos);
+   ItemRenderBuffer buffer;
 
-   glColor(color ? *color : Color(.7), alpha);
+   buffer->setColor(color ? *color : Color(.7), alpha);
 
    F32 vertexArray[2 * ASTEROID_POINTS];
    for(S32 i = 0; i < ASTEROID_POINTS; i++)
    {
-      vertexArray[2*i]     = AsteroidCoords[design][i][0] * scaleFact;
-      vertexArray[(2*i)+1] = AsteroidCoords[design][i][1] * scaleFact;
+      vertexArray[2*i]     = pos.x + AsteroidCoords[design][i][0] * scaleFact;
+      vertexArray[(2*i)+1] = pos.y + AsteroidCoords[design][i][1] * scaleFact;
    }
-   renderVertexArray(vertexArray, ASTEROID_POINTS, GL_LINE_LOOP);
-
-   glPopMatrix();
+   buffer->addVertices(vertexArray, ASTEROID_POINTS, GL_LINE_LOOP);
 }
 
 
@@ -2375,15 +2484,19 @@ void renderAsteroidSpawnEditor(const Point &pos, F32 scale)
 
 void renderResourceItem(const Vector<Point> &points, F32 alpha)
 {
-   glColor(Colors::white, alpha);
-   renderVertexArray((F32 *)&points[0], points.size(), GL_LINE_LOOP);
+   ItemRenderBuffer buffer;
+
+   buffer->setColor(Colors::white, alpha);
+   buffer->addPoints(points, GL_LINE_LOOP);
 }
 
 
 void renderSoccerBall(const Point &pos, F32 size)
 {
-   glColor(Colors::white);
-   drawCircle(pos, size);
+   ItemRenderBuffer buffer;
+
+   buffer->setColor(Colors::white);
+   bufferCircle(buffer, pos, size);
 }
 
 
@@ -3473,7 +3586,7 @@ void renderStars(const Point *stars, const Color *colors, S32 numStars, F32 alph
 }
 
 
-void renderWalls(const GridDatabase *wallSegmentDatabase, const Vector<Point> &wallEdgePoints, 
+void renderWalls(const GridDatabase *wallSegmentDatabase, const StaticGeometryCache &renderCache, const Rect &visibleRect,
                  const Vector<Point> &selectedWallEdgePoints, const Color &outlineColor, 
                  const Color &fillColor, F32 currentScale, bool dragMode, bool drawSelected,
                  const Point &selectedItemOffset, bool previewMode, bool showSnapVertices, F32 alpha)
@@ -3501,14 +3614,18 @@ void renderWalls(const GridDatabase *wallSegmentDatabase, const Vector<Point> &w
       else
          color = fillColor * alpha;
 
-      for(S32 i = 0; i < count; i++)
-      {
-         WallSegment *wallSegment = static_cast<WallSegment *>(wallSegmentDatabase->getObjectByIndex(i));
-         if(!moved || !wallSegment->isSelected())         
-            wallSegment->renderFill(selectedItemOffset, color);      // RenderFill ignores offset for unselected walls
-      }
+      // Unselected walls' fills are cached; only draw the ones we can see
+      renderWallFill(renderCache, visibleRect, color);
+
+      if(!moved)
+         for(S32 i = 0; i < count; i++)
+         {
+            WallSegment *wallSegment = static_cast<WallSegment *>(wallSegmentDatabase->getObjectByIndex(i));
+            if(wallSegment->isSelected())         
+               wallSegment->renderFill(selectedItemOffset, color);
+         }
 
-      renderWallEdges(wallEdgePoints, outlineColor);                 // Render wall outlines with unselected walls
+      renderWallEdges(renderCache, visibleRect, outlineColor);       // Render wall outlines with unselected walls
    }
    else  // Render selected/moving walls last so they appear on top; this is pass 2, 
    {
@@ -3528,8 +3645,12 @@ void renderWalls(const GridDatabase *wallSegmentDatabase, const Vector<Point> &w
       glLineWidth(gLineWidth1);
 
       //glColor(Colors::magenta);
-      for(S32 i = 0; i < wallEdgePoints.size(); i++)
-         renderSmallSolidVertex(currentScale, wallEdgePoints[i], dragMode);
+      static Vector<const StaticGeometryCache::Cell *> cells;
+      renderCache.findVisibleCells(visibleRect, cells);
+
+      for(S32 i = 0; i < cells.size(); i++)
+         for(S32 j = 0; j < cells[i]->lines.size(); j++)
+            renderSmallSolidVertex(currentScale, cells[i]->lines[j], dragMode);
 
       glLineWidth(gDefaultLineWidth);
    }
@@ -31,6 +31,7 @@ static const S32 NO_NUMBER = -1;
 
 class Ship;
 class WallItem;
+class StaticGeometryCache;
 
 
 //////////
@@ -221,6 +222,8 @@ extern void renderEnergySymbol(const Point &pos, F32 scaleFactor);  // Another s
 // Wall rendering
 void renderWallEdges(const Vector<Point> &edges, const Color &outlineColor, F32 alpha = 1.0);
 void renderWallEdges(const Vector<Point> &edges, const Point &offset, const Color &outlineColor, F32 alpha = 1.0);
+void renderWallEdges(const StaticGeometryCache &cache, const Rect &visibleRect, const Color &outlineColor, F32 alpha = 1.0);
+void renderWallFill(const StaticGeometryCache &cache, const Rect &visibleRect, const Color &fillColor);
 
 //extern void renderSpeedZone(Point pos, Point normal, U32 time);
 void renderSpeedZone(const Vector<Point> &pts, U32 time);
@@ -263,7 +266,7 @@ extern void renderStaticBitfighterLogo();
 
 extern void renderBadge(F32 x, F32 y, F32 rad, MeritBadges badge);
 
-extern void renderWalls(const GridDatabase *wallSegmentDatabase, const Vector<Point> &wallEdgePoints, 
+extern void renderWalls(const GridDatabase *wallSegmentDatabase, const StaticGeometryCache &renderCache, const Rect &visibleRect,
                         const Vector<Point> &selectedWallEdgePoints, const Color &outlineColor, 
                         const Color &fillColor, F32 currentScale, bool dragMode, bool drawSelected,
                         const Point &selectedItemOffset, bool previewMode, bool showSnapVertices, F32 alpha);
@@ -1367,6 +1367,7 @@ void GameType::performScopeQuery(GhostConnection *connection)
 
    const Vector<DatabaseObject *> *spyBugs = mGame->getGameObjDatabase()->findObjects_fast(SpyBugTypeNumber);
    const Point scopeRange(SpyBug::SPY_BUG_RADIUS, SpyBug::SPY_BUG_RADIUS * FloatSqrt3Half);  // Bounding box of hexagon
+   const HotStateTable *hotStates = mGame->getGameObjDatabase()->getHotStateTable();
 
    for(S32 i = spyBugs->size()-1; i >= 0; i--)
    {
@@ -1385,11 +1386,23 @@ void GameType::performScopeQuery(GhostConnection *connection)
 
          for(S32 j = 0; j < fillVector.size(); j++)
          {
-            // Some objects don't have geometry (ForceFields).  Is this a bug?
-            if(!fillVector[j]->hasGeometry())
-               continue;
+            // Moving things are most of what we'll find, and the hot state table knows where they are.  Mounted items
+            // are where their mounts are, though, so we have to ask them.
+            S32 slot = fillVector[j]->getHotSlot();
+            Point objPos;
+
+            if(slot != -1 && !hotStates->hasFlag(slot, HotStateTable::MountedFlag))
+               objPos = hotStates->getPos(slot);
+            else
+            {
+               // Some objects don't have geometry (ForceFields).  Is this a bug?
+               if(!fillVector[j]->hasGeometry())
+                  continue;
+
+               objPos = fillVector[j]->getPos();
+            }
 
-            if(!pointInHexagon(fillVector[j]->getPos(), pos, SpyBug::SPY_BUG_RADIUS))
+            if(!pointInHexagon(objPos, pos, SpyBug::SPY_BUG_RADIUS))
                continue;
 
             connection->objectInScope(static_cast<BfObject *>(fillVector[j]));
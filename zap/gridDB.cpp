@@ -6,6 +6,7 @@
 #include "gridDB.h"
 #include "moveObject.h"    // For def of ActualState
 #include "WallSegmentManager.h"
+#include "WallEdgeGrid.h"
 #include "GeomUtils.h"
 
 #include "tnlLog.h"
@@ -40,6 +41,9 @@ GridDatabase::GridDatabase(bool createWallSegmentManager)
    else
       mWallSegmentManager = NULL;
 
+   mWallEdgeGrid = NULL;
+   mWallEdgeGridDirty = true;
+
    mDatabaseId = getNextId();
 }
 
@@ -64,6 +68,8 @@ GridDatabase::~GridDatabase()
    if(mWallSegmentManager)
       delete mWallSegmentManager;
 
+   delete mWallEdgeGrid;
+
    mCountGridDatabase--;
 
    if(mCountGridDatabase == 0)
@@ -148,6 +154,12 @@ void GridDatabase::addToDatabase(DatabaseObject *theObject)
    // Add the object to our non-spatial "database" as well
    mAllObjects.push_back(theObject);
 
+   if(theObject->hasHotState())
+   {
+      theObject->mHotSlot = mHotStates.acquireSlot(theObject);
+      theObject->refreshHotState();
+   }
+
    U8 type = theObject->getObjectTypeNumber();
    if(type == GoalZoneTypeNumber)
       mGoalZones.push_back(theObject);
@@ -155,6 +167,8 @@ void GridDatabase::addToDatabase(DatabaseObject *theObject)
       mFlags.push_back(theObject);
    else if(type == SpyBugTypeNumber)
       mSpyBugs.push_back(theObject);
+   else if(isWallType(type))
+      mWallEdgeGridDirty = true;
    
    //sortObjects(mAllObjects);  // problem: Barriers in-game don't have mGeometry (it is NULL)
 }
@@ -179,6 +193,7 @@ void GridDatabase::removeEverythingFromDatabase()
             DatabaseBucketEntry *rem = walk;
             walk->theObject->mDatabase = NULL;  // make sure object don't point to this database anymore
             walk->theObject->mBucketList = NULL;
+            walk->theObject->mHotSlot = -1;
             walk = rem->nextInBucket;
             mChunker->free(rem);
          }
@@ -192,6 +207,8 @@ void GridDatabase::removeEverythingFromDatabase()
    mSpyBugs.clear();
 
    mAllObjects.deleteAndClear();
+   mHotStates.clear();
+   mWallEdgeGridDirty = true;
    
    if(mWallSegmentManager)
       mWallSegmentManager->clear();
@@ -242,6 +259,12 @@ void GridDatabase::removeFromDatabase(DatabaseObject *object, bool deleteObject)
          break;
       }
 
+   if(object->mHotSlot != -1)
+   {
+      mHotStates.releaseSlot(object->mHotSlot);
+      object->mHotSlot = -1;
+   }
+
 
    U8 type = object->getObjectTypeNumber();
 
@@ -251,6 +274,8 @@ void GridDatabase::removeFromDatabase(DatabaseObject *object, bool deleteObject)
       eraseObject_fast(&mFlags, object);
    else if(type == SpyBugTypeNumber)
       eraseObject_fast(&mSpyBugs, object);
+   else if(isWallType(type))
+      mWallEdgeGridDirty = true;
 
    if(deleteObject)
       delete object;      
@@ -301,7 +326,7 @@ void GridDatabase::findObjects(U8 typeNumber, Vector<DatabaseObject *> &fillVect
 }
 
 
-void GridDatabase::findObjects(Vector<U8> typeNumbers, Vector<DatabaseObject *> &fillVector, const Rect *extents, const IntRect *bins) const
+void GridDatabase::findObjects(const Vector<U8> &typeNumbers, Vector<DatabaseObject *> &fillVector, const Rect *extents, const IntRect *bins) const
 {
    mQueryId++;    // Used to prevent the same item from being found in multiple buckets
 
@@ -554,6 +579,34 @@ void DatabaseObject::initialize()
    mExtentSet = false;
    mDatabase = NULL;
    mBucketList = NULL;
+   mHotSlot = -1;
+}
+
+
+bool DatabaseObject::hasHotState() const
+{
+   return false;
+}
+
+
+void DatabaseObject::refreshHotState()
+{
+   // Do nothing
+}
+
+
+S32 DatabaseObject::getHotSlot() const
+{
+   return mHotSlot;
+}
+
+
+HotStateTable *DatabaseObject::getHotStateTable() const
+{
+   if(mHotSlot == -1)
+      return NULL;
+
+   return mDatabase->getHotStateTable();
 }
 
 
@@ -706,12 +759,43 @@ DatabaseObject *GridDatabase::findObjectLOS(TestFunc testFunc, U32 stateIndex,
 }
 
 
+// Same answer as a findObjectLOS() for walls, but much quicker when asked more than a few times per wall change
 bool GridDatabase::pointCanSeePoint(const Point &point1, const Point &point2)
 {
-   F32 time;
-   Point coll;
+   return getWallEdgeGrid()->segmentIsClear(point1, point2);
+}
+
+
+const WallEdgeGrid *GridDatabase::getWallEdgeGrid()
+{
+   if(!mWallEdgeGrid)
+      mWallEdgeGrid = new WallEdgeGrid();    // Gets deleted in destructor
+
+   if(mWallEdgeGridDirty)
+   {
+      static Vector<DatabaseObject *> walls;    // Don't disturb the global fillVector
+      walls.clear();
+
+      findObjects((TestFunc)isWallType, walls);
+      mWallEdgeGrid->build(walls);
 
-   return( findObjectLOS((TestFunc)isWallType, ActualState, true, point1, point2, time, coll) == NULL );
+      mWallEdgeGridDirty = false;
+   }
+
+   return mWallEdgeGrid;
+}
+
+
+// Walls are assumed not to change shape without also changing extent, so this is called from setExtent()
+void GridDatabase::invalidateWallEdgeGrid()
+{
+   mWallEdgeGridDirty = true;
+}
+
+
+HotStateTable *GridDatabase::getHotStateTable()
+{
+   return &mHotStates;
 }
 
 
@@ -887,6 +971,9 @@ void DatabaseObject::setExtent(const Rect &extents)
 
    if(gridDB)
    {
+      if(isWallType(mObjectTypeNumber))
+         gridDB->invalidateWallEdgeGrid();
+
       // Remove from the extents database for current extents...
       //gridDB->removeFromDatabase(this, mExtent);    // old extent
       // ...and re-add for the new extent
@@ -952,6 +1039,10 @@ void DatabaseObject::setExtent(const Rect &extents)
 
    mExtent.set(extents);
    mExtentSet = true;
+
+   // Catches position changes that didn't come through our owner's setters, e.g. a new geometry from Lua
+   if(mHotSlot != -1)
+      refreshHotState();
 }
 
 
@@ -7,6 +7,7 @@
 #define _GRIDDB_H_
 
 #include "GeomObject.h"    // Base class
+#include "HotStateTable.h"
 
 #include "tnlTypes.h"
 #include "tnlDataChunker.h"
@@ -55,10 +56,14 @@ private:
    bool mExtentSet;     // A flag to mark whether extent has been set on this object
    GridDatabase *mDatabase;
    DatabaseBucketEntry *mBucketList;
+   S32 mHotSlot;        // Our entry in mDatabase's HotStateTable, or -1 if we don't have one
 
 protected:
    U8 mObjectTypeNumber;
 
+   virtual bool hasHotState() const;      // Return true to get a slot in the HotStateTable of any database we're added to
+   virtual void refreshHotState();        // Write our whole entry; called when we get a slot, and when our extent changes
+
 public:
    DatabaseObject();                            // Constructor
    DatabaseObject(const DatabaseObject &t);     // Copy constructor
@@ -88,6 +93,9 @@ public:
 
    U8 getObjectTypeNumber() const;
 
+   S32 getHotSlot() const;
+   HotStateTable *getHotStateTable() const;     // NULL if we don't have a slot
+
    virtual bool isDatabasable();    // Can this item actually be inserted into a database?
 
    virtual DatabaseObject *clone() const;
@@ -98,6 +106,7 @@ public:
 ////////////////////////////////////////
 
 class WallSegmentManager;
+class WallEdgeGrid;
 class GoalZone;
 
 class GridDatabase
@@ -109,13 +118,18 @@ private:
 
    WallSegmentManager *mWallSegmentManager;
 
+   WallEdgeGrid *mWallEdgeGrid;        // Built on demand for pointCanSeePoint()
+   bool mWallEdgeGridDirty;
+
+   HotStateTable mHotStates;
+
    Vector<DatabaseObject *> mAllObjects;
    Vector<DatabaseObject *> mGoalZones;
    Vector<DatabaseObject *> mFlags;
    Vector<DatabaseObject *> mSpyBugs;
 
    void findObjects(U8 typeNumber, Vector<DatabaseObject *> &fillVector, const Rect *extents, const IntRect *bins) const;
-   void findObjects(Vector<U8> typeNumbers, Vector<DatabaseObject *> &fillVector, const Rect *extents, const IntRect *bins) const;
+   void findObjects(const Vector<U8> &typeNumbers, Vector<DatabaseObject *> &fillVector, const Rect *extents, const IntRect *bins) const;
    void findObjects(TestFunc testFunc, Vector<DatabaseObject *> &fillVector, const Rect *extents, const IntRect *bins, bool sameQuery = false) const;
 
    void fillBins(const Rect &extents, IntRect &bins) const;    // Helper function -- translates extents into bins to search
@@ -147,6 +161,9 @@ public:
                                  float &collisionTime, Point &surfaceNormal) const;
 
    bool pointCanSeePoint(const Point &point1, const Point &point2);
+   const WallEdgeGrid *getWallEdgeGrid();    // Rebuilt here if walls have changed since last time
+   void invalidateWallEdgeGrid();
+   HotStateTable *getHotStateTable();
    void computeSelectionMinMax(Point &min, Point &max);
 
    void findObjects(Vector<DatabaseObject *> &fillVector) const;     // Returns all objects in the database
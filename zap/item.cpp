@@ -162,6 +162,7 @@ F32 Item::getRadius()
 void Item::setRadius(F32 radius)
 {
    mRadius = radius;
+   refreshHotState();
 }
 
 
@@ -1182,13 +1182,25 @@ int main(int argc, char **argv)
       checkIfThisIsAnUpdate(settings.get(), isStandalone);
 
    // Load Lua stuff
-   LuaScriptRunner::startLua(folderManager->luaDir);  // Create single "L" instance which all scripts will use
+   // Create single "L" instance which all scripts will use
+   if(LuaScriptRunner::startLua(folderManager->luaDir))
+   {
+      IniSettings *iniSettings = settings->getIniSettings();
+
+      LuaScriptRunner::setJitOptions(iniSettings->luaJitEnabled, iniSettings->luaJitOptions);
+      LuaScriptRunner::setScriptMemoryLimit(S64(iniSettings->luaScriptMemoryLimitKB) * 1024);
+      EventManager::setTickBudget(iniSettings->botTickBudget);
+   }
    // TODO: What should we do if this fails?  Quit the game?
 
    setupLogging(settings->getIniSettings());    // Turns various logging options on and off
 
    Ship::computeMaxFireDelay();                 // Look over weapon info and get some ranges, which we'll need before we start sending data
 
+#ifndef ZAP_DEDICATED
+   Ship::setInterpolationDelay(settings->getIniSettings()->interpolationDelay);
+#endif
+
    settings->runCmdLineDirectives();            // If we specified a directive on the cmd line, like -help, attend to that now
 
    // Even dedicated server needs sound these days
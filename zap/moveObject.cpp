@@ -183,7 +183,12 @@ Point MoveObject::getPos(S32 stateIndex) const
 void MoveObject::setPos(S32 stateIndex, const Point &pos)
 {
    if(stateIndex == ActualState)
+   {
       Parent::setPos(pos);
+
+      if(getHotSlot() != -1)
+         getHotStateTable()->setPos(getHotSlot(), pos);
+   }
    else
       mMoveStates.setPos(stateIndex, pos);
 
@@ -202,8 +207,45 @@ void MoveObject::setPos(lua_State *L, S32 stackPos)
 Point MoveObject::getVel  (S32 stateIndex) const { return mMoveStates.getVel  (stateIndex); }
 F32   MoveObject::getAngle(S32 stateIndex) const { return mMoveStates.getAngle(stateIndex); }
 
-void MoveObject::setVel  (S32 stateIndex, const Point &vel) { mMoveStates.setVel  (stateIndex, vel);   }
-void MoveObject::setAngle(S32 stateIndex, F32 angle)        { mMoveStates.setAngle(stateIndex, angle); }
+void MoveObject::setVel(S32 stateIndex, const Point &vel)
+{
+   mMoveStates.setVel(stateIndex, vel);
+
+   if(stateIndex == ActualState && getHotSlot() != -1)
+      getHotStateTable()->setVel(getHotSlot(), vel);
+}
+
+
+void MoveObject::setAngle(S32 stateIndex, F32 angle)
+{
+   mMoveStates.setAngle(stateIndex, angle);
+
+   if(stateIndex == ActualState && getHotSlot() != -1)
+      getHotStateTable()->setAngle(getHotSlot(), angle);
+}
+
+
+bool MoveObject::hasHotState() const
+{
+   return true;
+}
+
+
+// Our own actual state, even when a MountableItem subclass would report its mount's
+void MoveObject::refreshHotState()
+{
+   HotStateTable *hotStates = getHotStateTable();
+   if(!hotStates)
+      return;
+
+   S32 slot = getHotSlot();
+
+   hotStates->setPos   (slot, getPos  (ActualState));
+   hotStates->setVel   (slot, getVel  (ActualState));
+   hotStates->setAngle (slot, getAngle(ActualState));
+   hotStates->setRadius(slot, getRadius());
+   hotStates->setTeam  (slot, getTeam());
+}
 
 
 // For Geometry, should set both actual and render position
@@ -326,11 +368,22 @@ F32 MoveObject::computeMinSeperationTime(U32 stateIndex, MoveObject *contactShip
 const F32 moveTimeEpsilon = 0.000001f;
 const F32 velocityEpsilon = 0.00001f;
 
+
 // Apply mMoveState info to an object to compute it's new position.  Used for ships et. al.
 // isBeingDisplaced is true when the object is being pushed by something else, which will only happen in a collision
 // Remember: stateIndex will be one of 0-ActualState, 1-RenderState, or 2-LastProcessState
-F32 MoveObject::move(F32 moveTime, U32 stateIndex, bool isBeingDisplaced, Vector<SafePtr<MoveObject> > displacerList)
+F32 MoveObject::move(F32 moveTime, U32 stateIndex, bool isBeingDisplaced)
 {
+   Vector<SafePtr<MoveObject> > displacerList;     // Doesn't allocate unless we end up pushing something
+   return move(moveTime, stateIndex, isBeingDisplaced, displacerList);
+}
+
+
+// displacerList is shared by the whole chain of displacements; each move only appends to it, and takes its additions
+// back off before returning, so every move sees the same list it would have if it had been handed its own copy
+F32 MoveObject::move(F32 moveTime, U32 stateIndex, bool isBeingDisplaced, Vector<SafePtr<MoveObject> > &displacerList)
+{
+   S32 displacerCount = displacerList.size();
    U32 tryCount = 0;
    const U32 TRY_COUNT_MAX = 8;
    Vector<SafePtr<BfObject> > disabledList;
@@ -427,6 +480,8 @@ F32 MoveObject::move(F32 moveTime, U32 stateIndex, bool isBeingDisplaced, Vector
       if(disabledList[i].isValid())
          disabledList[i]->enableCollision();
 
+   displacerList.resize(displacerCount);
+
    if(tryCount == TRY_COUNT_MAX && moveTime > moveTimeStart * 0.98f)
       setVel(stateIndex, Point(0,0));  // prevents some overload by not trying to move anymore
 
@@ -452,6 +507,10 @@ static S32 QSORT_CALLBACK sortBarriersFirst(DatabaseObject **a, DatabaseObject *
 }
 
 
+// Each pass of move() runs its own query over just the sweep.  A shared broadphase has been tried (one candidate list
+// per move, or pinned across a whole replay), and didn't pay: most moves finish in a single pass, the list has to
+// cover everywhere the object could reach, and it goes stale whenever a collided() handler runs or something gets
+// pushed, spawned or teleported.  Queries fell by under 2%, with no gain in time.
 BfObject *MoveObject::findFirstCollision(U32 stateIndex, F32 &collisionTime, Point &collisionPoint)
 {
    // Check for collisions against other objects
@@ -1277,6 +1336,7 @@ void MountableItem::unpackUpdate(GhostConnection *connection, BitStream *stream)
          dismount(DISMOUNT_NORMAL);
 
       mIsMounted = isMounted;
+      refreshHotState();
       updateExtentInDatabase();
    }
 }
@@ -1310,6 +1370,7 @@ void MountableItem::mountToShip(Ship *ship)
    ship->addMountedItem(this);
 
    mIsMounted = true;
+   refreshHotState();
    setMaskBits(MountMask);
 
    if(isGhost())     // client
@@ -1340,6 +1401,7 @@ void MountableItem::dismount(DismountMode dismountMode)
    {
       setPos(mMount->getActualPos());  
       mIsMounted = false;     // For client, wait to set this in unpackUpdate
+      refreshHotState();
    }
 
    mMount = NULL;
@@ -1364,6 +1426,15 @@ void MountableItem::dismount(DismountMode dismountMode)
 }
 
 
+void MountableItem::refreshHotState()
+{
+   Parent::refreshHotState();
+
+   if(getHotSlot() != -1)
+      getHotStateTable()->setFlag(getHotSlot(), HotStateTable::MountedFlag, mIsMounted);
+}
+
+
 bool MountableItem::isMounted() { return mIsMounted; }
 Ship *MountableItem::getMount() { return mMount;     }
 
@@ -1456,6 +1527,7 @@ void VelocityItem::setInitialPosVelAng(const Point &pos, const Point &vel, F32 a
 ////////////////////////////////////////
 
 TNL_IMPLEMENT_NETOBJECT(Asteroid);
+BF_IMPLEMENT_POOLED_ALLOC(Asteroid);
 
 static const F32 ASTEROID_MASS_LAST_SIZE              = 1;
 static const F32 ASTEROID_RADIUS_MULTIPLYER_LAST_SIZE = 89 * 0.2f;
@@ -2005,6 +2077,7 @@ REGISTER_LUA_SUBCLASS(TestItem, MoveObject);
 ////////////////////////////////////////
 
 TNL_IMPLEMENT_NETOBJECT(ResourceItem);
+BF_IMPLEMENT_POOLED_ALLOC(ResourceItem);
 
 static const F32 RESOURCE_ITEM_MASS = 1;
 
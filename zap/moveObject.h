@@ -8,6 +8,7 @@
 
 #include "item.h"          // Parent class
 #include "LuaWrapper.h"
+#include "ObjectPool.h"
 #include "DismountModesEnum.h"
 
 namespace Zap
@@ -66,6 +67,8 @@ private:
    Vector<SafePtr<Zone> > &getCurrZoneList();                  // Get list of zones object is currently in
    Vector<SafePtr<Zone> > &getPrevZoneList();                  // Get list of zones object was in last tick
 
+   F32 move(F32 time, U32 stateIndex, bool displacing, Vector<SafePtr<MoveObject> > &displacerList);
+
 protected:
    enum {
       InterpMaxVelocity = 900, // velocity to use to interpolate to proper position
@@ -86,6 +89,9 @@ protected:
    virtual void onLeftZone(Zone *zone);
    void getZonesObjectIsIn(Vector<SafePtr<Zone> > &zoneList);
 
+   bool hasHotState() const;
+   void refreshHotState();
+
 public:
    MoveObject(const Point &p = Point(0,0), float radius = 1, float mass = 1);     // Constructor
    virtual ~MoveObject();                                                                // Destructor
@@ -146,7 +152,7 @@ public:
 
    virtual void playCollisionSound(U32 stateIndex, MoveObject *moveObjectThatWasHit, F32 velocity);
 
-   F32 move(F32 time, U32 stateIndex, bool displacing = false, Vector<SafePtr<MoveObject> > = Vector<SafePtr<MoveObject> >());
+   F32 move(F32 time, U32 stateIndex, bool displacing = false);
    virtual bool collide(BfObject *otherObject);
 
    // CollideTypes is used to improve speed on findFirstCollision
@@ -235,6 +241,8 @@ protected:
 
    Timer mDroppedTimer;                   // Make flags have a tiny bit of delay before they can be picked up again
 
+   void refreshHotState();
+
 public:
    MountableItem(const Point &pos = Point(0,0), bool collideable = false, float radius = 1, float mass = 1);   // Constructor
    virtual ~MountableItem();                                                                                   // Destructor
@@ -373,6 +381,7 @@ public:
    void setCurrentSize(S32 size);
 
    TNL_DECLARE_CLASS(Asteroid);
+   BF_DECLARE_POOLED_ALLOC;
 
    ///// Editor methods
    const char *getEditorHelpString();
@@ -471,6 +480,7 @@ public:
 
 
    TNL_DECLARE_CLASS(ResourceItem);
+   BF_DECLARE_POOLED_ALLOC;
 
    ///// Editor methods
    const char *getEditorHelpString();
@@ -20,6 +20,7 @@
 
 
 TNL_IMPLEMENT_NETOBJECT(Projectile);
+BF_IMPLEMENT_POOLED_ALLOC(Projectile);
 
 namespace Zap 
 {
@@ -529,6 +530,7 @@ S32 Projectile::lua_setVel(lua_State *L)
 ////////////////////////////////////////
 
 TNL_IMPLEMENT_NETOBJECT(Burst);
+BF_IMPLEMENT_POOLED_ALLOC(Burst);
 
 // Constructor -- used when burst is fired
 Burst::Burst(const Point &pos, const Point &vel, BfObject *shooter, F32 radius) : MoveItem(pos, true, radius, BurstMass)
@@ -797,6 +799,7 @@ S32 Burst::lua_getWeapon(lua_State *L) { return returnWeaponType(L, mWeaponType)
 ////////////////////////////////////////
 
 TNL_IMPLEMENT_NETOBJECT(Mine);
+BF_IMPLEMENT_POOLED_ALLOC(Mine);
 
 
 const U32 Mine::FuseDelay = 100;
@@ -1095,6 +1098,7 @@ REGISTER_LUA_SUBCLASS(Mine, Burst);
 //////////////////////////////////
 
 TNL_IMPLEMENT_NETOBJECT(SpyBug);
+BF_IMPLEMENT_POOLED_ALLOC(SpyBug);
 
 // Constructor -- used when SpyBug is deployed
 SpyBug::SpyBug(const Point &pos, BfObject *planter) : Burst(pos, Point(0,0), planter)
@@ -1363,6 +1367,7 @@ REGISTER_LUA_SUBCLASS(SpyBug, Burst);
 ////////////////////////////////////////
 
 TNL_IMPLEMENT_NETOBJECT(Seeker);
+BF_IMPLEMENT_POOLED_ALLOC(Seeker);
 
 // Constructor
 const F32 Seeker_Radius = 4;
@@ -85,6 +85,7 @@ public:
    BfObject *getShooter() const;
 
    TNL_DECLARE_CLASS(Projectile);
+   BF_DECLARE_POOLED_ALLOC;
 
    //// Lua interface
    LUAW_DECLARE_CLASS_CUSTOM_CONSTRUCTOR(Projectile);
@@ -151,6 +152,7 @@ public:
    BfObject *getShooter() const;
 
    TNL_DECLARE_CLASS(Burst);
+   BF_DECLARE_POOLED_ALLOC;
 
    //// Lua interface
    LUAW_DECLARE_CLASS_CUSTOM_CONSTRUCTOR(Burst);
@@ -197,6 +199,7 @@ public:
    void unpackUpdate(GhostConnection *connection, BitStream *stream);
 
    TNL_DECLARE_CLASS(Mine);
+   BF_DECLARE_POOLED_ALLOC;
 
    /////
    // Editor methods
@@ -258,6 +261,7 @@ public:
    void unpackUpdate(GhostConnection *connection, BitStream *stream);
 
    TNL_DECLARE_CLASS(SpyBug);
+   BF_DECLARE_POOLED_ALLOC;
 
    /////
    // Editor methods
@@ -350,6 +354,7 @@ public:
    BfObject *getShooter() const;
 
    TNL_DECLARE_CLASS(Seeker);
+   BF_DECLARE_POOLED_ALLOC;
 
    //// Lua interface
    LUAW_DECLARE_CLASS_CUSTOM_CONSTRUCTOR(Seeker);
@@ -12,6 +12,7 @@
 
 #include "MathUtils.h"           // For findLowestRootIninterval()
 #include "GeomUtils.h"
+#include "WallEdgeGrid.h"
 
 #include "ServerGame.h"
 #include "GameManager.h"
@@ -72,6 +73,9 @@ Robot::Robot(lua_State *L) : Ship(NULL, TEAM_NEUTRAL, Point(0,0), true),
    mCurrentZone = U16_MAX;
    flightPlanTo = U16_MAX;
 
+   mDeferredThinkTime = 0;
+   mThinkInterval = ServerGame::BotControlTickInterval;
+
    mPlayerInfo = new RobotPlayerInfo(this);
 
 #ifndef ZAP_DEDICATED
@@ -192,7 +196,7 @@ bool Robot::prepareEnvironment()
    // Set this first so we have this object available in the helper functions in case we need overrides
    setSelf(L, this, "bot");
 
-   return loadCompileRunEnvironmentScript("timer.lua") && loadAndRunGlobalFunction(L, ROBOT_HELPER_FUNCTIONS_KEY, RobotContext);
+   return loadAndRunGlobalFunction(L, SCRIPT_TIMER_KEY, RobotContext) && loadAndRunGlobalFunction(L, ROBOT_HELPER_FUNCTIONS_KEY, RobotContext);
 }
 
 
@@ -438,6 +442,23 @@ F32 Robot::getAnglePt(Point point)
 
 
 bool Robot::canSeePoint(Point point, bool wallOnly)
+{
+   // Bots tend to ask about the same points (usually each other) many times per tick
+   BotPerception *perception = static_cast<ServerGame *>(getGame())->getBotPerception();
+   BotPerception::LosType losType = wallOnly ? BotPerception::LosWall : BotPerception::LosCollideable;
+
+   bool canSee;
+   if(perception->getCachedLos(getActualPos(), point, losType, canSee))
+      return canSee;
+
+   canSee = computeCanSeePoint(point, wallOnly);
+   perception->cacheLos(getActualPos(), point, losType, canSee);
+
+   return canSee;
+}
+
+
+bool Robot::computeCanSeePoint(const Point &point, bool wallOnly)
 {
    Point difference = point - getActualPos();
 
@@ -452,16 +473,20 @@ bool Robot::canSeePoint(Point point, bool wallOnly)
    Point pointEdge1 = point + crossVector;
    Point pointEdge2 = point - crossVector;
 
-   Vector<Point> thisPoints;
+   static Vector<Point> thisPoints;    // Reusable container
+   thisPoints.clear();
    thisPoints.push_back(shipEdge1);
    thisPoints.push_back(shipEdge2);
    thisPoints.push_back(pointEdge2);
    thisPoints.push_back(pointEdge1);
 
+   if(wallOnly)
+      return mGame->getGameObjDatabase()->getWallEdgeGrid()->polygonIsClear(thisPoints);
+
    Rect queryRect(thisPoints);
 
    fillVector.clear();
-   mGame->getGameObjDatabase()->findObjects(wallOnly ? (TestFunc)isWallType : (TestFunc)isCollideableType, fillVector, queryRect);
+   mGame->getGameObjDatabase()->findObjects((TestFunc)isCollideableType, fillVector, queryRect);
 
    for(S32 i = 0; i < fillVector.size(); i++)
    {
@@ -529,6 +554,42 @@ void Robot::clearMove()
 }
 
 
+// Called instead of onTick when the tick budget is exhausted
+void Robot::deferThink(U32 deltaT)
+{
+   mDeferredThinkTime += deltaT;
+}
+
+
+bool Robot::isThinkDeferred() const
+{
+   return mDeferredThinkTime > 0;
+}
+
+
+void Robot::cancelDeferredThink()
+{
+   mDeferredThinkTime = 0;
+}
+
+
+U32 Robot::startThink(U32 deltaT)
+{
+   U32 elapsed = deltaT + mDeferredThinkTime;
+   mDeferredThinkTime = 0;
+
+   mThinkInterval = mThinkInterval * 0.9f + elapsed * 0.1f;
+
+   return elapsed;
+}
+
+
+F32 Robot::getThinkRate() const
+{
+   return mThinkInterval > 0 ? 1000.0f / mThinkInterval : 0;
+}
+
+
 bool Robot::isRobot()
 {
    return true;
@@ -549,7 +610,10 @@ const char *Robot::getScriptName()
 
 Robot *Robot::clone() const
 {
-   return new Robot(*this);
+   Robot *robot = new Robot(*this);
+   robot->mSnapshots = NULL;     // See Ship::clone()
+
+   return robot;
 }
 
 
@@ -607,6 +671,7 @@ U16 Robot::findClosestZone(const Point &point)
    METHOD(CLASS,  setAngle,             ARRAYDEF({{ PT, END }, { NUM, END }}), 2 )           \
    METHOD(CLASS,  getAnglePt,           ARRAYDEF({{ PT, END }              }), 1 )           \
    METHOD(CLASS,  canSeePoint,          ARRAYDEF({{ PT, END }              }), 1 )           \
+   METHOD(CLASS,  getThinkRate,         ARRAYDEF({{ END }                  }), 1 )           \
                                                                                              \
    METHOD(CLASS,  getWaypoint,          ARRAYDEF({{ PT, END }}), 1 )                         \
                                                                                              \
@@ -627,6 +692,7 @@ U16 Robot::findClosestZone(const Point &point)
    METHOD(CLASS,  privateMsg,           ARRAYDEF({{ STR, STR, END }}), 1 )                   \
                                                                                              \
    METHOD(CLASS,  findVisibleObjects,   ARRAYDEF({{ TABLE, INTS, END }, { INTS, END }}), 2 ) \
+   METHOD(CLASS,  findVisibleObjectData, ARRAYDEF({{ TABLE, INTS, END }}), 1 )              \
    METHOD(CLASS,  findClosestEnemy,     ARRAYDEF({{              END }, { NUM,  END }}), 2 ) \
                                                                                              \
    METHOD(CLASS,  getFiringSolution,    ARRAYDEF({{ BFOBJ, END }}), 1 )                      \
@@ -721,6 +787,25 @@ S32 Robot::lua_canSeePoint(lua_State *L)
 }
 
 
+/**
+ * @luafunc num Robot::getThinkRate()
+ * 
+ * @brief Returns how many times per second this bot's onTick() is currently being called.
+ * 
+ * @descr Bots normally think about 30 times per second, but when many bots are busy, the server
+ * will spread their work across several ticks, and each bot will think less often.  The deltaT
+ * passed to onTick() always covers all the time since the bot's previous onTick().
+ * 
+ * @return The smoothed number of onTick() calls per second
+ */
+S32 Robot::lua_getThinkRate(lua_State *L)
+{
+   checkArgList(L, functionArgs, "Robot", "getThinkRate");
+
+   return returnFloat(L, getThinkRate());
+}
+
+
 /**
  * @luafunc point Robot::getWaypoint(point p)
  * 
@@ -885,52 +970,23 @@ S32 Robot::lua_findClosestEnemy(lua_State *L)
 {
    S32 profile = checkArgList(L, functionArgs, "Robot", "findClosestEnemy");
 
-   Point pos = getActualPos();
-   Rect queryRect(pos, pos);
-   bool useRange = true;
+   BotPerception *perception = static_cast<ServerGame *>(getGame())->getBotPerception();
+   Ship *closest;
 
    if(profile == 0)           // Args: None
-      queryRect.expand(getGame()->computePlayerVisArea(this));  
+      closest = perception->findClosestEnemyInScannerRange(this);
    else                       // Args: Range
    {
       F32 range = getFloat(L, 1);
       if(range == -1)
-         useRange = false;
-        else
+         closest = perception->findClosestEnemy(this, NULL);
+      else
+      {
+         Point pos = getActualPos();
+         Rect queryRect(pos, pos);
          queryRect.expand(Point(range, range));
-   }
-
-
-   F32 minDist = F32_MAX;
-   Ship *closest = NULL;
-
-   fillVector.clear();
-
-   if(useRange)
-      getGame()->getGameObjDatabase()->findObjects((TestFunc)isShipType, fillVector, queryRect);   
-   else
-      getGame()->getGameObjDatabase()->findObjects((TestFunc)isShipType, fillVector);   
 
-   for(S32 i = 0; i < fillVector.size(); i++)
-   {
-      // Ignore self 
-      if(fillVector[i] == this) 
-         continue;
-
-      // Ignore ship/robot if it's dead or cloaked
-      Ship *ship = static_cast<Ship *>(fillVector[i]);
-      if(ship->mHasExploded || !ship->isVisible(hasModule(ModuleSensor)))
-         continue;
-
-      // Ignore ships on same team during team games
-      if(ship->getTeam() == getTeam() && getGame()->getGameType()->isTeamGame())
-         continue;
-
-      F32 dist = ship->getActualPos().distSquared(getActualPos());
-      if(dist < minDist)
-      {
-         minDist = dist;
-         closest = ship;
+         closest = perception->findClosestEnemy(this, &queryRect);
       }
    }
 
@@ -1270,6 +1326,31 @@ S32 Robot::lua_privateMsg(lua_State *L)
 }
 
 
+// Drops ourselves, and any ships we shouldn't be able to see, from a list of found objects.  We compact the list in
+// place, rather than erasing as we go, so big scopes don't cost us a shuffle for every ship we drop.
+void Robot::removeHiddenObjects(Vector<DatabaseObject *> &objects)
+{
+   bool hasSensor = hasModule(ModuleSensor);
+   S32 kept = 0;
+
+   for(S32 i = 0; i < objects.size(); i++)
+   {
+      if(isShipType(objects[i]->getObjectTypeNumber()))
+      {
+         // Ignore ship/robot if it's us, or dead or cloaked (unless bot has sensor)
+         Ship *ship = static_cast<Ship *>(objects[i]);
+         if(ship == this || !ship->isVisible(hasSensor) || ship->mHasExploded)
+            continue;
+      }
+
+      objects[kept] = objects[i];
+      kept++;
+   }
+
+   objects.resize(kept);
+}
+
+
 /**
  * @luafunc table Robot::findVisibleObjects(ObjType types, ...)
  * 
@@ -1326,7 +1407,7 @@ S32 Robot::lua_findVisibleObjects(lua_State *L)
    }
 
    // Get other objects on screen-visible area only
-   getGame()->getGameObjDatabase()->findObjects(types, fillVector, queryRect);
+   static_cast<ServerGame *>(getGame())->getBotPerception()->findObjects(types, fillVector, queryRect);
 
 
    // We are expecting a table to be on top of the stack when we get here.  If not, we can add one.
@@ -1345,22 +1426,12 @@ S32 Robot::lua_findVisibleObjects(lua_State *L)
    TNLAssert((lua_gettop(L) == 1 && lua_istable(L, -1)) || dumpStack(L), "Should only have table!");
 
 
+   removeHiddenObjects(fillVector);
+
    S32 pushed = 0;      // Count of items we put into our table
 
    for(S32 i = 0; i < fillVector.size(); i++)
    {
-      if(isShipType(fillVector[i]->getObjectTypeNumber()))
-      {
-         if(fillVector[i] == this)  // Don't add this bot to the list of found objects!
-            continue;
-
-         // Ignore ship/robot if it's dead or cloaked (unless bot has sensor)
-         Ship *ship = static_cast<Ship *>(fillVector[i]);
-         bool callerHasSensor = this->hasModule(ModuleSensor);
-         if(!ship->isVisible(callerHasSensor) || ship->mHasExploded)
-            continue;
-      }
-
       static_cast<BfObject *>(fillVector[i])->push(L);
       pushed++;      // Increment pushed before using it because Lua uses 1-based arrays
       lua_rawseti(L, 1, pushed);
@@ -1372,6 +1443,48 @@ S32 Robot::lua_findVisibleObjects(lua_State *L)
 }
 
 
+/**
+ * @luafunc int Robot::findVisibleObjectData(table data, ObjType types, ...)
+ *
+ * @brief Like findVisibleObjects, but writes a compact record for each object
+ * into a table you provide.
+ *
+ * @descr Reusing `data` from tick to tick means scanning for objects creates no
+ * garbage.  See LuaScriptRunner::findAllObjectData for the record layout.
+ *
+ * @param data Table to fill.
+ * @param types One or more \ref ObjTypeEnum specifying what types of objects to
+ * find.
+ *
+ * @return The number of objects found.
+ */
+S32 Robot::lua_findVisibleObjectData(lua_State *L)
+{
+   checkArgList(L, functionArgs, "Robot", "findVisibleObjectData");
+
+   Point pos = getActualPos();
+   Rect queryRect(pos, pos);
+   queryRect.expand(getGame()->computePlayerVisArea(this));
+
+   static Vector<U8> types;
+   bool hasBotZoneType;
+
+   types.clear();
+   fillVector.clear();
+
+   popObjTypes(L, types, hasBotZoneType);
+
+   if(hasBotZoneType)
+      getGame()->getBotZoneDatabase()->findObjects(BotNavMeshZoneTypeNumber, fillVector, queryRect);
+
+   static_cast<ServerGame *>(getGame())->getBotPerception()->findObjects(types, fillVector, queryRect);
+
+   removeHiddenObjects(fillVector);
+
+   return fillObjectDataTable(L, fillVector);
+}
+
+
 static bool calcInterceptCourse(BfObject *target, Point aimPos, F32 aimRadius, S32 aimTeam, F32 aimVel, 
                                 F32 aimLife, bool ignoreFriendly, bool botHasSensor, F32 &interceptAngle)
 {
@@ -38,8 +38,12 @@ private:
 
    bool mHasSpawned;
 
+   U32 mDeferredThinkTime;          // Time that passed while onTick was skipped for lack of tick budget
+   F32 mThinkInterval;              // Smoothed time between onTick calls, in ms
+
    Point getNextWaypoint();                          // Helper function for getWaypoint()
    U16 findClosestZone(const Point &point);          // Finds zone closest to point, used when robots get off the map
+   void removeHiddenObjects(Vector<DatabaseObject *> &objects);  // Helper for the findVisible*() methods
 
 protected:
    void killScript();
@@ -62,6 +66,7 @@ public:
    S32 getCurrentZone();
    void setCurrentZone(S32 zone);
    bool canSeePoint(Point point, bool wallOnly = false);         // Is point within robot's LOS?
+   bool computeCanSeePoint(const Point &point, bool wallOnly);   // Same, but skips the per-tick cache
 
    Vector<Point> flightPlan;           // List of points to get from one point to another
    U16 flightPlanTo;                   // Zone our flightplan was calculated to
@@ -81,6 +86,13 @@ public:
 
    void clearMove();                   // Reset bot's move to do nothing
 
+   // Bookkeeping for the budgeted onTick dispatch in EventManager
+   void deferThink(U32 deltaT);
+   bool isThinkDeferred() const;
+   void cancelDeferredThink();         // Forget deferred time, when the bot stops listening for onTick
+   U32 startThink(U32 deltaT);         // Returns deltaT plus any time deferred since the last onTick
+   F32 getThinkRate() const;           // onTick calls per second
+
 
    const char *getScriptName();
 
@@ -99,12 +111,14 @@ public:
    S32 lua_setAngle(lua_State *L);
    S32 lua_getAnglePt(lua_State *L);
    S32 lua_canSeePoint(lua_State *L);
+   S32 lua_getThinkRate(lua_State *L);
 
    // Navigation
    S32 lua_getWaypoint(lua_State *L);
 
    // Finding stuff
    S32 lua_findVisibleObjects(lua_State *L);
+   S32 lua_findVisibleObjectData(lua_State *L);
 
    // Bad dudes
    S32 lua_findClosestEnemy(lua_State *L);
@@ -10,6 +10,7 @@
 #include "Zone.h"
 #include "Colors.h"
 #include "Teleporter.h"
+#include "SnapshotBuffer.h"
 #include "speedZone.h"
 
 #ifndef ZAP_DEDICATED
@@ -36,6 +37,8 @@ namespace Zap
 
 TNL_IMPLEMENT_NETOBJECT(Ship);
 
+U32 Ship::mInterpolationDelay = 0;
+
 #ifdef _MSC_VER
 #  pragma warning(disable:4355)
 #endif
@@ -74,6 +77,8 @@ Ship::~Ship()
    if(mClientInfo && mClientInfo->getShip() == this)
       mClientInfo->setShip(NULL);   // Don't leave a dangling pointer
 
+   delete mSnapshots;
+
    LUAW_DESTRUCTOR_CLEANUP;
 }
 
@@ -90,6 +95,7 @@ void Ship::initialize(ClientInfo *clientInfo, S32 team, const Point &pos, bool i
    mLastProcessStateAngle = 0;
 
    mEngineeredTeleporter = NULL;
+   mSnapshots = NULL;
 
    // Set up module secondary delay timer
    for(S32 i = 0; i < ModuleCount; i++)
@@ -141,7 +147,10 @@ void Ship::initialize(ClientInfo *clientInfo, S32 team, const Point &pos, bool i
 
 Ship *Ship::clone() const
 {
-   return new Ship(*this);
+   Ship *ship = new Ship(*this);
+   ship->mSnapshots = NULL;      // Copy shouldn't share (and later delete) our buffer; it builds its own as updates arrive
+
+   return ship;
 }
 
 
@@ -1609,6 +1618,10 @@ void Ship::unpackUpdate(GhostConnection *connection, BitStream *stream)
 
    setActualAngle(mCurrentMove.angle);
 
+   // Other players' ships can be drawn from the updates themselves, a little behind, rather than from our guesses
+   if((positionChanged || shipwarped) && getGame() && !isLocalPlayerShip(getGame()))
+      addSnapshot(shipwarped);
+
 
    if(positionChanged && !isRobot() )
    {
@@ -1669,9 +1682,59 @@ F32 Ship::getUpdatePriority(GhostConnection *connection, U32 updateMask, S32 upd
 }
 
 
+// Static method
+void Ship::setInterpolationDelay(U32 delay)
+{
+   mInterpolationDelay = delay;
+}
+
+
+// Static method
+U32 Ship::getInterpolationDelay()
+{
+   return mInterpolationDelay;
+}
+
+
+// Client only.  Keep the state the server just sent us, before we extrapolate from it.  After a warp we start afresh,
+// as there's no sense in drawing the ship sliding from where it was to where it went.  Most ships never need a buffer,
+// so we only make one when there's something to put in it.
+void Ship::addSnapshot(bool warped)
+{
+   if(mInterpolationDelay == 0 || !getGame())
+   {
+      delete mSnapshots;
+      mSnapshots = NULL;
+      return;
+   }
+
+   if(!mSnapshots)
+      mSnapshots = new SnapshotBuffer();
+   else if(warped)
+      mSnapshots->clear();
+
+   mSnapshots->add(getGame()->getCurrentTime(), getActualPos(), getActualVel(), getActualAngle());
+}
+
+
 void Ship::updateInterpolation()
 {
-   Parent::updateInterpolation();
+   // If we're keeping the server's updates, draw the ship where they say it was a moment ago
+   if(mInterpolationDelay != 0 && mSnapshots && !mSnapshots->isEmpty())
+   {
+      Point pos, vel;
+      F32 angle;
+
+      mSnapshots->getState(getGame()->getCurrentTime() - mInterpolationDelay, pos, vel, angle);
+
+      setRenderPos(pos);
+      setRenderVel(vel);
+      setRenderAngle(angle);
+
+      mInterpolating = false;
+   }
+   else
+      Parent::updateInterpolation();
 
    // Update position of any mounted items
    for(S32 i = 0; i < mMountedItems.size(); i++)
@@ -29,6 +29,7 @@ class MountableItem;
 class SpeedZone;
 class Statistics;
 class Teleporter;
+class SnapshotBuffer;
 struct ControlObjectData;
 
 // class derived_class_name: public base_class_name
@@ -72,6 +73,10 @@ private:
 
    LoadoutTracker checkAndBuildLoadout(lua_State *L, S32 profile);
 
+   static U32 mInterpolationDelay;        // How far behind, in ms; 0 to draw ships as soon as updates arrive
+
+   void addSnapshot(bool warped);
+
 protected:
    SafePtr <ClientInfo> mClientInfo;
    StringTableEntry mPlayerName;
@@ -82,6 +87,8 @@ protected:
 
    Point mSpawnPoint;                        // Where ship or robot spawned.  Will only be valid on server, client doesn't currently get this.
 
+   SnapshotBuffer *mSnapshots;               // Client only; updates from the server, when we're drawing a little behind them
+
    void initialize(const Point &pos);        // Some initialization code needed by both bots and ships
    void initialize(ClientInfo *clientInfo, S32 team, const Point &pos, bool isRobot);
 
@@ -290,6 +297,9 @@ public:
 
    void updateInterpolation();
 
+   static void setInterpolationDelay(U32 delay);
+   static U32 getInterpolationDelay();
+
    F32 getUpdatePriority(GhostConnection *connection, U32 updateMask, S32 updateSkips);
 
    bool isRobot();
@@ -32,10 +32,8 @@ struct FxManager::TeleporterEffect
 FxManager::FxManager()
 {
    for(U32 i = 0; i < SparkTypeCount; i++)
-   {
-      firstFreeIndex[i] = 0;
-      lastOverwrittenIndex[i] = 500;
-   }
+      mSparks[i].setType((SparkType)i);
+
    teleporterEffects = NULL;
 }
 
@@ -52,52 +50,18 @@ FxManager::~FxManager()
 }
 
 
-// Create a new spark.   ttl = Time To Live (milliseconds)
-void FxManager::emitSpark(const Point &pos, const Point &vel, const Color &color, S32 ttl, UI::SparkType sparkType)
+// Use ttl if it was specified, otherwise pick something random
+static S32 getSparkTtl(S32 ttl)
 {
-   Spark *s;
-   Spark *s2;
-
-   U32 sparkIndex;
-
-   U8 slotsNeeded = (sparkType == SparkTypePoint ? 1 : 2);             // We need a U2 data type here!
-
-   // Make sure we have room for an additional spark.  Regular sparks need one slot, line sparks need two.
-   if(firstFreeIndex[sparkType] >= MAX_SPARKS - slotsNeeded)           // Spark list is full... need to overwrite an older spark
-   {
-      // Out of room for new sparks.  We'll jump elsewhere in our array and overwrite some older spark.
-      // Overwrite every nth spark to avoid noticable artifacts by grabbing too many sparks from one place.
-      // But make sure we grab a multiple of 2 to avoid wierdness with SparkTypeLine sparks, wich require proper byte alignment.
-      // This doesn't matter for point sparks, but neither does it hurt.
-      sparkIndex = (lastOverwrittenIndex[sparkType] + 100) % (MAX_SPARKS / 2 - 1) * 2;
-      lastOverwrittenIndex[sparkType] = sparkIndex;
-      TNLAssert(sparkIndex < MAX_SPARKS - slotsNeeded, "Spark error!");
-   }
-   else
-   {
-      sparkIndex = firstFreeIndex[sparkType];
-      firstFreeIndex[sparkType] += slotsNeeded;    // Point sparks take 1 slot, line sparks need 2
-   }
-
-   s = mSparks[sparkType] + sparkIndex;            // Assign our spark to its slot
-
-   s->pos = pos;
-   s->vel = vel;
-   s->color = color;
+   return ttl > 0 ? ttl : 15 * TNL::Random::readI(0, 1000);  // 0 - 15 seconds
+}
 
-   // Use ttl if it was specified, otherwise pick something random
-   s->ttl = ttl > 0 ? ttl : 15 * TNL::Random::readI(0, 1000);  // 0 - 15 seconds
 
-   if(sparkType == SparkTypeLine)                  // Line sparks require two points; add the second here
-   {
-      s2 = mSparks[sparkType] + sparkIndex + 1;    // Since we know we had room for two, this one should be available
-      Point len = vel;
-      len.normalize(20);
-      s2->pos = (pos - len);
-      s2->vel = vel;
-      s2->color = Color(color.r * 1, color.g * 0.25, color.b * 0.25);    // Give the trailing edge of this spark a fade effect
-      s2->ttl = s->ttl;
-   }
+// Create a new spark.   ttl = Time To Live (milliseconds)
+void FxManager::emitSpark(const Point &pos, const Point &vel, const Color &color, S32 ttl, UI::SparkType sparkType)
+{
+   SparkStore &sparks = mSparks[sparkType];
+   sparks.setSpark(sparks.getSlot(), pos, vel, color, getSparkTtl(ttl));
 }
 
 
@@ -213,39 +177,8 @@ void FxManager::emitTeleportInEffect(const Point &pos, U32 type)
 
 void FxManager::idle(U32 timeDelta)
 {
-   F32 dTsecs = timeDelta * .001f;
-
-   for(U32 j = 0; j < SparkTypeCount; j++)
-      for(U32 i = 0; i < firstFreeIndex[j]; )
-      {
-         Spark *theSpark = mSparks[j] + i;
-         if(theSpark->ttl < (S32)timeDelta)
-         {                          // Spark is dead -- remove it
-            firstFreeIndex[j]--;
-            *theSpark = mSparks[j][firstFreeIndex[j]];
-         }
-         else
-         {
-            theSpark->ttl -= timeDelta;
-            theSpark->pos += theSpark->vel * dTsecs;
-            if ((SparkType) j == SparkTypePoint)
-            {
-               if(theSpark->ttl > 1000)
-                  theSpark->alpha = 1;
-               else
-                  theSpark->alpha = F32(theSpark->ttl) / 1000.f;
-            }
-            else if ((SparkType) j == SparkTypeLine)
-            {
-               if(theSpark->ttl > 250)
-                  theSpark->alpha = 1;
-               else
-                  theSpark->alpha = F32(theSpark->ttl) / 250.f;
-            }
-
-            i++;
-         }
-      }
+   for(U32 i = 0; i < SparkTypeCount; i++)
+      mSparks[i].idle(timeDelta);
 
 
    // Kill off any old debris chunks, advance the others
@@ -318,13 +251,13 @@ void FxManager::render(S32 renderPass, F32 commanderZoomFraction) const
          glEnableClientState(GL_COLOR_ARRAY);
          glEnableClientState(GL_VERTEX_ARRAY);
 
-         glVertexPointer(2, GL_FLOAT, sizeof(Spark), &mSparks[i][0].pos);     // Where to find the vertices -- see OpenGL docs
-         glColorPointer (4, GL_FLOAT, sizeof(Spark), &mSparks[i][0].color);   // Where to find the colors -- see OpenGL docs
+         glVertexPointer(2, GL_FLOAT, 0, mSparks[i].getPositions());    // Where to find the vertices -- see OpenGL docs
+         glColorPointer (4, GL_FLOAT, 0, mSparks[i].getColors());       // Where to find the colors -- see OpenGL docs
 
          if((SparkType) i == SparkTypePoint)
-            glDrawArrays(GL_POINTS, 0, firstFreeIndex[i]);
+            glDrawArrays(GL_POINTS, 0, mSparks[i].getVertexCount());
          else if((SparkType) i == SparkTypeLine)
-            glDrawArrays(GL_LINES, 0, firstFreeIndex[i]);
+            glDrawArrays(GL_LINES, 0, mSparks[i].getVertexCount());
 
          glDisableClientState(GL_COLOR_ARRAY);
          glDisableClientState(GL_VERTEX_ARRAY);
@@ -343,28 +276,51 @@ void FxManager::render(S32 renderPass, F32 commanderZoomFraction) const
 void FxManager::emitBlast(const Point &pos, U32 size)
 {
    const F32 speed = 800.0f;
+   const S32 sparkCount = 360;
 
-   for(F32 i = 0.0f; i < 360.0f; i += 1)
+   SparkStore &points = mSparks[SparkTypePoint];
+   SparkStore &lines  = mSparks[SparkTypeLine];
+
+   S32 pointsClaimed, linesClaimed;
+   S32 firstPoint = points.claim(sparkCount, pointsClaimed);
+   S32 firstLine  = lines.claim(sparkCount, linesClaimed);
+
+   for(S32 i = 0; i < sparkCount; i++)
    {
-      Point dir = Point(cos(dr(i)), sin(dr(i)));
+      F32 angle = dr(F32(i));
+      Point dir = Point(cos(angle), sin(angle));
+
       // Emit a ring of bright orange sparks, as well as a whole host of yellow ones
-      emitSpark(pos + dir * 50, dir * TNL::Random::readF() * 500, Colors::yellow,    TNL::Random::readI(0, U32(1000.f * F32(1000.f / speed))), SparkTypePoint );
-      emitSpark(pos + dir * 50, dir * speed,                      Color(1, .8, .45), U32(1000.f * F32(size - 50) / speed),                     SparkTypeLine);
+      S32 pointSlot = i < pointsClaimed ? firstPoint + i : points.getOverwriteSlot();
+      S32 lineSlot  = i < linesClaimed  ? firstLine  + i : lines.getOverwriteSlot();
+
+      points.setSpark(pointSlot, pos + dir * 50, dir * TNL::Random::readF() * 500, Colors::yellow,
+                      getSparkTtl(TNL::Random::readI(0, U32(1000.f * F32(1000.f / speed)))));
+      lines.setSpark(lineSlot, pos + dir * 50, dir * speed, Color(1, .8, .45),
+                     getSparkTtl(U32(1000.f * F32(size - 50) / speed)));
    }
 }
 
 
+// Sparks are written straight into the store, a whole explosion's worth at a time
 void FxManager::emitExplosion(const Point &pos, F32 size, const Color *colorArray, U32 numColors)
 {
-   for(U32 i = 0; i < (250.0 * size); i++)
+   SparkStore &sparks = mSparks[SparkTypePoint];
+
+   S32 sparkCount = S32(ceil(250.0 * size));
+   S32 claimed;
+   S32 first = sparks.claim(sparkCount, claimed);
+
+   for(S32 i = 0; i < sparkCount; i++)
    {
       F32 th = TNL::Random::readF() * 2 * 3.14f;
       F32 f = (TNL::Random::readF() * 2 - 1) * 400 * size;
       
       S32 colorIndex = TNL::Random::readI() % numColors;
-      S32 ttl        = S32(F32(TNL::Random::readI(0, 1000) + 2000) * size);
+      S32 ttl        = getSparkTtl(S32(F32(TNL::Random::readI(0, 1000) + 2000) * size));
 
-      emitSpark(pos, Point(cos(th)*f, sin(th)*f), colorArray[colorIndex], ttl);
+      S32 slot = i < claimed ? first + i : sparks.getOverwriteSlot();
+      sparks.setSpark(slot, pos, Point(cos(th)*f, sin(th)*f), colorArray[colorIndex], ttl);
    }
 }
 
@@ -379,7 +335,12 @@ void FxManager::emitBurst(const Point &pos, const Point &scale, const Color &col
 {
    F32 size = 1;
 
-   for(U32 i = 0; i < sparkCount; i++)
+   SparkStore &sparks = mSparks[SparkTypePoint];
+
+   S32 claimed;
+   S32 first = sparks.claim(sparkCount, claimed);
+
+   for(S32 i = 0; i < (S32)sparkCount; i++)
    {
 
       F32 th = TNL::Random::readF() * 2 * FloatPi;                // angle
@@ -388,11 +349,15 @@ void FxManager::emitBurst(const Point &pos, const Point &scale, const Color &col
       Color color;
       color.interp(TNL::Random::readF(), color1, color2);         // Random blend of color1 and color2
 
-      emitSpark(
+      S32 ttl = getSparkTtl(S32(TNL::Random::readI(0, 1000) * scale.len() * 3 + 1000.f * scale.len()));
+
+      S32 slot = i < claimed ? first + i : sparks.getOverwriteSlot();
+
+      sparks.setSpark(slot,
             pos + Point(cos(th)*scale.x, sin(th)*scale.y),        // pos
             Point(cos(th)*scale.x*f, sin(th)*scale.y*f),          // vel
             color,                                                // color
-            S32(TNL::Random::readI(0, 1000) * scale.len() * 3 + 1000.f * scale.len())  // ttl
+            ttl                                                   // ttl
       );
    }
 }
@@ -401,13 +366,14 @@ void FxManager::emitBurst(const Point &pos, const Point &scale, const Color &col
 void FxManager::clearSparks()
 {
    // Remove all sparks
-   for(U32 j = 0; j < SparkTypeCount; j++)
-      for(U32 i = 0; i < firstFreeIndex[j]; )
-      {
-         Spark *theSpark = mSparks[j] + i;
-         firstFreeIndex[j]--;
-         *theSpark = mSparks[j][firstFreeIndex[j]];
-      }
+   for(U32 i = 0; i < SparkTypeCount; i++)
+      mSparks[i].clear();
+}
+
+
+S32 FxManager::getSparkCount(SparkType sparkType) const
+{
+   return mSparks[sparkType].getSparkCount();
 }
 
 
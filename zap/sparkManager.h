@@ -9,6 +9,7 @@
 #include "Point.h"
 #include "Color.h"
 #include "SparkTypesEnum.h"
+#include "SparkStore.h"
 
 #include "tnlVector.h"
 
@@ -17,15 +18,6 @@ namespace Zap { namespace UI
 
 class FxManager
 {
-   struct Spark
-   {
-      Point pos;
-      Color color;
-      F32 alpha;
-      S32 ttl;     // Milliseconds
-      Point vel;
-   };
-
    struct DebrisChunk
    {
       Vector<Point> points;
@@ -62,12 +54,7 @@ class FxManager
    struct TeleporterEffect;
    TeleporterEffect *teleporterEffects;
 
-   static const U32 MAX_SPARKS = 8192;    // Make this an even number
-
-   U32 firstFreeIndex[SparkTypeCount];            // Tracks next available slot when we have fewer than MAX_SPARKS 
-   U32 lastOverwrittenIndex[SparkTypeCount];      // Keep track of which spark we last overwrote
-
-   Spark mSparks[SparkTypeCount][MAX_SPARKS];     // Our sparks themselves... two types, each with room for MAX_SPARKS
+   SparkStore mSparks[SparkTypeCount];            // Our sparks themselves... one store for each type
 
 public:
    FxManager();
@@ -84,6 +71,8 @@ public:
    void idle(U32 timeDelta);
    void render(S32 renderPass, F32 commanderZoomFraction) const;
    void clearSparks();
+
+   S32 getSparkCount(SparkType sparkType) const;
 };
 
 class FxTrail